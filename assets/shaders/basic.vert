@@ -8,27 +8,42 @@ layout (location = 4) in vec3 bitangent;
 layout (location = 5) in int boneIDs;
 layout (location = 6) in float boneWeights;
 layout (location = 7) in vec4 color;
+layout (location = 8) in mat4 instanceModel; // 8 to 11
 
 layout (location = 0) out vec3 surfaceNormal;
 layout (location = 1) out vec2 vTextureCoords;
 layout (location = 2) out vec4 vColor;
-layout (location = 3) out vec3 directionToLight;
 layout (location = 4) out vec3 directionToCamera;
 layout (location = 5) out float fogVisibility;
 layout (location = 6) out vec4 worldPosition;
 layout (location = 7) out vec3 worldNormal;
 
-uniform mat4 projection;
-uniform mat4 view;
+struct Light {
+    vec4 position; // w unused
+    vec4 color; // w unused
+};
+
+// written once per frame by RenderManager::beginScene, see FrameData
+layout (std140, binding = 0) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec3 cameraPosition;
+    float useFog;
+    vec3 fogColor;
+    float fogDensity;
+    float fogGradient;
+    int lightCount;
+    Light lights[8]; // without range
+    uvec4 clusterGrid; // x, y, z, w unused. z is 0 without clusters
+    float clusterScale;
+    float clusterBias;
+};
+
 uniform mat4 model;
-uniform vec3 lightPosition;
-uniform float useFog;
-uniform float fogDensity;
-uniform float fogGradient;
-
-void calculateReflection() {
-    surfaceNormal = (model * vec4(normal, 0.f)).xyz;
-    directionToLight = lightPosition - worldPosition.xyz;
+uniform float useInstancing;
+
+void calculateReflection(mat4 world) {
+    surfaceNormal = (world * vec4(normal, 0.f)).xyz;
     directionToCamera = (inverse(view) * vec4(0.f, 0.f, 0.f, 1.f)).xyz - worldPosition.xyz;
 }
 
@@ -43,14 +58,15 @@ void calculateFogVisibility(vec4 viewPosition) {
 }
 
 void main() {
-    worldPosition = model * vec4(position, 1.f);
-    worldNormal = mat3(transpose(inverse(model))) * normal;
+    mat4 world = int(useInstancing) == 0 ? model : instanceModel;
+    worldPosition = world * vec4(position, 1.f);
+    worldNormal = mat3(transpose(inverse(world))) * normal;
     vec4 viewPosition = view * worldPosition;
     vec4 clipPosition = projection * viewPosition;
     gl_Position = clipPosition;
     vTextureCoords = textureCoords;
     vColor = color;
 
-    calculateReflection();
+    calculateReflection(world);
     calculateFogVisibility(viewPosition);
 }
\ No newline at end of file
@@ -5,8 +5,27 @@ layout (location = 1) in vec2 textureCoords;
 
 layout (location = 0) out vec2 vTextureCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+struct Light {
+    vec4 position; // w unused
+    vec4 color; // w unused
+};
+
+// written once per frame by RenderManager::beginScene, see FrameData
+layout (std140, binding = 0) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec3 cameraPosition;
+    float useFog;
+    vec3 fogColor;
+    float fogDensity;
+    float fogGradient;
+    int lightCount;
+    Light lights[8]; // without range
+    uvec4 clusterGrid; // x, y, z, w unused. z is 0 without clusters
+    float clusterScale;
+    float clusterBias;
+};
+
 uniform mat4 model;
 
 void main()
@@ -5,11 +5,31 @@ layout (location = 1) in float fogVisibility;
 
 layout (location = 0) out vec4 fragColor;
 
+struct Light {
+    vec4 position; // w unused
+    vec4 color; // w unused
+};
+
+// written once per frame by RenderManager::beginScene, see FrameData
+layout (std140, binding = 0) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec3 cameraPosition;
+    float useFog;
+    vec3 fogColor;
+    float fogDensity;
+    float fogGradient;
+    int lightCount;
+    Light lights[8]; // without range
+    uvec4 clusterGrid; // x, y, z, w unused. z is 0 without clusters
+    float clusterScale;
+    float clusterBias;
+};
+
 uniform sampler2D textureDiffuse1;
 uniform float useTextureAtlas;
 uniform float numRows;
 uniform vec2 offset;
-uniform vec3 fogColor;
 uniform float useColor;
 uniform vec4 color;
 
@@ -2,16 +2,34 @@
 
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 textureCoords;
+layout (location = 8) in mat4 instanceModel; // 8 to 11
 
 layout (location = 0) out vec2 vTextureCoords;
 layout (location = 1) out float fogVisibility;
 
-uniform mat4 projection;
-uniform mat4 view;
+struct Light {
+    vec4 position; // w unused
+    vec4 color; // w unused
+};
+
+// written once per frame by RenderManager::beginScene, see FrameData
+layout (std140, binding = 0) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec3 cameraPosition;
+    float useFog;
+    vec3 fogColor;
+    float fogDensity;
+    float fogGradient;
+    int lightCount;
+    Light lights[8]; // without range
+    uvec4 clusterGrid; // x, y, z, w unused. z is 0 without clusters
+    float clusterScale;
+    float clusterBias;
+};
+
 uniform mat4 model;
-uniform float useFog;
-uniform float fogDensity;
-uniform float fogGradient;
+uniform float useInstancing;
 
 void calculateFogVisibility(vec4 viewPosition) {
     if (int(useFog) == 0) {
@@ -24,7 +42,8 @@ void calculateFogVisibility(vec4 viewPosition) {
 }
 
 void main() {
-    vec4 worldPosition = model * vec4(position.x, position.y, position.z, 1.f);
+    mat4 world = int(useInstancing) == 0 ? model : instanceModel;
+    vec4 worldPosition = world * vec4(position.x, position.y, position.z, 1.f);
     vec4 viewPosition = view * worldPosition;
     vec4 clipPosition = projection * viewPosition;
     gl_Position = clipPosition;
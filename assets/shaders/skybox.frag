@@ -4,12 +4,31 @@ layout (location = 0) in vec3 vTextureCoords;
 
 layout (location = 0) out vec4 fragColor;
 
+struct Light {
+    vec4 position; // w unused
+    vec4 color; // w unused
+};
+
+// written once per frame by RenderManager::beginScene, see FrameData
+layout (std140, binding = 0) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec3 cameraPosition;
+    float useFog;
+    vec3 fogColor;
+    float fogDensity;
+    float fogGradient;
+    int lightCount;
+    Light lights[8]; // without range
+    uvec4 clusterGrid; // x, y, z, w unused. z is 0 without clusters
+    float clusterScale;
+    float clusterBias;
+};
+
 uniform samplerCube textureDiffuse1;
 uniform samplerCube textureDiffuse2;
 uniform float useBlending;
 uniform float blendFactor;
-uniform float useFog;
-uniform vec3 fogColor;
 
 const float LOWER_LIMIT = 0.f; // center of the screen
 const float UPPER_LIMIT = 30.f; // slightly above the horizon
@@ -3,7 +3,6 @@
 layout (location = 0) in vec3 surfaceNormal;
 layout (location = 1) in vec2 vTextureCoords;
 layout (location = 2) in vec3 vColor;
-layout (location = 3) in vec3 directionToLight;
 layout (location = 4) in vec3 directionToCamera;
 layout (location = 5) in float fogVisibility;
 layout (location = 6) in vec4 worldPosition;
@@ -11,12 +10,48 @@ layout (location = 7) in vec3 worldNormal;
 
 layout (location = 0) out vec4 fragColor;
 
+struct Light {
+    vec4 position; // w unused
+    vec4 color; // w unused
+};
+
+// written once per frame by RenderManager::beginScene, see FrameData
+layout (std140, binding = 0) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec3 cameraPosition;
+    float useFog;
+    vec3 fogColor;
+    float fogDensity;
+    float fogGradient;
+    int lightCount;
+    Light lights[8]; // without range
+    uvec4 clusterGrid; // x, y, z, w unused. z is 0 without clusters
+    float clusterScale;
+    float clusterBias;
+};
+
+struct ClusterLight {
+    vec4 positionRange;
+    vec4 color; // w unused
+};
+
+// written once per frame by LightClusters::build
+layout (std430, binding = 1) readonly buffer ClusterLights {
+    ClusterLight clusterLights[];
+};
+layout (std430, binding = 2) readonly buffer Clusters {
+    uvec2 clusters[]; // offset in clusterLightIndices and count
+};
+layout (std430, binding = 3) readonly buffer ClusterLightIndices {
+    uint clusterLightIndices[];
+};
+
 uniform sampler2D textureDiffuse1;
 uniform float useColor;
 uniform float useLighting;
 uniform float numRows;
 uniform vec2 offset;
-uniform vec3 fogColor;
 uniform float useNormal;
 uniform float useReflection;
 uniform float useSkyBlending;
@@ -24,10 +59,8 @@ uniform float skyBlendFactor;
 uniform samplerCube textureDiffuseSky10;
 uniform samplerCube textureDiffuseSky11;
 uniform float reflectivity;
-uniform vec3 cameraPosition;
 uniform float useRefraction;
 uniform float refractiveIndex;
-uniform vec3 lightColor;
 uniform vec3 ambient;
 uniform vec3 diffuse;
 uniform vec3 specular;
@@ -76,22 +109,43 @@ void calculateRefraction() {
     }
 }
 
+float calculateDiffuse(vec3 normal, vec3 directionToLight) {
+    return max(dot(normal, normalize(directionToLight)), 0.f);
+}
+
+// index of the cluster of the fragment in the grid of LightClusters
+uint getCluster() {
+    vec4 viewPosition = view * worldPosition;
+    vec4 clipPosition = projection * viewPosition;
+    uvec2 tile = uvec2(clamp((clipPosition.xy / clipPosition.w * 0.5f + 0.5f) * vec2(clusterGrid.xy), vec2(0.f), vec2(clusterGrid.xy - 1u)));
+    uint slice = uint(clamp(log(-viewPosition.z) * clusterScale - clusterBias, 0.f, float(clusterGrid.z - 1u)));
+    return tile.x + clusterGrid.x * (tile.y + clusterGrid.y * slice);
+}
+
 void calculateLighting() {
     if (int(useLighting) == 1) {
-        // ambient
-        vec3 ambient_ = lightColor * ambient;
+        vec3 normal = normalize(surfaceNormal);
+        vec3 ambient_ = vec3(0.f);
+        vec3 diffuse_ = vec3(0.f);
 
-        // diffuse
-        float diff = max(dot(normalize(surfaceNormal), normalize(directionToLight)), 0.f);
-        vec3 diffuse_ = lightColor * (diff * diffuse);
+        for (int i = 0; i < lightCount; ++i) {
+            vec3 directionToLight = lights[i].position.xyz - worldPosition.xyz;
+            ambient_ += lights[i].color.rgb * ambient;
+            diffuse_ += lights[i].color.rgb * (calculateDiffuse(normal, directionToLight) * diffuse);
+        }
 
-        // specular
-        vec3 viewDirection = normalize(cameraPosition - worldPosition.rgb);
-        vec3 reflectDirection = reflect(-directionToLight, worldNormal);
-        float spec = pow(max(dot(viewDirection, reflectDirection), 0.f), shininess);
-        vec3 specular_ = lightColor * (spec * specular);
+        // lights with range fade out smoothly until it and add no ambient
+        if (clusterGrid.z > 0u) {
+            uvec2 cluster = clusters[getCluster()];
+            for (uint i = 0u; i < cluster.y; ++i) {
+                ClusterLight light = clusterLights[clusterLightIndices[cluster.x + i]];
+                vec3 directionToLight = light.positionRange.xyz - worldPosition.xyz;
+                float falloff = clamp(1.f - pow(length(directionToLight) / light.positionRange.w, 2.f), 0.f, 1.f);
+                diffuse_ += light.color.rgb * (calculateDiffuse(normal, directionToLight) * falloff * falloff * diffuse);
+            }
+        }
 
-        vec3 result = ambient_ + diffuse_; //+ specular;
+        vec3 result = ambient_ + diffuse_;
         fragColor = vec4(fragColor.rgb * result, fragColor.a);
     }
 }
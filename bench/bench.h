@@ -0,0 +1,44 @@
+#pragma once
+
+#include "pch.h"
+#include "utils/timer.h"
+
+namespace bench {
+
+// a named set of measurements, each translation unit registers its own with
+// a static Register and the command line picks them by name
+struct Benchmark {
+    std::string_view name;
+    std::function<void()> run;
+};
+
+std::vector<Benchmark>& GetBenchmarks();
+
+struct Register {
+    Register(std::string_view name, std::function<void()> run) {
+      GetBenchmarks().push_back({name, std::move(run)});
+    }
+};
+
+// milliseconds of the fastest of runs calls to f, after one warm up call
+template <typename F> double Measure(F&& f, uint32_t runs = 5) {
+  f();
+  double best = std::numeric_limits<double>::max();
+  for (uint32_t i = 0; i < runs; ++i) {
+    potatoengine::Timer timer;
+    f();
+    best = std::min<double>(best, timer.getMilliseconds());
+  }
+  return best;
+}
+
+// keeps the compiler from dropping work whose result is never read
+template <typename T> void Keep(const T& value) {
+  static const void* volatile sink;
+  sink = &value;
+}
+
+// one line per measurement, the detail holds the derived numbers
+void Report(std::string_view label, double ms, std::string_view detail = {});
+
+}
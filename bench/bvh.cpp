@@ -0,0 +1,101 @@
+#include "bench.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "engineAPI.h"
+
+namespace {
+
+constexpr uint32_t Boxes = 100'000;
+constexpr uint32_t Queries = 1'000;
+constexpr float WorldSize = 1000.f;
+
+engine::AABB createBox(std::mt19937& random, float maxSize) {
+  std::uniform_real_distribution<float> position(0.f, WorldSize);
+  std::uniform_real_distribution<float> size(1.f, maxSize);
+  glm::vec3 min{position(random), position(random), position(random)};
+  return {min, min + glm::vec3(size(random), size(random), size(random))};
+}
+
+const bench::Register bvh("bvh", []() {
+  std::mt19937 random(1337);
+  std::vector<engine::AABB> boxes;
+  boxes.reserve(Boxes);
+  for (uint32_t i = 0; i < Boxes; ++i) {
+    boxes.push_back(createBox(random, 4.f));
+  }
+  std::vector<engine::AABB> queries;
+  for (uint32_t i = 0; i < Queries; ++i) {
+    queries.push_back(createBox(random, 40.f));
+  }
+
+  engine::BVH tree;
+  double buildMs = bench::Measure([&]() { tree.build(std::vector(boxes)); });
+  bench::Report(std::format("build {} boxes", Boxes), buildMs,
+                std::format("{} nodes", tree.getNodeCount()));
+
+  // a few moving entities, what the transforms change in a frame
+  for (uint32_t moved : {100u, 10'000u}) {
+    double refitMs = bench::Measure([&]() {
+      for (uint32_t i = 0; i < moved; ++i) {
+        uint32_t item = (i * 7919) % Boxes;
+        engine::AABB box = tree.getBox(item);
+        tree.update(item, {box.min + 0.5f, box.max + 0.5f});
+      }
+      tree.refit();
+    });
+    bench::Report(std::format("refit {} moved boxes", moved), refitMs);
+  }
+
+  size_t linearHits = 0;
+  double linearMs = bench::Measure([&]() {
+    linearHits = 0;
+    for (const engine::AABB& query : queries) {
+      for (uint32_t i = 0; i < tree.size(); ++i) {
+        linearHits += query.intersects(tree.getBox(i)) ? 1 : 0;
+      }
+    }
+  });
+  size_t treeHits = 0;
+  double treeMs = bench::Measure([&]() {
+    treeHits = 0;
+    for (const engine::AABB& query : queries) {
+      tree.query(
+        [&](const engine::AABB& box) { return query.intersects(box); },
+        [&](uint32_t) { ++treeHits; });
+    }
+  });
+  bench::Report(std::format("box queries linear x{}", Queries), linearMs,
+                std::format("{:.0f} queries/s, {} hits",
+                            Queries * 1000. / linearMs, linearHits));
+  bench::Report(std::format("box queries bvh x{}", Queries), treeMs,
+                std::format("{:.0f} queries/s, {} hits, {:.1f}x",
+                            Queries * 1000. / treeMs, treeHits,
+                            linearMs / treeMs));
+
+  // a camera in a corner of the world looking at its center
+  glm::mat4 projection =
+    glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, WorldSize / 2.f);
+  glm::mat4 view = glm::lookAt(glm::vec3(0.f), glm::vec3(WorldSize / 2.f),
+                               glm::vec3(0.f, 1.f, 0.f));
+  engine::Frustum frustum(projection * view);
+  size_t visible = 0;
+  linearMs = bench::Measure([&]() {
+    visible = 0;
+    for (uint32_t i = 0; i < tree.size(); ++i) {
+      visible += frustum.isVisible(tree.getBox(i)) ? 1 : 0;
+    }
+  });
+  treeMs = bench::Measure([&]() {
+    visible = 0;
+    tree.query([&](const engine::AABB& box) { return frustum.isVisible(box); },
+               [&](uint32_t) { ++visible; });
+  });
+  bench::Report("frustum linear", linearMs,
+                std::format("{} visible", visible));
+  bench::Report("frustum bvh", treeMs,
+                std::format("{} visible, {:.1f}x", visible,
+                            linearMs / treeMs));
+});
+
+}
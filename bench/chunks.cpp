@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include "engineAPI.h"
+#include "systems/terrain/sTerrain.h"
+
+using namespace demos::systems;
+
+namespace {
+
+ChunkSettings createSettings(uint32_t chunkSize,
+                             engine::CChunkManager::MeshType meshType,
+                             engine::CChunkManager::MeshAlgorithm algorithm) {
+  ChunkSettings settings{chunkSize, 1, meshType, algorithm, true,
+                         engine::CTexture::DrawMode::COLOR};
+  settings.noise =
+    engine::CNoise("simplex", 1337, 4, 0.02f, 0.5f, 2.f, 16, false);
+  settings.noise.setNoiseType();
+  settings.noise.setSeed();
+  settings.noise.setOctaves();
+  settings.noise.setFrequency();
+  settings.noise.setPersistence();
+  settings.noise.setLacunarity();
+  return settings;
+}
+
+std::vector<glm::ivec3> getGrid(int width, int height) {
+  std::vector<glm::ivec3> grid;
+  for (int row = -width; row <= width; ++row) {
+    for (int col = -height; col <= height; ++col) {
+      grid.emplace_back(col, 0, row);
+    }
+  }
+  return grid;
+}
+
+// TerrainSystem::init loads a fixed grid the same way, one job per chunk
+double generate(const ChunkSettings& settings,
+                const std::vector<glm::ivec3>& grid,
+                engine::ThreadPool* threadPool) {
+  return bench::Measure([&]() {
+    if (not threadPool) {
+      for (glm::ivec3 coords : grid) {
+        bench::Keep(generateChunk(settings, coords));
+      }
+      return;
+    }
+    std::vector<std::future<ChunkMeshData>> jobs;
+    jobs.reserve(grid.size());
+    for (glm::ivec3 coords : grid) {
+      jobs.emplace_back(threadPool->submit(
+        [&settings, coords]() { return generateChunk(settings, coords); }));
+    }
+    for (auto& job : jobs) {
+      bench::Keep(job.get());
+    }
+  }, 3);
+}
+
+const bench::Register chunks("chunks", []() {
+  auto threadPool = engine::ThreadPool::Create();
+  struct Mesh {
+      std::string_view name;
+      engine::CChunkManager::MeshType type;
+      engine::CChunkManager::MeshAlgorithm algorithm;
+  };
+  for (Mesh mesh : {Mesh{"plane", engine::CChunkManager::MeshType::Plane,
+                         engine::CChunkManager::MeshAlgorithm::Quad},
+                    Mesh{"voxel", engine::CChunkManager::MeshType::Chunk,
+                         engine::CChunkManager::MeshAlgorithm::Greedy}}) {
+    for (uint32_t chunkSize : {16u, 32u}) {
+      for (int radius : {2, 4}) {
+        ChunkSettings settings =
+          createSettings(chunkSize, mesh.type, mesh.algorithm);
+        std::vector<glm::ivec3> grid = getGrid(radius, radius);
+        // one thread is the serial loop init ran before the pool
+        for (uint32_t threads : {1u, threadPool->getThreadCount()}) {
+          double ms = generate(settings, grid,
+                               threads == 1 ? nullptr : threadPool.get());
+          bench::Report(
+            std::format("{} size {} grid {}x{} threads {}", mesh.name,
+                        chunkSize, 2 * radius + 1, 2 * radius + 1, threads),
+            ms, std::format("{:.1f} chunks/s", grid.size() * 1000. / ms));
+        }
+      }
+    }
+  }
+});
+
+}
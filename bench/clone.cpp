@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include "engineAPI.h"
+#include "utils/uuid.h"
+
+using namespace entt::literals;
+
+namespace {
+
+constexpr uint32_t Clones = 10'000;
+
+// cloneEntity before the clone plans: every storage of the registry is
+// probed and each component found gets a meta copy and a hook lookup
+entt::entity cloneByWalking(entt::registry& registry, entt::entity e) {
+  entt::entity cloned = registry.create();
+  for (auto&& [id, storage] : registry.storage()) {
+    if (storage.contains(e)) {
+      storage.push(cloned, storage.value(e));
+      entt::meta_type cType = entt::resolve(storage.type());
+      entt::meta_any cData = cType.construct(storage.value(e));
+      if (entt::meta_func onCloned = cType.func("onComponentCloned"_hs)) {
+        onCloned.invoke({}, e, cData);
+      }
+    }
+  }
+  registry.emplace<engine::CUUID>(cloned, engine::UUID());
+  return cloned;
+}
+
+// best of a few runs, the clones are destroyed outside of the timing
+template <typename F> double measureClones(entt::registry& registry, F&& f) {
+  double best = std::numeric_limits<double>::max();
+  for (uint32_t run = 0; run < 5; ++run) {
+    std::vector<entt::entity> clones;
+    clones.reserve(Clones);
+    engine::Timer timer;
+    f(clones);
+    best = std::min<double>(best, timer.getMilliseconds());
+    registry.destroy(clones.begin(), clones.end());
+  }
+  return best;
+}
+
+// a SceneManager registers the component meta and the groups like the app,
+// the prototype is registered in a factory of its own since there are no
+// prefab assets to build it from
+const bench::Register clone("clone", []() {
+  engine::SceneManager sceneManager;
+  entt::registry& registry = sceneManager.getRegistry();
+  engine::SceneFactory sceneFactory;
+  entt::entity prototype = registry.create();
+  registry.emplace<engine::CTransform>(prototype);
+  registry.emplace<engine::CShaderProgram>(prototype);
+  registry.emplace<engine::CTexture>(prototype);
+  registry.emplace<engine::CTextureAtlas>(prototype);
+  registry.emplace<engine::CShape>(prototype);
+  registry.emplace<engine::CRigidBody>(prototype);
+  registry.emplace<engine::CCollider>(prototype);
+  registry.emplace<engine::CMaterial>(prototype);
+  sceneFactory.getEntityFactory().addPrototype("bench", "prototype", prototype);
+
+  double walkMs = measureClones(registry, [&](auto& clones) {
+    for (uint32_t i = 0; i < Clones; ++i) {
+      clones.push_back(cloneByWalking(registry, prototype));
+    }
+  });
+  double planMs = measureClones(registry, [&](auto& clones) {
+    for (uint32_t i = 0; i < Clones; ++i) {
+      clones.push_back(
+        sceneFactory.cloneEntity(prototype, engine::UUID(), registry));
+    }
+  });
+  double batchMs = measureClones(registry, [&](auto& clones) {
+    clones = sceneFactory.cloneEntities(prototype, Clones, registry);
+  });
+
+  size_t storages = 0;
+  for (auto&& storage : registry.storage()) {
+    ++storages;
+  }
+  bench::Report(std::format("walking the storages x{}", Clones), walkMs,
+                std::format("{} storages", storages));
+  bench::Report(std::format("clone plan x{}", Clones), planMs,
+                std::format("{:.1f}x", walkMs / planMs));
+  bench::Report(std::format("batch clone x{}", Clones), batchMs,
+                std::format("{:.1f}x", walkMs / batchMs));
+});
+
+}
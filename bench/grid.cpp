@@ -0,0 +1,118 @@
+#include "bench.h"
+
+#include "engineAPI.h"
+
+namespace {
+
+// cheap stand-in for the noise so the storage dominates the timings
+float getHeight(size_t row, size_t col) {
+  return static_cast<float>((row * 7 + col * 13) % 31) * 0.25f;
+}
+
+glm::vec3 getColor(float height) {
+  return height > 4.f ? glm::vec3(1.f) : glm::vec3(0.f, height * 0.2f, 0.f);
+}
+
+// the terrain generators before the flat grid: one allocation per row, and
+// the biomes took the heights by value
+using Rows = std::vector<std::vector<float>>;
+
+Rows generateRows(uint32_t size) {
+  Rows heights(size, std::vector<float>(size));
+  for (size_t row = 0; row < size; ++row) {
+    for (size_t col = 0; col < size; ++col) {
+      heights[row][col] = getHeight(row, col);
+    }
+  }
+  return heights;
+}
+
+std::vector<std::vector<glm::vec3>> generateRowBiomes(Rows heights) {
+  std::vector<std::vector<glm::vec3>> biomes(
+    heights.size(), std::vector<glm::vec3>(heights.size()));
+  for (size_t row = 0; row < heights.size(); ++row) {
+    for (size_t col = 0; col < heights.size(); ++col) {
+      biomes[row][col] = getColor(heights[row][col]);
+    }
+  }
+  return biomes;
+}
+
+glm::vec3 getRowsNormal(size_t col, size_t row, const Rows& heights) {
+  size_t last = heights.size() - 1;
+  float left = heights[row][col > 0 ? col - 1 : col];
+  float right = heights[row][col < last ? col + 1 : col];
+  float down = heights[row > 0 ? row - 1 : row][col];
+  float up = heights[row < last ? row + 1 : row][col];
+  return glm::normalize(glm::vec3(left - right, 2.f, down - up));
+}
+
+engine::Grid<float> generateGrid(uint32_t size) {
+  engine::Grid<float> heights(size, size);
+  for (size_t row = 0; row < size; ++row) {
+    for (size_t col = 0; col < size; ++col) {
+      heights(row, col) = getHeight(row, col);
+    }
+  }
+  return heights;
+}
+
+engine::Grid<glm::vec3> generateGridBiomes(const engine::Grid<float>& heights) {
+  engine::Grid<glm::vec3> biomes(heights.getRows(), heights.getCols());
+  for (size_t i = 0; i < heights.size(); ++i) {
+    biomes.data()[i] = getColor(heights.data()[i]);
+  }
+  return biomes;
+}
+
+glm::vec3 getGridNormal(size_t col, size_t row,
+                        const engine::Grid<float>& heights) {
+  size_t last = heights.getRows() - 1;
+  float left = heights(row, col > 0 ? col - 1 : col);
+  float right = heights(row, col < last ? col + 1 : col);
+  float down = heights(row > 0 ? row - 1 : row, col);
+  float up = heights(row < last ? row + 1 : row, col);
+  return glm::normalize(glm::vec3(left - right, 2.f, down - up));
+}
+
+// heights, biomes and normals of chunks chunks, like generateChunk does
+const bench::Register grid("grid", []() {
+  constexpr uint32_t chunks = 256;
+  for (uint32_t chunkSize : {16u, 32u, 64u}) {
+    uint32_t size = chunkSize + 1;
+    double rowsMs = bench::Measure([&]() {
+      for (uint32_t chunk = 0; chunk < chunks; ++chunk) {
+        Rows heights = generateRows(size);
+        auto biomes = generateRowBiomes(heights);
+        glm::vec3 normals{};
+        for (size_t row = 0; row < size; ++row) {
+          for (size_t col = 0; col < size; ++col) {
+            normals += getRowsNormal(col, row, heights) + biomes[row][col];
+          }
+        }
+        bench::Keep(normals);
+      }
+    });
+    double gridMs = bench::Measure([&]() {
+      for (uint32_t chunk = 0; chunk < chunks; ++chunk) {
+        engine::Grid<float> heights = generateGrid(size);
+        engine::Grid<glm::vec3> biomes = generateGridBiomes(heights);
+        glm::vec3 normals{};
+        for (size_t row = 0; row < size; ++row) {
+          for (size_t col = 0; col < size; ++col) {
+            normals += getGridNormal(col, row, heights) + biomes(row, col);
+          }
+        }
+        bench::Keep(normals);
+      }
+    });
+    bench::Report(
+      std::format("vector<vector> size {} x{}", chunkSize, chunks), rowsMs,
+      std::format("{} allocations per chunk", 3 * size + 3));
+    bench::Report(std::format("Grid size {} x{}", chunkSize, chunks), gridMs,
+                  std::format("2 allocations per chunk, {:.2f}x",
+                              rowsMs / gridMs));
+  }
+});
+
+}
@@ -0,0 +1,31 @@
+#include "bench.h"
+
+namespace bench {
+
+std::vector<Benchmark>& GetBenchmarks() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+void Report(std::string_view label, double ms, std::string_view detail) {
+  std::cout << std::format("  {:<44} {:>10.3f} ms  {}\n", label, ms, detail);
+}
+
+}
+
+// runs every benchmark, or only those whose name contains the first argument
+int main(int argc, char** argv) {
+  potatoengine::LogManager::Init();
+  potatoengine::LogManager::SetEngineLoggerLevel(spdlog::level::warn);
+  potatoengine::LogManager::SetAppLoggerLevel(spdlog::level::warn);
+
+  std::string_view filter = argc > 1 ? argv[1] : "";
+  for (const bench::Benchmark& benchmark : bench::GetBenchmarks()) {
+    if (not benchmark.name.contains(filter)) {
+      continue;
+    }
+    std::cout << std::format("{}\n", benchmark.name);
+    benchmark.run();
+  }
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include "bench.h"
+
+#include "engineAPI.h"
+#include "systems/terrain/sTerrain.h"
+
+using namespace demos::systems;
+
+namespace {
+
+// volumes are generated once, only the meshing is timed
+const bench::Register meshing("meshing", []() {
+  for (uint32_t chunkSize : {16u, 32u}) {
+    ChunkSettings settings{chunkSize, 1,
+                           engine::CChunkManager::MeshType::Chunk,
+                           engine::CChunkManager::MeshAlgorithm::Greedy, true,
+                           engine::CTexture::DrawMode::COLOR};
+    settings.noise =
+      engine::CNoise("simplex", 1337, 1, 0.02f, 0.5f, 2.f, 16, false);
+    settings.noise.setNoiseType();
+    settings.noise.setSeed();
+    settings.noise.setFrequency();
+
+    std::vector<VoxelVolume> volumes;
+    for (int row = -2; row <= 2; ++row) {
+      for (int col = -2; col <= 2; ++col) {
+        volumes.emplace_back(generateVoxels(settings, {col, 0, row}));
+      }
+    }
+
+    for (bool merge : {false, true}) {
+      size_t triangles = 0;
+      double ms = bench::Measure([&]() {
+        triangles = 0;
+        for (const VoxelVolume& volume : volumes) {
+          ChunkMeshData data =
+            generateChunkMesh(volume, settings.blockSize, settings.drawMode,
+                              settings.textureAtlas, merge);
+          triangles += data.indices.size() / 3;
+          bench::Keep(data);
+        }
+      });
+      bench::Report(std::format("{} size {} x{}",
+                                merge ? "greedy" : "per face", chunkSize,
+                                volumes.size()),
+                    ms, std::format("{} triangles", triangles));
+    }
+  }
+});
+
+}
@@ -0,0 +1,64 @@
+#include "bench.h"
+
+#include "engineAPI.h"
+#include "utils/simdNoise.h"
+
+namespace {
+
+engine::CNoise createNoise(std::string type) {
+  engine::CNoise noise(std::move(type), 1337, 1, 0.01f, 0.5f, 2.f, 1, false);
+  noise.setNoiseType();
+  noise.setSeed();
+  noise.setOctaves();
+  noise.setFrequency();
+  noise.setPersistence();
+  noise.setLacunarity();
+  return noise;
+}
+
+// one FastNoiseLite call per sample, how generateHeights sampled before the
+// batched getNoise
+void fillScalar(const engine::CNoise& noise, engine::Grid<float>& out) {
+  for (size_t row = 0; row < out.getRows(); ++row) {
+    for (size_t col = 0; col < out.getCols(); ++col) {
+      out(row, col) = noise.getNoise(static_cast<float>(col),
+                                     static_cast<float>(row));
+    }
+  }
+}
+
+const bench::Register noise("noise", []() {
+  constexpr uint32_t size = 512;
+  std::cout << std::format(
+    "  kernels: {}\n",
+    engine::simd::GetLevelName(engine::simd::GetLevel()));
+  for (std::string type :
+       {"simplex", "perlin", "value", "valueCubic", "cellular"}) {
+    engine::CNoise noise = createNoise(type);
+    engine::Grid<float> scalar(size, size);
+    engine::Grid<float> batched(size, size);
+    double scalarMs = bench::Measure([&]() {
+      fillScalar(noise, scalar);
+      bench::Keep(scalar);
+    });
+    double batchedMs = bench::Measure([&]() {
+      noise.getNoise(batched, 0, 0);
+      bench::Keep(batched);
+    });
+
+    float maxError = 0.f;
+    for (size_t i = 0; i < scalar.size(); ++i) {
+      maxError =
+        std::max(maxError, std::abs(scalar.data()[i] - batched.data()[i]));
+    }
+    double samples = static_cast<double>(size) * size;
+    bench::Report(std::format("{} scalar", type), scalarMs,
+                  std::format("{:.1f} Msamples/s", samples / scalarMs / 1e3));
+    bench::Report(std::format("{} batched", type), batchedMs,
+                  std::format("{:.1f} Msamples/s, {:.2f}x, max error {}",
+                              samples / batchedMs / 1e3,
+                              scalarMs / batchedMs, maxError));
+  }
+});
+
+}
@@ -0,0 +1,36 @@
+#include "bench.h"
+
+#include "engineAPI.h"
+
+namespace {
+
+constexpr uint32_t Entities = 1'000'000;
+
+// about what MovementSystem does to a transform each frame
+void moveTransform(engine::CTransform& cTransform) {
+  cTransform.rotate(0.1f, glm::vec3(0.f, 1.f, 0.f));
+  cTransform.position += glm::vec3(cTransform.calculate()[2]) * 0.01f;
+}
+
+const bench::Register parallelEach("parallelEach", []() {
+  entt::registry registry;
+  for (uint32_t i = 0; i < Entities; ++i) {
+    registry.emplace<engine::CTransform>(registry.create());
+  }
+  auto view = registry.view<engine::CTransform>();
+
+  double serialMs = bench::Measure([&]() { view.each(moveTransform); });
+  bench::Report(std::format("each {} transforms", Entities), serialMs);
+
+  uint32_t cores = std::thread::hardware_concurrency();
+  for (uint32_t threads = 2; threads <= std::min(cores, 8u); threads *= 2) {
+    // the caller works on the chunks too
+    auto threadPool = engine::ThreadPool::Create(threads - 1);
+    double ms = bench::Measure(
+      [&]() { engine::ParallelEach(*threadPool, view, moveTransform); });
+    bench::Report(std::format("ParallelEach {} threads", threads), ms,
+                  std::format("{:.2f}x", serialMs / ms));
+  }
+});
+
+}
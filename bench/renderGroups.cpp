@@ -0,0 +1,112 @@
+#include "bench.h"
+
+#include "engineAPI.h"
+#include "systems/graphics/sRender.h"
+
+namespace {
+
+constexpr uint32_t Entities = 50'000;
+
+// stands for the draw call, the same work for both loops
+void draw(const engine::CTransform& cTransform,
+          const engine::CShaderProgram& cShaderProgram, glm::vec3& sum) {
+  if (cShaderProgram.isVisible) {
+    sum += glm::vec3(cTransform.calculate()[3]);
+  }
+}
+
+// the cpu side of RenderSystem::update on a 50k entities scene, no GL calls
+const bench::Register renderGroups("renderGroups", []() {
+  entt::registry registry;
+  engine::RegisterGroups(registry);
+  for (uint32_t i = 0; i < Entities; ++i) {
+    entt::entity e = registry.create();
+    registry.emplace<engine::CTransform>(e);
+    registry.emplace<engine::CShaderProgram>(e);
+    registry.emplace<engine::CUUID>(e, i);
+    registry.emplace<engine::CTexture>(e);
+    switch (i % 3) {
+    case 0: registry.emplace<engine::CMesh>(e); break;
+    case 1: registry.emplace<engine::CBody>(e); break;
+    default: registry.emplace<engine::CShape>(e); break;
+    }
+  }
+
+  // the static geometry is kept by the signals, its per frame work is the
+  // same for both loops
+  demos::systems::StaticGeometry staticGeometry;
+  staticGeometry.connect(registry);
+  engine::Frustum frustum(
+    glm::perspective(glm::radians(45.f), 16.f / 9.f, 0.1f, 1000.f) *
+    glm::lookAt(glm::vec3(0.f, 0.f, 10.f), glm::vec3(0.f),
+                glm::vec3(0.f, 1.f, 0.f)));
+
+  // one view over everything drawable and the try_get cascade that picked
+  // what to draw, as the render system did before the groups
+  using Visibility = demos::systems::StaticGeometry::Visibility;
+  glm::vec3 sum{};
+  double viewMs = bench::Measure([&]() {
+    sum = {};
+    staticGeometry.update(registry);
+    staticGeometry.cull(frustum);
+    registry
+      .view<engine::CTransform, engine::CShaderProgram, engine::CUUID>()
+      .each([&](entt::entity e, const engine::CTransform& cTransform,
+                const engine::CShaderProgram& cShaderProgram,
+                const engine::CUUID&) {
+        if (staticGeometry.getVisibility(e) == Visibility::Culled) {
+          return;
+        }
+        bench::Keep(registry.try_get<engine::CTexture>(e));
+        bench::Keep(registry.try_get<engine::CTextureAtlas>(e));
+        bench::Keep(registry.try_get<engine::CSkybox>(e));
+        bench::Keep(registry.try_get<engine::CMaterial>(e));
+        if (registry.try_get<engine::CBody>(e) or
+            registry.try_get<engine::CMesh>(e) or
+            registry.try_get<engine::CShape>(e) or
+            registry.try_get<engine::CChunkManager>(e)) {
+          draw(cTransform, cShaderProgram, sum);
+        }
+        bench::Keep(registry.try_get<engine::CCollider>(e));
+      });
+    bench::Keep(sum);
+  });
+  bench::Report(std::format("view and try_get x{}", Entities), viewMs);
+
+  // the groups as RenderSystem::update walks them, the shared materials and
+  // the optional storages probed per entity
+  demos::systems::MaterialCache materialCache;
+  materialCache.connect(registry);
+  double groupsMs = bench::Measure([&]() {
+    sum = {};
+    staticGeometry.update(registry);
+    staticGeometry.cull(frustum);
+    materialCache.update(registry);
+    demos::systems::OptionalComponents optionals{registry};
+    auto drawEach = [&](auto group) {
+      group.each([&](entt::entity e, const auto&,
+                     const engine::CTransform& cTransform,
+                     const engine::CShaderProgram& cShaderProgram,
+                     const engine::CUUID&) {
+        if (staticGeometry.getVisibility(e) == Visibility::Culled) {
+          return;
+        }
+        bench::Keep(&materialCache.get(e));
+        bench::Keep(materialCache.getAtlas(
+          optionals.get<engine::CTextureAtlas>(e)));
+        bench::Keep(optionals.get<engine::CSkybox>(e));
+        bench::Keep(optionals.get<engine::CCollider>(e));
+        draw(cTransform, cShaderProgram, sum);
+      });
+    };
+    drawEach(engine::MeshGroup(registry));
+    drawEach(engine::BodyGroup(registry));
+    drawEach(engine::ShapeGroup(registry));
+    drawEach(engine::ChunkGroup(registry));
+    bench::Keep(sum);
+  });
+  bench::Report(std::format("owning groups x{}", Entities), groupsMs,
+                std::format("{:.2f}x", viewMs / groupsMs));
+});
+
+}
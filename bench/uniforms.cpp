@@ -0,0 +1,210 @@
+#include <glad/glad.h>
+
+#include <GLFW/glfw3.h>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "bench.h"
+
+#include "engineAPI.h"
+#include "render/shaderProgram.h"
+
+namespace {
+
+constexpr uint32_t Draws = 10'000;
+// draws are sorted by material, so consecutive draws share their values
+constexpr uint32_t Materials = 16;
+
+struct Material {
+    glm::vec4 color;
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+    float shininess;
+};
+
+struct Uniform {
+    GLenum type;
+    std::string name;
+};
+
+std::vector<Material> makeMaterials() {
+  std::vector<Material> materials(Materials);
+  for (uint32_t i = 0; i < Materials; ++i) {
+    float f = static_cast<float>(i) / Materials;
+    materials[i] = {glm::vec4(f, 1.f - f, 0.5f, 1.f), glm::vec3(0.1f),
+                    glm::vec3(f), glm::vec3(0.5f), 8.f + i};
+  }
+  return materials;
+}
+
+glm::mat4 modelOf(uint32_t draw) {
+  glm::mat4 model(1.f);
+  model[3].x = static_cast<float>(draw);
+  return model;
+}
+
+// the uniforms the old reset walked, block members have no location
+std::vector<Uniform> activeUniforms(GLuint program) {
+  int count = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+  std::vector<Uniform> uniforms;
+  std::array<GLchar, 256> name{};
+  for (int i = 0; i < count; ++i) {
+    GLint size = 0;
+    GLenum type = 0;
+    GLsizei length = 0;
+    glGetActiveUniform(program, i, name.size(), &length, &size, &type,
+                       name.data());
+    if (glGetUniformLocation(program, name.data()) not_eq -1) {
+      uniforms.push_back({type, std::string(name.data(), length)});
+    }
+  }
+  return uniforms;
+}
+
+// a draw before the uniform cache: every active uniform is reset and every
+// write looks its location up by name
+void drawByLookup(GLuint program, const std::vector<Uniform>& uniforms,
+                  const Material& material, const glm::mat4& model) {
+  auto location = [&](const char* name) {
+    return glGetUniformLocation(program, name);
+  };
+  glUseProgram(program);
+  for (const auto& [type, name] : uniforms) {
+    GLint loc = location(name.c_str());
+    switch (type) {
+    case GL_FLOAT: glUniform1f(loc, 0.f); break;
+    case GL_FLOAT_VEC2: glUniform2f(loc, 0.f, 0.f); break;
+    case GL_FLOAT_VEC3: glUniform3f(loc, 0.f, 0.f, 0.f); break;
+    case GL_FLOAT_VEC4: glUniform4f(loc, 0.f, 0.f, 0.f, 0.f); break;
+    case GL_FLOAT_MAT4:
+      glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(glm::mat4(1.f)));
+      break;
+    default: glUniform1i(loc, 0); break;
+    }
+  }
+  glUniform1f(location("useColor"), 1.f);
+  glUniform4fv(location("color"), 1, glm::value_ptr(material.color));
+  glUniform1f(location("useLighting"), 1.f);
+  glUniform3fv(location("ambient"), 1, glm::value_ptr(material.ambient));
+  glUniform3fv(location("diffuse"), 1, glm::value_ptr(material.diffuse));
+  glUniform3fv(location("specular"), 1, glm::value_ptr(material.specular));
+  glUniform1f(location("shininess"), material.shininess);
+  glUniform1f(location("useInstancing"), 0.f);
+  glUniformMatrix4fv(location("model"), 1, GL_FALSE, glm::value_ptr(model));
+  glUseProgram(0);
+}
+
+// the same draw through the cached setters, as cMesh does it
+void drawByName(engine::ShaderProgram& sp, const Material& material,
+                const glm::mat4& model) {
+  sp.resetActiveUniforms();
+  sp.setFloat("useColor", 1.f);
+  sp.setVec4("color", material.color);
+  sp.setFloat("useLighting", 1.f);
+  sp.setVec3("ambient", material.ambient);
+  sp.setVec3("diffuse", material.diffuse);
+  sp.setVec3("specular", material.specular);
+  sp.setFloat("shininess", material.shininess);
+  sp.setFloat("useInstancing", 0.f);
+  sp.setMat4("model", model);
+}
+
+// the per draw uniforms of the render manager set through their handles
+void drawByHandle(engine::ShaderProgram& sp, engine::UniformHandle instancing,
+                  engine::UniformHandle model, const glm::mat4& transform) {
+  sp.setFloat(instancing, 0.f);
+  sp.setMat4(model, transform);
+}
+
+// uniform writes of a single pass over the draws
+template <typename F> std::string writesOf(engine::ShaderProgram& sp, F&& f) {
+  sp.resetUniformMetrics();
+  f();
+  std::string detail = std::format("{} writes, {} skipped",
+                                   sp.getUniformWrites(),
+                                   sp.getSkippedUniformWrites());
+  sp.resetUniformMetrics();
+  return detail;
+}
+
+// needs a GL context, a hidden window is created and the benchmark is skipped
+// when there is no display. Run it from the build directory for the shaders
+const bench::Register uniforms("uniforms", []() {
+  if (not glfwInit()) {
+    std::cout << "  uniforms skipped, GLFW could not be initialized\n";
+    return;
+  }
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  GLFWwindow* window = glfwCreateWindow(64, 64, "bench", nullptr, nullptr);
+  if (not window) {
+    std::cout << "  uniforms skipped, no OpenGL 4.6 context\n";
+    glfwTerminate();
+    return;
+  }
+  glfwMakeContextCurrent(window);
+  if (gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)) ==
+      0) {
+    std::cout << "  uniforms skipped, glad could not load OpenGL\n";
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return;
+  }
+
+  {
+    engine::assets::Shader vertex("assets/shaders/basic.vert");
+    engine::assets::Shader fragment("assets/shaders/basic.frag");
+    engine::ShaderProgram sp("basic");
+    sp.attach(vertex);
+    sp.attach(fragment);
+    sp.link();
+
+    const std::vector<Material> materials = makeMaterials();
+    const std::vector<Uniform> uniforms = activeUniforms(sp);
+    auto materialOf = [&](uint32_t draw) -> const Material& {
+      return materials[draw * Materials / Draws];
+    };
+
+    double lookupMs = bench::Measure([&]() {
+      for (uint32_t i = 0; i < Draws; ++i) {
+        drawByLookup(sp, uniforms, materialOf(i), modelOf(i));
+      }
+      glFinish();
+    });
+
+    auto byName = [&]() {
+      for (uint32_t i = 0; i < Draws; ++i) {
+        drawByName(sp, materialOf(i), modelOf(i));
+      }
+      glFinish();
+    };
+    double nameMs = bench::Measure(byName);
+    std::string nameWrites = writesOf(sp, byName);
+
+    engine::UniformHandle instancing = sp.getUniform("useInstancing");
+    engine::UniformHandle model = sp.getUniform("model");
+    auto byHandle = [&]() {
+      for (uint32_t i = 0; i < Draws; ++i) {
+        drawByHandle(sp, instancing, model, modelOf(i));
+      }
+      glFinish();
+    };
+    double handleMs = bench::Measure(byHandle);
+    std::string handleWrites = writesOf(sp, byHandle);
+
+    bench::Report(std::format("location lookups x{} draws", Draws), lookupMs,
+                  std::format("{} uniforms reset per draw", uniforms.size()));
+    bench::Report(std::format("cached by name x{} draws", Draws), nameMs,
+                  std::format("{:.1f}x, {}", lookupMs / nameMs, nameWrites));
+    bench::Report(std::format("model by handle x{} draws", Draws), handleMs,
+                  handleWrites);
+  }
+
+  glfwDestroyWindow(window);
+  glfwTerminate();
+});
+
+}
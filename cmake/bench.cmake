@@ -0,0 +1,23 @@
+option(BUILD_BENCH "Build the bench executable with the engine benchmarks" OFF)
+
+# Benchmarks of the engine hot paths, built from the same sources as the demos
+# minus their entry point. Configure with CMAKE_BUILD_TYPE=Release to get
+# meaningful numbers, run bench [name] to pick the benchmarks by name
+if(BUILD_BENCH)
+    file(GLOB BENCH_FILES CONFIGURE_DEPENDS
+        "${CMAKE_CURRENT_SOURCE_DIR}/bench/*.h"
+        "${CMAKE_CURRENT_SOURCE_DIR}/bench/*.cpp"
+    )
+    set(BENCH_SOURCE_FILES ${SOURCE_FILES})
+    list(REMOVE_ITEM BENCH_SOURCE_FILES "${CMAKE_CURRENT_SOURCE_DIR}/demos/app.cpp")
+
+    add_executable(bench ${BENCH_SOURCE_FILES} ${BENCH_FILES})
+    target_include_directories(bench PRIVATE bench)
+    target_include_directories(bench PRIVATE $<TARGET_PROPERTY:${PROJECT_NAME},INCLUDE_DIRECTORIES>)
+    target_compile_definitions(bench PRIVATE $<TARGET_PROPERTY:${PROJECT_NAME},COMPILE_DEFINITIONS>)
+    target_compile_options(bench PRIVATE $<TARGET_PROPERTY:${PROJECT_NAME},COMPILE_OPTIONS>)
+    target_compile_features(bench PRIVATE cxx_std_23)
+    target_precompile_headers(bench PRIVATE src/pch.h)
+    target_link_libraries(bench PRIVATE $<TARGET_PROPERTY:${PROJECT_NAME},LINK_LIBRARIES>)
+    add_dependencies(bench copy_assets)
+endif()
@@ -94,14 +94,67 @@ inline bool onMouseScrolled(engine::events::MouseScrolledEvent& e,
   return true;
 }
 
-inline bool onMouseButtonPressed(engine::events::MouseButtonPressedEvent& e) {
+// digs the first solid block the active camera looks at, or places dirt in
+// front of it, on voxel terrain within reach
+inline void editTerrain(entt::registry& registry, bool place) {
+  entt::entity camera = registry
+                          .view<engine::CCamera, engine::CActiveCamera,
+                                engine::CTransform, engine::CUUID>()
+                          .front();
+  if (camera == entt::null or registry.get<engine::CCamera>(camera).mode ==
+                                engine::CCamera::Mode::_2D) {
+    return;
+  }
+  const engine::CTransform& cTransform =
+    registry.get<engine::CTransform>(camera);
+  glm::quat qF = cTransform.rotation * glm::quat(0, 0, 0, -1) *
+                 glm::conjugate(cTransform.rotation);
+  glm::vec3 front = glm::normalize(glm::vec3(qF.x, qF.y, qF.z));
+
+  registry.view<engine::CChunkManager>().each(
+    [&](engine::CChunkManager& cChunkManager) {
+      if (cChunkManager.meshType not_eq
+          engine::CChunkManager::MeshType::Chunk) {
+        return;
+      }
+      float blockSize = static_cast<float>(cChunkManager.blockSize);
+      float reach = 8.f * blockSize;
+      glm::vec3 previous = cTransform.position;
+      for (float t = 0.f; t < reach; t += blockSize * 0.25f) {
+        glm::vec3 position = cTransform.position + front * t;
+        std::optional<engine::CBlock::Type> block =
+          cChunkManager.getBlock(position);
+        if (block and *block not_eq engine::CBlock::Type::Air) {
+          if (place) {
+            cChunkManager.setBlock(previous, engine::CBlock::Type::Dirt);
+          } else {
+            cChunkManager.setBlock(position, engine::CBlock::Type::Air);
+          }
+          return;
+        }
+        previous = position;
+      }
+    });
+}
+
+inline bool onMouseButtonPressed(engine::events::MouseButtonPressedEvent& e,
+                                 entt::registry& registry) {
   ImGuiIO& io = ImGui::GetIO();
-  if (io.WantCaptureMouse and engine::Application::Get().isDebugging()) {
+  auto& app = engine::Application::Get();
+  if (io.WantCaptureMouse and app.isDebugging()) {
     return true;
   } else {
     io.ClearEventsQueue();
   }
 
+  if (not app.isDebugging() and not app.isGamePaused()) {
+    if (e.GetMouseButton() == engine::Mouse::ButtonLeft) {
+      editTerrain(registry, false);
+    } else if (e.GetMouseButton() == engine::Mouse::ButtonRight) {
+      editTerrain(registry, true);
+    }
+  }
+
   return true;
 }
 
@@ -231,7 +284,7 @@ inline void inputDispatcher(engine::events::Event& e,
   dispatcher.dispatch<engine::events::MouseScrolledEvent>(
     BIND_STATIC_EVENT(onMouseScrolled, registry));
   dispatcher.dispatch<engine::events::MouseButtonPressedEvent>(
-    BIND_STATIC_EVENT(onMouseButtonPressed));
+    BIND_STATIC_EVENT(onMouseButtonPressed, registry));
   dispatcher.dispatch<engine::events::MouseButtonReleasedEvent>(
     BIND_STATIC_EVENT(onMouseButtonReleased));
 
@@ -18,11 +18,14 @@ void LevelCompletedOverlay::onAttach() {
   registry.get<engine::CShaderProgram>(bird).isVisible = false;
 
   auto completed = scene_manager->getEntity("completed");
-  engine::CShape& cShape = registry.get<engine::CShape>(completed);
-  cShape.size.y = 0.4;
-  cShape.meshes.clear();
-  cShape.createMesh();
-  registry.get<engine::CTransform>(completed).position.y = 0.3;
+  // patched so the render refits its bounds
+  registry.patch<engine::CShape>(completed, [](engine::CShape& cShape) {
+    cShape.size.y = 0.4;
+    cShape.meshes.clear();
+    cShape.createMesh();
+  });
+  registry.patch<engine::CTransform>(
+    completed, [](engine::CTransform& c) { c.position.y = 0.3; });
   registry.get<engine::CShaderProgram>(completed).isVisible = true;
 
   auto restart = scene_manager->getEntity("restart");
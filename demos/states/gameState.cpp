@@ -85,6 +85,13 @@ void GameState::onAttach() {
                                   std::make_unique<systems::SkyboxSystem>(3));
     scene_manager->registerSystem("movement_system",
                                   std::make_unique<systems::MovementSystem>(8));
+  } else if (settings_manager->activeScene == "Lights") {
+    scene_manager->createScene(settings_manager->activeScene,
+                               settings_manager->activeScenePath);
+    scene_manager->registerSystem("light_system",
+                                  std::make_unique<systems::LightSystem>(4));
+    scene_manager->registerSystem("movement_system",
+                                  std::make_unique<systems::MovementSystem>(8));
   } else {
     scene_manager->createScene(settings_manager->activeScene,
                                settings_manager->activeScenePath);
@@ -168,6 +175,13 @@ void GameState::onUpdate(const engine::Time& ts) {
         scene_manager->registerSystem(
           "skybox_system", std::make_unique<systems::SkyboxSystem>(3));
         settings_manager->reloadScene = false;
+      } else if (settings_manager->activeScene == "Lights") {
+        scene_manager->reloadScene(settings_manager->reloadPrototypes);
+
+        scene_manager->unregisterSystem("light_system");
+        scene_manager->registerSystem(
+          "light_system", std::make_unique<systems::LightSystem>(4));
+        settings_manager->reloadScene = false;
       } else {
         scene_manager->reloadScene(settings_manager->reloadPrototypes);
         settings_manager->reloadScene = false;
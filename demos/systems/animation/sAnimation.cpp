@@ -10,6 +10,15 @@ static bool rotate = true;
 
 namespace demos::systems {
 
+engine::systems::SystemAccess AnimationSystem::getAccess() const {
+  // the rotations are found in update and applied in commit, so the systems
+  // that move other entities or read the lights share its stage
+  return engine::systems::SystemAccess()
+    .read<engine::CRigidBody, engine::CTag, engine::CUUID>()
+    .write<engine::CTextureAtlas>()
+    .defer<engine::CTransform>();
+}
+
 void AnimationSystem::update(entt::registry& registry, const engine::Time& ts) {
   auto& app = engine::Application::Get();
   if (app.isGamePaused()) {
@@ -17,17 +26,27 @@ void AnimationSystem::update(entt::registry& registry, const engine::Time& ts) {
   }
   const auto& settings_manager = app.getSettingsManager();
 
+  if (settings_manager->activeScene == "Cubes") {
+    registry
+      .view<engine::CTransform, engine::CRigidBody, engine::CTag,
+            engine::CUUID>()
+      .each([&](entt::entity e, const engine::CTransform& cTransform,
+                const engine::CRigidBody& cRigidBody, const engine::CTag& cTag,
+                const engine::CUUID& cUUID) {
+        if (cRigidBody.isKinematic and cTag.tag.ends_with("_block")) {
+          m_rotations.push_back({e, 1.f, {0.f, 1.f, 0.f}});
+        }
+      });
+    return;
+  }
+
   registry
     .view<engine::CTransform, engine::CRigidBody, engine::CTag, engine::CUUID>()
-    .each([&](entt::entity e, engine::CTransform& cTransform,
+    .each([&](entt::entity e, const engine::CTransform& cTransform,
               const engine::CRigidBody& cRigidBody, const engine::CTag& cTag,
               const engine::CUUID& cUUID) {
       if (cRigidBody.isKinematic) {
-        if (settings_manager->activeScene == "Cubes") {
-          if (cTag.tag.ends_with("_block")) {
-            cTransform.rotate(1.f, {0.f, 1.f, 0.f});
-          }
-        } else if (settings_manager->activeScene == "Flappy Bird") {
+        if (settings_manager->activeScene == "Flappy Bird") {
           if (cTag.tag == "bird") {
             engine::CTextureAtlas& cTextureAtlas =
               registry.get<engine::CTextureAtlas>(e);
@@ -53,7 +72,7 @@ void AnimationSystem::update(entt::registry& registry, const engine::Time& ts) {
                 rotate = true;
               }
             }
-            cTransform.rotate(rotation, {0.0f, 0.0f, 1.0f});
+            m_rotations.push_back({e, rotation, {0.0f, 0.0f, 1.0f}});
           } else if (cTag.tag == "coin") {
             engine::CTextureAtlas& cTextureAtlas =
               registry.get<engine::CTextureAtlas>(e);
@@ -72,4 +91,17 @@ void AnimationSystem::update(entt::registry& registry, const engine::Time& ts) {
       }
     });
 }
+
+void AnimationSystem::commit(entt::registry& registry, const engine::Time& ts) {
+  // the blocks only rotate themselves so they are split over the pool
+  engine::Application::Get().getThreadPool()->parallelFor(
+    m_rotations.size(), 1024, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const Rotation& pending = m_rotations[i];
+        registry.get<engine::CTransform>(pending.e)
+          .rotate(pending.angle, pending.axis);
+      }
+    });
+  m_rotations.clear();
+}
 }
@@ -10,7 +10,21 @@ class AnimationSystem : public engine::systems::System {
   public:
     AnimationSystem(int priority) : engine::systems::System(priority) {}
 
-    void update(entt::registry& registry, const engine::Time& ts) override final;
+    void update(entt::registry& registry,
+                const engine::Time& ts) override final;
+    void commit(entt::registry& registry,
+                const engine::Time& ts) override final;
+    engine::systems::SystemAccess getAccess() const override final;
+
+  private:
+    struct Rotation {
+        entt::entity e{entt::null};
+        float angle{};
+        glm::vec3 axis{};
+    };
+
+    // found in update, applied in commit
+    std::vector<Rotation> m_rotations;
 };
 
 }
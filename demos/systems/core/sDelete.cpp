@@ -2,6 +2,11 @@
 
 namespace demos::systems {
 
+engine::systems::SystemAccess DeleteSystem::getAccess() const {
+  // destroying entities changes every storage they are in, so it runs alone
+  return engine::systems::SystemAccess();
+}
+
 void DeleteSystem::update(entt::registry& registry, const engine::Time& ts) {
   if (engine::Application::Get().isGamePaused()) {
     return;
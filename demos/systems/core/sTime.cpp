@@ -2,6 +2,14 @@
 
 namespace demos::systems {
 
+engine::systems::SystemAccess TimeSystem::getAccess() const {
+  // the tick event goes through the windows manager
+  return engine::systems::SystemAccess()
+    .read<engine::CUUID>()
+    .write<engine::CTime>()
+    .onMainThread();
+}
+
 void TimeSystem::update(entt::registry& registry, const engine::Time& ts) {
   auto& app = engine::Application::Get();
   if (app.isGamePaused()) {
@@ -12,6 +12,7 @@ class TimeSystem : public engine::systems::System {
 
     void update(entt::registry& registry,
                 const engine::Time& ts) override final;
+    engine::systems::SystemAccess getAccess() const override final;
 };
 
 }
@@ -4,42 +4,460 @@
 
 namespace demos::systems {
 
+template <class T> void hashCombine(size_t& seed, const T& value) {
+  seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+template <class T>
+void hashCombine(size_t& seed, const std::vector<T>& values) {
+  for (const T& value : values) {
+    hashCombine(seed, value);
+  }
+}
+
+template <glm::length_t L>
+void hashCombine(size_t& seed, const glm::vec<L, float>& vector) {
+  for (glm::length_t i = 0; i < L; ++i) {
+    hashCombine(seed, vector[i]);
+  }
+}
+
+size_t TextureHash::operator()(const engine::CTexture& cTexture) const {
+  size_t seed = 0;
+  hashCombine(seed, cTexture.filepaths);
+  hashCombine(seed, cTexture.textures);
+  hashCombine(seed, cTexture.color);
+  hashCombine(seed, cTexture.blendFactor);
+  hashCombine(seed, cTexture.reflectivity);
+  hashCombine(seed, cTexture.refractiveIndex);
+  hashCombine(seed, cTexture.hasTransparency);
+  hashCombine(seed, cTexture.useLighting);
+  hashCombine(seed, cTexture.useReflection);
+  hashCombine(seed, cTexture.useRefraction);
+  hashCombine(seed, cTexture._drawMode);
+  hashCombine(seed, cTexture.drawMode);
+  return seed;
+}
+
+size_t MaterialHash::operator()(const engine::CMaterial& cMaterial) const {
+  size_t seed = 0;
+  hashCombine(seed, cMaterial.ambient);
+  hashCombine(seed, cMaterial.diffuse);
+  hashCombine(seed, cMaterial.specular);
+  hashCombine(seed, cMaterial.shininess);
+  return seed;
+}
+
+size_t MeshTexturesHash::operator()(const engine::CMesh& cMesh) const {
+  size_t seed = 0;
+  hashCombine(seed, cMesh.textures);
+  return seed;
+}
+
+template <class Component> void MaterialCache::watch(entt::registry& registry) {
+  m_connections.emplace_back(registry.on_construct<Component>()
+                               .template connect<&MaterialCache::onChanged>(
+                                 *this));
+  m_connections.emplace_back(registry.on_update<Component>()
+                               .template connect<&MaterialCache::onChanged>(
+                                 *this));
+  m_connections.emplace_back(registry.on_destroy<Component>()
+                               .template connect<&MaterialCache::onChanged>(
+                                 *this));
+  // the entities created before the system
+  for (entt::entity e : registry.view<Component>()) {
+    m_dirty.emplace(e);
+  }
+}
+
+void MaterialCache::connect(entt::registry& registry) {
+  watch<engine::CTexture>(registry);
+  watch<engine::CMaterial>(registry);
+  watch<engine::CBody>(registry);
+  watch<engine::CUUID>(registry);
+}
+
+void MaterialCache::onChanged(entt::registry& registry, entt::entity e) {
+  std::scoped_lock lock(m_dirtyMutex);
+  m_dirty.emplace(e);
+}
+
+void MaterialCache::release(const SharedMaterials& shared) {
+  m_textures.release(shared.texture);
+  m_materials.release(shared.material);
+  for (const engine::CMaterial* material : shared.bodyMaterials) {
+    m_materials.release(material);
+  }
+  for (const engine::CMesh* textures : shared.bodyTextures) {
+    m_meshTextures.release(textures);
+  }
+}
+
+void MaterialCache::update(entt::registry& registry) {
+  std::unordered_set<entt::entity> dirty;
+  {
+    std::scoped_lock lock(m_dirtyMutex);
+    std::swap(dirty, m_dirty);
+  }
+  for (entt::entity e : dirty) {
+    if (auto it = m_entities.find(e); it not_eq m_entities.end()) {
+      release(it->second);
+      m_entities.erase(it);
+    }
+    // prototypes are never drawn
+    if (not registry.valid(e) or not registry.all_of<engine::CUUID>(e)) {
+      continue;
+    }
+    SharedMaterials shared;
+    const auto* cTexture = registry.try_get<engine::CTexture>(e);
+    if (cTexture) {
+      shared.texture = m_textures.acquire(*cTexture);
+    }
+    if (const auto* cMaterial = registry.try_get<engine::CMaterial>(e)) {
+      shared.material = m_materials.acquire(*cMaterial);
+    }
+    if (const auto* cBody = registry.try_get<engine::CBody>(e)) {
+      for (size_t i = 0; i < cBody->meshes.size(); ++i) {
+        shared.bodyMaterials.emplace_back(
+          m_materials.acquire(cBody->materials.at(i)));
+        if (not cTexture) {
+          engine::CMesh textures;
+          textures.textures = cBody->meshes[i].textures;
+          shared.bodyTextures.emplace_back(m_meshTextures.acquire(textures));
+        }
+      }
+    }
+    m_entities.emplace(e, std::move(shared));
+  }
+}
+
+engine::CTextureAtlas*
+MaterialCache::getAtlas(const engine::CTextureAtlas* cTextureAtlas) {
+  if (not cTextureAtlas) {
+    return nullptr;
+  }
+  uint64_t key =
+    (static_cast<uint64_t>(cTextureAtlas->rows) << 32) | cTextureAtlas->index;
+  return &m_atlases.try_emplace(key, *cTextureAtlas).first->second;
+}
+
+uint32_t LODView::select(const engine::CMesh& mesh,
+                         const engine::AABB& worldBounds) const {
+  if (mesh.lods.empty() or projectionScale == 0.f or
+      not worldBounds.isValid()) {
+    return 0;
+  }
+  float radius = glm::length(worldBounds.getExtents());
+  float distance = glm::length(worldBounds.getCenter() - position);
+  if (distance <= radius) {
+    return 0;
+  }
+  // projected radius over the viewport height, which is 2 in clip space
+  return mesh.selectLOD(radius * projectionScale / (2.f * distance));
+}
+
+void checkTexture(entt::registry& registry, entt::entity e,
+                  const engine::CUUID& cUUID,
+                  const engine::CTexture* cTexture) {
+  if (cTexture) {
+    return;
+  }
+  engine::CName* cName = registry.try_get<engine::CName>(e);
+  if (cName) {
+    ENGINE_ASSERT(false, "No texture found for entity {} {}", cUUID.uuid,
+                  cName->name);
+  } else {
+    ENGINE_ASSERT(false, "No texture found for entity {}", cUUID.uuid);
+  }
+}
+
+// the texture, atlas and material are the shared copies, meshTextures the
+// shared textures of a mesh drawn without a CTexture. inFrustum when the
+// static geometry found the mesh in the frustum
 void render(engine::CTexture* cTexture, engine::CTextureAtlas* cTextureAtlas,
             const engine::CSkybox* cSkybox, engine::CMaterial* cMaterial,
-            engine::CMesh* cMesh, const engine::CTransform& cTransform,
+            engine::CMesh* cMesh, engine::CMesh* meshTextures,
+            const engine::CTransform& cTransform,
             const engine::CShaderProgram& cShaderProgram,
             engine::CTexture* cSkyboxTexture, engine::CCollider* cCollider,
-            const std::unique_ptr<engine::RenderManager>& render_manager) {
-  if (cTexture and cTexture->hasTransparency) {
-    engine::RenderAPI::ToggleCulling(false);
-  }
-  if (cSkybox) {
-    engine::RenderAPI::SetDepthLEqual();
+            const std::unique_ptr<engine::RenderManager>& render_manager,
+            const LODView& lodView, bool inFrustum) {
+  using Layer = engine::RenderMaterial::Layer;
+  glm::mat4 transform = cTransform.calculate();
+  const engine::AABB& bounds = cMesh->bounds;
+  uint32_t lod = 0;
+  if (not cSkybox and not cMesh->lods.empty()) {
+    lod = lodView.select(*cMesh, bounds.transform(transform));
   }
-  cMesh->bindTextures(render_manager->getShaderProgram(cShaderProgram.name),
-                      cTexture, cTextureAtlas, cSkyboxTexture, cMaterial);
-  render_manager->render(cMesh->getVAO(), cTransform.calculate(),
-                         cShaderProgram.name);
-  cMesh->unbindTextures(cTexture);
-  if (cTexture and cTexture->hasTransparency) {
-    engine::RenderAPI::ToggleCulling(true);
-  }
-  if (cSkybox) {
-    engine::RenderAPI::SetDepthLess();
+  engine::GeometryPool::Draw draw = cMesh->getDraw(lod);
+  // meshes without a CTexture bind their own textures
+  engine::CMesh* textureMesh = meshTextures ? meshTextures : cMesh;
+  const void* textures = cTexture;
+  if (not cTexture) {
+    textures = textureMesh;
   }
+  uint32_t material = render_manager->getMaterial(
+    {textures, cTextureAtlas, cMaterial}, [&]() {
+      Layer layer = Layer::Opaque;
+      if (cSkybox) {
+        layer = Layer::Skybox;
+      } else if (cTexture and cTexture->hasTransparency) {
+        layer = Layer::Transparent;
+      }
+      return engine::RenderMaterial{
+        [=](const std::unique_ptr<engine::ShaderProgram>& sp) {
+          textureMesh->bindTextures(sp, cTexture, cTextureAtlas,
+                                    cSkyboxTexture, cMaterial);
+        },
+        [=]() { textureMesh->unbindTextures(cTexture); }, layer};
+    });
+  render_manager->submit(draw, transform, cShaderProgram.name, material,
+                         bounds, lod, inFrustum);
+
   if (cCollider and
       engine::Application::Get().getSettingsManager()->displayCollisionBoxes) {
     // TODO fix transparency so I can render this first
     // disabling culling is not working
-    const auto& sp = render_manager->getShaderProgram("shape");
-    sp->resetActiveUniforms();
-    sp->use();
-    sp->setFloat("useColor", 1.f);
-    sp->setVec4("color", cCollider->color);
-    sp->unuse();
-    render_manager->render(cCollider->mesh.getVAO(), cTransform.calculate(),
-                           "shape");
+    uint32_t colliderMaterial = render_manager->getMaterial(
+      {cCollider, nullptr, nullptr}, [&]() {
+        return engine::RenderMaterial{
+          [=](const std::unique_ptr<engine::ShaderProgram>& sp) {
+            sp->resetActiveUniforms();
+            sp->use();
+            sp->setFloat("useColor", 1.f);
+            sp->setVec4("color", cCollider->color);
+            sp->unuse();
+          },
+          nullptr};
+      });
+    render_manager->submit(cCollider->mesh.getDraw(), transform, "shape",
+                           colliderMaterial);
+  }
+}
+
+template <class Component>
+void StaticGeometry::watch(entt::registry& registry, bool updates) {
+  m_connections.emplace_back(registry.on_construct<Component>()
+                               .template connect<&StaticGeometry::onChanged>(
+                                 *this));
+  m_connections.emplace_back(registry.on_destroy<Component>()
+                               .template connect<&StaticGeometry::onChanged>(
+                                 *this));
+  if (updates) {
+    m_connections.emplace_back(registry.on_update<Component>()
+                                 .template connect<&StaticGeometry::onChanged>(
+                                   *this));
+  }
+  // the entities created before the system
+  for (entt::entity e : registry.view<Component>()) {
+    m_dirty.emplace(e);
+  }
+}
+
+void StaticGeometry::connect(entt::registry& registry) {
+  watch<engine::CShaderProgram>(registry, false);
+  watch<engine::CUUID>(registry, false);
+  watch<engine::CSkybox>(registry, false);
+  watch<engine::CChunkManager>(registry, false);
+  // moves, kinematic changes and new meshes refit the item
+  watch<engine::CTransform>(registry, true);
+  watch<engine::CRigidBody>(registry, true);
+  watch<engine::CMesh>(registry, true);
+  watch<engine::CBody>(registry, true);
+  watch<engine::CShape>(registry, true);
+}
+
+void StaticGeometry::onChanged(entt::registry& registry, entt::entity e) {
+  std::scoped_lock lock(m_dirtyMutex);
+  m_dirty.emplace(e);
+}
+
+engine::AABB StaticGeometry::getBox(entt::registry& registry,
+                                    const Item& item) const {
+  if (item.chunk) {
+    return item.chunk->terrainMesh.bounds.transform(
+      item.chunk->transform.calculate());
+  }
+
+  // an entity with a mesh without bounds is never culled
+  engine::AABB bounds;
+  auto addMeshes = [&](const std::vector<engine::CMesh>& meshes) {
+    for (const engine::CMesh& mesh : meshes) {
+      if (not mesh.bounds.isValid()) {
+        return false;
+      }
+      bounds.expand(mesh.bounds);
+    }
+    return true;
+  };
+  bool valid = false;
+  if (const auto* cMesh = registry.try_get<engine::CMesh>(item.entity)) {
+    valid = cMesh->bounds.isValid();
+    bounds = cMesh->bounds;
+  } else if (const auto* cBody = registry.try_get<engine::CBody>(item.entity)) {
+    valid = addMeshes(cBody->meshes);
+  } else if (const auto* cShape =
+               registry.try_get<engine::CShape>(item.entity)) {
+    valid = addMeshes(cShape->meshes);
+  }
+  if (not valid) {
+    return {};
+  }
+  return bounds.transform(registry.get<engine::CTransform>(item.entity)
+                            .calculate());
+}
+
+void StaticGeometry::resync(entt::registry& registry, entt::entity e) {
+  bool isStatic = false;
+  bool isTerrain = false;
+  // prototypes have no CUUID and are never drawn
+  if (registry.valid(e) and
+      registry.all_of<engine::CShaderProgram, engine::CTransform,
+                      engine::CUUID>(e) and
+      not registry.all_of<engine::CSkybox>(e)) {
+    const auto* cRigidBody = registry.try_get<engine::CRigidBody>(e);
+    if (not cRigidBody or not cRigidBody->isKinematic) {
+      isStatic =
+        registry.any_of<engine::CMesh, engine::CBody, engine::CShape>(e);
+      isTerrain = not isStatic and registry.all_of<engine::CChunkManager>(e);
+    }
+  }
+
+  if (auto it = m_entityItems.find(e); it not_eq m_entityItems.end()) {
+    if (isStatic) {
+      if (not m_rebuild) {
+        m_bvh.update(it->second, getBox(registry, m_items[it->second]));
+      }
+    } else {
+      m_entityItems.erase(it);
+      m_rebuild = true;
+    }
+  } else if (isStatic) {
+    m_entityItems.emplace(e, 0); // indexed by the rebuild
+    m_rebuild = true;
+  }
+
+  // the chunks keep their own transforms, only the counted changes matter
+  if (isTerrain not_eq m_terrains.contains(e)) {
+    if (isTerrain) {
+      m_terrains.emplace(e, Terrain{registry.get<engine::CChunkManager>(e)
+                                      .version});
+    } else {
+      m_terrains.erase(e);
+    }
+    m_rebuild = true;
+  }
+}
+
+void StaticGeometry::resyncChunks(entt::entity e,
+                                  const engine::CChunkManager& manager,
+                                  Terrain& terrain) {
+  terrain.version = manager.version;
+  uint32_t chunks = 0;
+  for (const auto& [coords, chunk] : manager.chunks) {
+    if (chunk.terrainMesh.indices.empty()) {
+      continue;
+    }
+    ++chunks;
+    // loads and unloads move the chunks in their map
+    auto it = m_chunkItems.find(&chunk);
+    if (it == m_chunkItems.end() or m_items[it->second].entity not_eq e) {
+      m_rebuild = true;
+      return;
+    }
+  }
+  m_rebuild = m_rebuild or chunks not_eq terrain.chunks;
+}
+
+void StaticGeometry::rebuild(entt::registry& registry) {
+  m_items.clear();
+  m_chunkItems.clear();
+  for (auto& [e, item] : m_entityItems) {
+    item = m_items.size();
+    m_items.emplace_back(e, nullptr);
+  }
+  for (auto& [e, terrain] : m_terrains) {
+    const auto& manager = registry.get<engine::CChunkManager>(e);
+    terrain.version = manager.version;
+    terrain.chunks = 0;
+    for (const auto& [coords, chunk] : manager.chunks) {
+      if (not chunk.terrainMesh.indices.empty()) {
+        m_chunkItems.emplace(&chunk, m_items.size());
+        m_items.emplace_back(e, &chunk);
+        ++terrain.chunks;
+      }
+    }
+  }
+
+  std::vector<engine::AABB> boxes;
+  boxes.reserve(m_items.size());
+  for (const Item& item : m_items) {
+    boxes.emplace_back(getBox(registry, item));
   }
+  m_bvh.build(std::move(boxes));
+  m_rebuild = false;
+}
+
+void StaticGeometry::update(entt::registry& registry) {
+  std::unordered_set<entt::entity> dirty;
+  {
+    std::scoped_lock lock(m_dirtyMutex);
+    std::swap(dirty, m_dirty);
+  }
+  for (entt::entity e : dirty) {
+    resync(registry, e);
+  }
+
+  // the terrain system counts the chunks it loads, unloads and remeshes
+  std::vector<entt::entity> remeshed;
+  for (auto& [e, terrain] : m_terrains) {
+    const auto& manager = registry.get<engine::CChunkManager>(e);
+    if (manager.version not_eq terrain.version) {
+      resyncChunks(e, manager, terrain);
+      remeshed.emplace_back(e);
+    }
+  }
+
+  if (m_rebuild) {
+    rebuild(registry);
+    return;
+  }
+  for (entt::entity e : remeshed) {
+    const auto& manager = registry.get<engine::CChunkManager>(e);
+    for (const auto& [coords, chunk] : manager.chunks) {
+      if (not chunk.terrainMesh.indices.empty()) {
+        uint32_t item = m_chunkItems.at(&chunk);
+        m_bvh.update(item, getBox(registry, m_items[item]));
+      }
+    }
+  }
+  // only the leaves of the moved items and their ancestors
+  m_bvh.refit();
+}
+
+void StaticGeometry::cull(const engine::Frustum& frustum) {
+  m_visible.assign(m_items.size(), 0);
+  m_bvh.query([&](const engine::AABB& box) { return frustum.isVisible(box); },
+              [&](uint32_t item) { m_visible[item] = 1; });
+}
+
+void RenderSystem::init(entt::registry& registry) {
+  m_materialCache.connect(registry);
+  m_staticGeometry.connect(registry);
+}
+
+engine::systems::SystemAccess RenderSystem::getAccess() const {
+  // draws through the GL context, the storages sorted by distance change
+  // order so they count as written
+  return engine::systems::SystemAccess()
+    .read<engine::CTransform, engine::CShaderProgram, engine::CActiveCamera,
+          engine::CRigidBody, engine::CTexture, engine::CMaterial,
+          engine::CTextureAtlas, engine::CSkybox, engine::CCollider,
+          engine::CName>()
+    .write<engine::CUUID, engine::CDistanceFromCamera, engine::CMesh,
+           engine::CBody, engine::CShape, engine::CChunkManager,
+           engine::CCamera, engine::CFBO>()
+    .onMainThread();
 }
 
 void RenderSystem::update(entt::registry& registry, const engine::Time& ts) {
@@ -70,10 +488,17 @@ void RenderSystem::update(entt::registry& registry, const engine::Time& ts) {
   cCamera.calculateView(cCameraTransform.position, cCameraTransform.rotation);
   render_manager->beginScene(cCamera.view, cCamera.projection,
                              cCameraTransform.position);
+  m_materialCache.update(registry);
+  m_staticGeometry.update(registry);
+  m_staticGeometry.cull(render_manager->getFrustum());
+  // glm perspective matrices have a 0 in the corner, orthographic ones a 1
+  LODView lodView{cCameraTransform.position,
+                  cCamera.projection[3][3] == 0.f ? cCamera.projection[1][1]
+                                                  : 0.f};
 
   entt::entity sky = registry.view<engine::CSkybox, engine::CUUID>()
                        .front(); // TODO: support more than one?
-  engine::CTexture* cSkyboxTexture;
+  engine::CTexture* cSkyboxTexture = nullptr;
   if (sky not_eq entt::null) {
     cSkyboxTexture = registry.try_get<engine::CTexture>(sky);
   }
@@ -85,92 +510,122 @@ void RenderSystem::update(entt::registry& registry, const engine::Time& ts) {
         return lhs.distance < rhs.distance;
       });
     registry.sort<engine::CUUID, engine::CDistanceFromCamera>();
+    // the owned storages of the groups can not follow the distances through
+    // the registry, they take the order of the uuids instead
+    const auto& uuids = registry.storage<engine::CUUID>();
+    auto byDistance = [&](entt::entity lhs, entt::entity rhs) {
+      return uuids.index(lhs) > uuids.index(rhs);
+    };
+    engine::MeshGroup(registry).sort(byDistance);
+    engine::BodyGroup(registry).sort(byDistance);
+    engine::ShapeGroup(registry).sort(byDistance);
+    engine::ChunkGroup(registry).sort(byDistance);
   }
 
-  registry.view<engine::CTransform, engine::CShaderProgram, engine::CUUID>()
-    .each([&](entt::entity e, const engine::CTransform& cTransform,
-              const engine::CShaderProgram& cShaderProgram,
-              const engine::CUUID& cUUID) {
-      engine::CTexture* cTexture = registry.try_get<engine::CTexture>(e);
+  // each archetype comes from its own group, the optional components are
+  // probed on their storages, which are looked up once per frame
+  OptionalComponents optionals{registry};
+  using Visibility = StaticGeometry::Visibility;
+  engine::MeshGroup(registry).each(
+    [&](entt::entity e, engine::CMesh& cMesh,
+        const engine::CTransform& cTransform,
+        const engine::CShaderProgram& cShaderProgram,
+        const engine::CUUID& cUUID) {
+      Visibility visibility = m_staticGeometry.getVisibility(e);
+      if (not cShaderProgram.isVisible or visibility == Visibility::Culled) {
+        return;
+      }
+      // TODO objects with one mesh unused
+      const SharedMaterials& shared = m_materialCache.get(e);
+      checkTexture(registry, e, cUUID, shared.texture);
+      render(shared.texture,
+             m_materialCache.getAtlas(optionals.get<engine::CTextureAtlas>(e)),
+             optionals.get<engine::CSkybox>(e), shared.material, &cMesh,
+             nullptr, cTransform, cShaderProgram, cSkyboxTexture,
+             optionals.get<engine::CCollider>(e), render_manager, lodView,
+             visibility == Visibility::Visible);
+    });
+  engine::BodyGroup(registry).each(
+    [&](entt::entity e, engine::CBody& cBody,
+        const engine::CTransform& cTransform,
+        const engine::CShaderProgram& cShaderProgram,
+        const engine::CUUID& cUUID) { // models
+      Visibility visibility = m_staticGeometry.getVisibility(e);
+      if (not cShaderProgram.isVisible or visibility == Visibility::Culled) {
+        return;
+      }
+      const SharedMaterials& shared = m_materialCache.get(e);
       engine::CTextureAtlas* cTextureAtlas =
-        registry.try_get<engine::CTextureAtlas>(e);
-      engine::CSkybox* cSkybox = registry.try_get<engine::CSkybox>(e);
-      engine::CMaterial* cMaterial = registry.try_get<engine::CMaterial>(e);
-      engine::CBody* cBody = registry.try_get<engine::CBody>(e);
-      engine::CMesh* cMesh = registry.try_get<engine::CMesh>(e);
-      engine::CShape* cShape = registry.try_get<engine::CShape>(e);
-      engine::CChunkManager* cChunkManager =
-        registry.try_get<engine::CChunkManager>(e);
-      engine::CCollider* cCollider = registry.try_get<engine::CCollider>(e);
-
-      if (cShaderProgram.isVisible) {
-        if (cMesh) { // TODO objects with one mesh unused
-          if (not cTexture) {
-            engine::CName* cName = registry.try_get<engine::CName>(e);
-            if (cName) {
-              ENGINE_ASSERT(false, "No texture found for entity {} {}",
-                            cUUID.uuid, cName->name);
-            } else {
-              ENGINE_ASSERT(false, "No texture found for entity {}",
-                            cUUID.uuid);
-            }
-          }
-
-          render(cTexture, cTextureAtlas, cSkybox, cMaterial, cMesh, cTransform,
-                 cShaderProgram, cSkyboxTexture, cCollider, render_manager);
-        } else if (cBody) { // models
-          for (size_t i = 0; i < cBody->meshes.size(); ++i) {
-            engine::CMesh& mesh = cBody->meshes.at(i);
-            engine::CMaterial& material = cBody->materials.at(i);
-            render(cTexture, cTextureAtlas, cSkybox, &material, &mesh,
-                   cTransform, cShaderProgram, cSkyboxTexture, cCollider,
-                   render_manager);
-          }
-        } else if (cShape) { // primitives
-          if (not cTexture) {
-            engine::CName* cName = registry.try_get<engine::CName>(e);
-            if (cName) {
-              ENGINE_ASSERT(false, "No texture found for entity {} {}",
-                            cUUID.uuid, cName->name);
-            } else {
-              ENGINE_ASSERT(false, "No texture found for entity {}",
-                            cUUID.uuid);
-            }
-          }
-
-          for (auto& mesh : cShape->meshes) {
-            render(cTexture, cTextureAtlas, cSkybox, cMaterial, &mesh,
-                   cTransform, cShaderProgram, cSkyboxTexture, cCollider,
-                   render_manager);
-          }
-        } else if (cChunkManager) { // terrain
-          if (not cTexture) {
-            engine::CName* cName = registry.try_get<engine::CName>(e);
-            if (cName) {
-              ENGINE_ASSERT(false, "No texture found for entity {} {}",
-                            cUUID.uuid, cName->name);
-            } else {
-              ENGINE_ASSERT(false, "No texture found for entity {}",
-                            cUUID.uuid);
-            }
-          }
-
-          for (auto& [position, chunk] : cChunkManager->chunks) {
-            render(cTexture, cTextureAtlas, cSkybox, cMaterial,
-                   &chunk.terrainMesh, chunk.transform, cShaderProgram,
-                   cSkyboxTexture, cCollider, render_manager);
-          }
-        } else {
-          engine::CName* cName = registry.try_get<engine::CName>(e);
-          if (cName) {
-            ENGINE_ASSERT(false, "No mesh found for entity {} {}", cUUID.uuid,
-                          cName->name);
-          } else {
-            ENGINE_ASSERT(false, "No mesh found for entity {}", cUUID.uuid);
-          }
+        m_materialCache.getAtlas(optionals.get<engine::CTextureAtlas>(e));
+      engine::CSkybox* cSkybox = optionals.get<engine::CSkybox>(e);
+      engine::CCollider* cCollider = optionals.get<engine::CCollider>(e);
+      // a body changed in place without patch draws its own materials
+      size_t shareds = shared.bodyMaterials.size();
+      for (size_t i = 0; i < cBody.meshes.size(); ++i) {
+        engine::CMesh& mesh = cBody.meshes.at(i);
+        engine::CMaterial* material = i < shareds ? shared.bodyMaterials[i]
+                                                  : &cBody.materials.at(i);
+        engine::CMesh* textures =
+          i < shared.bodyTextures.size() ? shared.bodyTextures[i] : nullptr;
+        render(shared.texture, cTextureAtlas, cSkybox, material, &mesh,
+               textures, cTransform, cShaderProgram, cSkyboxTexture,
+               cCollider, render_manager, lodView,
+               visibility == Visibility::Visible);
+      }
+    });
+  engine::ShapeGroup(registry).each(
+    [&](entt::entity e, engine::CShape& cShape,
+        const engine::CTransform& cTransform,
+        const engine::CShaderProgram& cShaderProgram,
+        const engine::CUUID& cUUID) { // primitives
+      Visibility visibility = m_staticGeometry.getVisibility(e);
+      if (not cShaderProgram.isVisible or visibility == Visibility::Culled) {
+        return;
+      }
+      const SharedMaterials& shared = m_materialCache.get(e);
+      checkTexture(registry, e, cUUID, shared.texture);
+      engine::CTextureAtlas* cTextureAtlas =
+        m_materialCache.getAtlas(optionals.get<engine::CTextureAtlas>(e));
+      engine::CSkybox* cSkybox = optionals.get<engine::CSkybox>(e);
+      engine::CCollider* cCollider = optionals.get<engine::CCollider>(e);
+      for (auto& mesh : cShape.meshes) {
+        render(shared.texture, cTextureAtlas, cSkybox, shared.material, &mesh,
+               nullptr, cTransform, cShaderProgram, cSkyboxTexture, cCollider,
+               render_manager, lodView, visibility == Visibility::Visible);
+      }
+    });
+  engine::ChunkGroup(registry).each(
+    [&](entt::entity e, engine::CChunkManager& cChunkManager,
+        const engine::CTransform& cTransform,
+        const engine::CShaderProgram& cShaderProgram,
+        const engine::CUUID& cUUID) { // terrain
+      if (not cShaderProgram.isVisible) {
+        return;
+      }
+      const SharedMaterials& shared = m_materialCache.get(e);
+      checkTexture(registry, e, cUUID, shared.texture);
+      engine::CTextureAtlas* cTextureAtlas =
+        m_materialCache.getAtlas(optionals.get<engine::CTextureAtlas>(e));
+      engine::CSkybox* cSkybox = optionals.get<engine::CSkybox>(e);
+      engine::CCollider* cCollider = optionals.get<engine::CCollider>(e);
+      for (auto& [coords, chunk] : cChunkManager.chunks) {
+        Visibility visibility = m_staticGeometry.getVisibility(chunk);
+        if (chunk.terrainMesh.indices.empty() or // only air
+            visibility == Visibility::Culled) {
+          continue;
         }
+        render(shared.texture, cTextureAtlas, cSkybox, shared.material,
+               &chunk.terrainMesh, nullptr, chunk.transform, cShaderProgram,
+               cSkyboxTexture, cCollider, render_manager, lodView,
+               visibility == Visibility::Visible);
       }
     });
+  if (fbo not_eq entt::null) {
+    // the depth of this frame hides the meshes of the next ones
+    render_manager->setOcclusionFramebuffer(
+      registry.get<engine::CFBO>(fbo).fbo);
+  }
+  render_manager->flush();
 
   if (fbo not_eq entt::null) {
     engine::CFBO& cfbo = registry.get<engine::CFBO>(fbo);
@@ -184,11 +639,11 @@ void RenderSystem::update(entt::registry& registry, const engine::Time& ts) {
     cfbo.setupProperties(render_manager->getShaderProgram("fbo"));
     const auto& settings_manager = app.getSettingsManager();
     if (settings_manager->windowInsideImgui) {
-      render_manager->renderInsideImGui(cShape.meshes.at(0).getVAO(), cfbo.fbo,
+      render_manager->renderInsideImGui(cShape.meshes.at(0).getDraw(), cfbo.fbo,
                                         "scene", {0, 0}, {0, 0},
                                         settings_manager->fitToWindow);
     } else {
-      render_manager->renderFBO(cShape.meshes.at(0).getVAO(), cfbo.fbo);
+      render_manager->renderFBO(cShape.meshes.at(0).getDraw(), cfbo.fbo);
     }
   }
 
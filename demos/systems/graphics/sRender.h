@@ -1,17 +1,243 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <mutex>
+#include <unordered_set>
 
 #include "engineAPI.h"
 
 namespace demos::systems {
 
+// entities cloned from the same prototype own equal copies of its components,
+// they are drawn with one shared copy so their meshes share one material and
+// are drawn instanced. The copy lives while an entity uses it, the component
+// storages move their components when the groups are sorted
+template <class T, class Hash, class Equal = std::equal_to<>>
+class SharedComponents {
+  public:
+    T* acquire(const T& component) {
+      size_t hash = Hash{}(component);
+      auto [begin, end] = m_entries.equal_range(hash);
+      for (auto it = begin; it not_eq end; ++it) {
+        if (Equal{}(it->second.component, component)) {
+          ++it->second.users;
+          return &it->second.component;
+        }
+      }
+      return &m_entries.emplace(hash, Entry{component, 1})->second.component;
+    }
+
+    void release(const T* shared) {
+      if (not shared) {
+        return;
+      }
+      auto [begin, end] = m_entries.equal_range(Hash{}(*shared));
+      for (auto it = begin; it not_eq end; ++it) {
+        if (&it->second.component == shared) {
+          if (--it->second.users == 0) {
+            m_entries.erase(it);
+          }
+          return;
+        }
+      }
+    }
+
+  private:
+    struct Entry {
+        T component;
+        uint32_t users{};
+    };
+
+    std::unordered_multimap<size_t, Entry> m_entries;
+};
+
+struct TextureHash {
+    size_t operator()(const engine::CTexture& cTexture) const;
+};
+
+struct MaterialHash {
+    size_t operator()(const engine::CMaterial& cMaterial) const;
+};
+
+// meshes without a CTexture are shared by their own textures only
+struct MeshTexturesHash {
+    size_t operator()(const engine::CMesh& cMesh) const;
+};
+
+struct MeshTexturesEqual {
+    bool operator()(const engine::CMesh& lhs, const engine::CMesh& rhs) const {
+      return lhs.textures == rhs.textures;
+    }
+};
+
+// the shared copies an entity is drawn with
+struct SharedMaterials {
+    engine::CTexture* texture{};
+    engine::CMaterial* material{};
+    // one per mesh of a CBody, the textures only without a CTexture
+    std::vector<engine::CMaterial*> bodyMaterials;
+    std::vector<engine::CMesh*> bodyTextures;
+};
+
+// shares the materials of an entity when its CTexture, CMaterial, CBody or
+// CUUID change, the signals only mark it and the sharing is done before the
+// next frame is drawn. Components changed in place must be patched to be seen
+class MaterialCache {
+  public:
+    MaterialCache() = default;
+    MaterialCache(const MaterialCache&) = delete;
+    MaterialCache& operator=(const MaterialCache&) = delete;
+
+    void connect(entt::registry& registry);
+    void update(entt::registry& registry);
+
+    const SharedMaterials& get(entt::entity e) const {
+      auto it = m_entities.find(e);
+      return it == m_entities.end() ? m_none : it->second;
+    }
+
+    // the animations move the atlas index every frame, atlases are shared
+    // by value when drawn instead
+    engine::CTextureAtlas* getAtlas(const engine::CTextureAtlas* cTextureAtlas);
+
+  private:
+    template <class Component> void watch(entt::registry& registry);
+    void onChanged(entt::registry& registry, entt::entity e);
+    void release(const SharedMaterials& shared);
+
+    SharedComponents<engine::CTexture, TextureHash> m_textures;
+    SharedComponents<engine::CMaterial, MaterialHash> m_materials;
+    SharedComponents<engine::CMesh, MeshTexturesHash, MeshTexturesEqual>
+      m_meshTextures;
+    std::unordered_map<uint64_t, engine::CTextureAtlas> m_atlases;
+    std::unordered_map<entt::entity, SharedMaterials> m_entities;
+    SharedMaterials m_none;
+    // systems on other threads can patch the components
+    std::mutex m_dirtyMutex;
+    std::unordered_set<entt::entity> m_dirty;
+    std::vector<entt::scoped_connection> m_connections;
+};
+
+// the camera as seen by the level of detail selection
+struct LODView {
+    glm::vec3 position{};
+    // projected size of one unit at distance one, 0 for orthographic
+    // cameras where the size does not depend on the distance
+    float projectionScale{};
+
+    // level of the mesh for its bounds in world space
+    uint32_t select(const engine::CMesh& mesh,
+                    const engine::AABB& worldBounds) const;
+};
+
+// components the render archetypes may have, their storages are looked up
+// once per frame and probed per entity instead of going through the registry.
+// Textures and materials come from the MaterialCache
+class OptionalComponents {
+  public:
+    explicit OptionalComponents(entt::registry& registry)
+      : m_storages{&registry.storage<engine::CTextureAtlas>(),
+                   &registry.storage<engine::CSkybox>(),
+                   &registry.storage<engine::CCollider>()} {}
+
+    template <typename Component> Component* get(entt::entity e) const {
+      auto& storage = *std::get<entt::storage_for_t<Component>*>(m_storages);
+      return storage.contains(e) ? &storage.get(e) : nullptr;
+    }
+
+  private:
+    std::tuple<entt::storage_for_t<engine::CTextureAtlas>*,
+               entt::storage_for_t<engine::CSkybox>*,
+               entt::storage_for_t<engine::CCollider>*>
+      m_storages;
+};
+
+// entities that do not move on their own, the ones without a kinematic rigid
+// body, and terrain chunks in a BVH. Groups of them outside the frustum are
+// skipped with one test instead of testing each of their meshes. The signals
+// of their components keep the items current, so static entities have to be
+// moved with patch or replace. Terrains count the changes of their chunks
+class StaticGeometry {
+  public:
+    enum class Visibility : uint8_t {
+      Untested, // not in the tree or without bounds
+      Culled,
+      Visible,
+    };
+
+    StaticGeometry() = default;
+    StaticGeometry(const StaticGeometry&) = delete;
+    StaticGeometry& operator=(const StaticGeometry&) = delete;
+
+    void connect(entt::registry& registry);
+    // refits the items of the entities and terrains that changed and
+    // rebuilds the tree when items were added or removed
+    void update(entt::registry& registry);
+    void cull(const engine::Frustum& frustum);
+
+    // the frustum test of the last cull for the entity or chunk
+    Visibility getVisibility(entt::entity e) const {
+      auto it = m_entityItems.find(e);
+      return it == m_entityItems.end() ? Visibility::Untested
+                                       : getVisibility(it->second);
+    }
+    Visibility getVisibility(const engine::CChunk& chunk) const {
+      auto it = m_chunkItems.find(&chunk);
+      return it == m_chunkItems.end() ? Visibility::Untested
+                                      : getVisibility(it->second);
+    }
+
+  private:
+    struct Item {
+        entt::entity entity{entt::null};
+        const engine::CChunk* chunk{}; // only for chunks
+    };
+
+    struct Terrain {
+        uint32_t version{};
+        uint32_t chunks{}; // items in the tree
+    };
+
+    template <class Component>
+    void watch(entt::registry& registry, bool updates);
+    void onChanged(entt::registry& registry, entt::entity e);
+    void resync(entt::registry& registry, entt::entity e);
+    void resyncChunks(entt::entity e, const engine::CChunkManager& manager,
+                      Terrain& terrain);
+    void rebuild(entt::registry& registry);
+    engine::AABB getBox(entt::registry& registry, const Item& item) const;
+    Visibility getVisibility(uint32_t item) const {
+      if (item >= m_visible.size() or not m_bvh.getBox(item).isValid()) {
+        return Visibility::Untested;
+      }
+      return m_visible[item] ? Visibility::Visible : Visibility::Culled;
+    }
+
+    engine::BVH m_bvh;
+    std::vector<Item> m_items; // by their index in the tree
+    std::unordered_map<entt::entity, uint32_t> m_entityItems;
+    std::unordered_map<const engine::CChunk*, uint32_t> m_chunkItems;
+    std::unordered_map<entt::entity, Terrain> m_terrains;
+    std::vector<uint8_t> m_visible;
+    bool m_rebuild{};
+    // systems on other threads can patch the components
+    std::mutex m_dirtyMutex;
+    std::unordered_set<entt::entity> m_dirty;
+    std::vector<entt::scoped_connection> m_connections;
+};
+
 class RenderSystem : public engine::systems::System {
   public:
     RenderSystem(int priority) : engine::systems::System(priority) {}
 
+    void init(entt::registry& registry) override final;
     void update(entt::registry& registry,
                 const engine::Time& ts) override final;
+    engine::systems::SystemAccess getAccess() const override final;
+
+  private:
+    MaterialCache m_materialCache;
+    StaticGeometry m_staticGeometry;
 };
 
 }
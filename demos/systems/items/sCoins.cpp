@@ -23,9 +23,13 @@ void CoinsSystem::init(entt::registry& registry) {
   entt::entity gamestate = registry.view<CCoins, engine::CUUID>().front();
   CCoins& coins_config = registry.get<CCoins>(gamestate);
 
+  std::vector<std::string> names;
+  names.reserve(coins_config.maxCoins);
   for (uint32_t i = 0; i < coins_config.maxCoins; i++) {
-    entt::entity coin_ =
-      scene_manager->createEntity("scene", "coin", "coin_" + std::to_string(i));
+    names.emplace_back("coin_" + std::to_string(i));
+  }
+  for (entt::entity coin_ :
+       scene_manager->createEntities("scene", "coin", std::move(names))) {
     registry.get<engine::CShaderProgram>(coin_).isVisible = false;
     registry.get<engine::CTransform>(coin_).position.x = 2.f;
   }
@@ -34,6 +38,14 @@ void CoinsSystem::init(entt::registry& registry) {
   render_manager->reorder();
 }
 
+engine::systems::SystemAccess CoinsSystem::getAccess() const {
+  // rand is not thread safe and the gamestate is looked up by name
+  return engine::systems::SystemAccess()
+    .read<engine::CTag, engine::CName, engine::CUUID, engine::CTime>()
+    .write<CCoins, engine::CShaderProgram, engine::CTransform>()
+    .onMainThread();
+}
+
 void CoinsSystem::update(entt::registry& registry, const engine::Time& ts) {
   if (engine::Application::Get().isGamePaused()) {
     return;
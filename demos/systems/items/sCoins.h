@@ -14,6 +14,7 @@ class CoinsSystem : public engine::systems::System {
     void init(entt::registry& registry) override final;
     void update(entt::registry& registry,
                 const engine::Time& ts) override final;
+    engine::systems::SystemAccess getAccess() const override final;
 };
 
 }
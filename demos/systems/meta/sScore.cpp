@@ -42,4 +42,9 @@ void ScoreSystem::init(entt::registry& registry) {
   app.getRenderManager()->reorder();
 }
 
+engine::systems::SystemAccess ScoreSystem::getAccess() const {
+  // the digits are set in init and by the events
+  return engine::systems::SystemAccess().none();
+}
+
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ class ScoreSystem : public engine::systems::System {
     ~ScoreSystem() override final;
 
     void init(entt::registry& registry) override final;
+    engine::systems::SystemAccess getAccess() const override final;
 };
 
 }
@@ -42,4 +42,9 @@ void TimerSystem::init(entt::registry& registry) {
   app.getRenderManager()->reorder();
 }
 
+engine::systems::SystemAccess TimerSystem::getAccess() const {
+  // the digits are set in init and by the events
+  return engine::systems::SystemAccess().none();
+}
+
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ class TimerSystem : public engine::systems::System {
     ~TimerSystem() override final;
 
     void init(entt::registry& registry) override final;
+    engine::systems::SystemAccess getAccess() const override final;
 };
 
 }
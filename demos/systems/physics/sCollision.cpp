@@ -1,7 +1,19 @@
 #include "systems/physics/sCollision.h"
 
+#include "components/meta/cScore.h"
+
 namespace demos::systems {
 
+engine::systems::SystemAccess CollisionSystem::getAccess() const {
+  // the events it triggers are handled right away, they write the score and
+  // show the game over overlay
+  return engine::systems::SystemAccess()
+    .read<engine::CCollider, engine::CTag, engine::CName, engine::CUUID>()
+    .write<engine::CTransform, engine::CShaderProgram, engine::CTextureAtlas,
+           CScore>()
+    .onMainThread();
+}
+
 void CollisionSystem::update(entt::registry& registry, const engine::Time& ts) {
   auto& app = engine::Application::Get();
   if (app.isGamePaused()) {
@@ -2,17 +2,23 @@
 
 namespace demos::systems {
 
+engine::systems::SystemAccess GravitySystem::getAccess() const {
+  return engine::systems::SystemAccess()
+    .read<engine::CRigidBody, engine::CGravity, engine::CUUID>()
+    .write<engine::CTransform>();
+}
+
 void GravitySystem::update(entt::registry& registry, const engine::Time& ts) {
   if (engine::Application::Get().isGamePaused()) {
     return;
   }
 
-  registry
-    .view<engine::CTransform, engine::CRigidBody, engine::CGravity,
-          engine::CUUID>()
-    .each([&](engine::CTransform& cTransform,
-              const engine::CRigidBody& cRigidBody,
-              const engine::CGravity& cGravity, const engine::CUUID& cUUID) {
+  // every entity only writes its own transform
+  engine::ParallelEach(
+    *engine::Application::Get().getThreadPool(),
+    engine::GravityGroup(registry),
+    [&](engine::CTransform& cTransform, const engine::CRigidBody& cRigidBody,
+        const engine::CGravity& cGravity, const engine::CUUID& cUUID) {
       if (cRigidBody.isKinematic) {
         cTransform.position.y -= cGravity.acceleration * ts;
       }
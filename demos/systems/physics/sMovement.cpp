@@ -4,6 +4,15 @@
 
 namespace demos::systems {
 
+engine::systems::SystemAccess MovementSystem::getAccess() const {
+  // the keys are polled from the window
+  return engine::systems::SystemAccess()
+    .read<engine::CRigidBody, engine::CActiveInput, engine::CInput,
+          engine::CActiveCamera, engine::CUUID>()
+    .write<engine::CTransform, engine::CCamera>()
+    .onMainThread();
+}
+
 void MovementSystem::update(entt::registry& registry, const engine::Time& ts) {
   auto& app = engine::Application::Get();
   if (app.isDebugging() or app.isGamePaused()) {
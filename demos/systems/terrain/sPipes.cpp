@@ -23,43 +23,34 @@ void PipesSystem::init(entt::registry& registry) {
   entt::entity gamestate = registry.view<CPipes, engine::CUUID>().front();
   CPipes& pipes_config = registry.get<CPipes>(gamestate);
 
-  entt::entity green_pipe_top =
-    scene_manager->createEntity("scene", "pipe", "green_pipe_top");
-  registry.get<engine::CTexture>(green_pipe_top)
-    .reloadTextures({
-      "green_pipe_top",
+  std::vector<std::string> names = {"green_pipe_top", "green_pipe_bottom",
+                                    "red_pipe_top", "red_pipe_bottom"};
+  std::vector<entt::entity> pipes =
+    scene_manager->createEntities("scene", "pipe", std::vector(names));
+  for (size_t i = 0; i < pipes.size(); ++i) {
+    // each pipe is named after its texture
+    registry.patch<engine::CTexture>(pipes[i], [&](engine::CTexture& c) {
+      c.reloadTextures({names[i]});
     });
-  registry.get<engine::CShaderProgram>(green_pipe_top).isVisible = false;
-  registry.get<engine::CTransform>(green_pipe_top).position.x = 2.f;
-  entt::entity green_pipe_bottom =
-    scene_manager->createEntity("scene", "pipe", "green_pipe_bottom");
-  registry.get<engine::CTexture>(green_pipe_bottom)
-    .reloadTextures({
-      "green_pipe_bottom",
-    });
-  registry.get<engine::CShaderProgram>(green_pipe_bottom).isVisible = false;
-  registry.get<engine::CTransform>(green_pipe_bottom).position.x = 2.f;
-  entt::entity red_pipe_top =
-    scene_manager->createEntity("scene", "pipe", "red_pipe_top");
-  registry.get<engine::CTexture>(red_pipe_top)
-    .reloadTextures({
-      "red_pipe_top",
-    });
-  registry.get<engine::CShaderProgram>(red_pipe_top).isVisible = false;
-  registry.get<engine::CTransform>(red_pipe_top).position.x = 2.f;
-  entt::entity red_pipe_bottom =
-    scene_manager->createEntity("scene", "pipe", "red_pipe_bottom");
-  registry.get<engine::CTexture>(red_pipe_bottom)
-    .reloadTextures({
-      "red_pipe_bottom",
-    });
-  registry.get<engine::CShaderProgram>(red_pipe_bottom).isVisible = false;
-  registry.get<engine::CTransform>(red_pipe_bottom).position.x = 2.f;
+    registry.get<engine::CShaderProgram>(pipes[i]).isVisible = false;
+    registry.patch<engine::CTransform>(
+      pipes[i], [](engine::CTransform& c) { c.position.x = 2.f; });
+  }
   pipes_config.pipes = pipes_config.maxPipes;
 
   render_manager->reorder();
 }
 
+engine::systems::SystemAccess PipesSystem::getAccess() const {
+  // rand is not thread safe and the gamestate is looked up by name. The
+  // pipes are moved in commit so the other movers can share the stage
+  return engine::systems::SystemAccess()
+    .read<engine::CTag, engine::CName, engine::CUUID, engine::CTime>()
+    .write<CPipes, engine::CShaderProgram>()
+    .defer<engine::CTransform>()
+    .onMainThread();
+}
+
 void PipesSystem::update(entt::registry& registry, const engine::Time& ts) {
   if (engine::Application::Get().isGamePaused()) {
     return;
@@ -75,18 +66,20 @@ void PipesSystem::update(entt::registry& registry, const engine::Time& ts) {
   registry
     .view<engine::CShaderProgram, engine::CTransform, engine::CTag,
           engine::CName, engine::CUUID>()
-    .each([&](engine::CShaderProgram& cShaderProgram,
-              engine::CTransform& cTransform, const engine::CTag& cTag,
+    .each([&](entt::entity pipe, engine::CShaderProgram& cShaderProgram,
+              const engine::CTransform& cTransform, const engine::CTag& cTag,
               const engine::CName& cName, const engine::CUUID& cUUID) {
       if (cTag.tag == "pipe") {
         if (cShaderProgram.isVisible) {
           float speed = 0.005f; // TODO move to component
 
           // move pipe
-          cTransform.position.x -= speed;
+          glm::vec3 position = cTransform.position;
+          position.x -= speed;
+          m_moves.emplace_back(pipe, position);
 
           // check if pipe is out of screen
-          if (cTransform.position.x < -2.f) {
+          if (position.x < -2.f) {
             cShaderProgram.isVisible = false;
           }
         } else {
@@ -96,18 +89,18 @@ void PipesSystem::update(entt::registry& registry, const engine::Time& ts) {
           if (pipes_config.pipes > 0 and cTime.currentSecond % 3 == 0 and
               delay == 0) {
             // randomize y position
+            glm::vec3 position = cTransform.position;
             if (cName.name.ends_with("top")) { //
               // -0.6 shortest -0.1 longest
-              cTransform.position.y =
-                -0.6f + static_cast<float>(rand()) /
-                          (static_cast<float>(RAND_MAX / 0.5f));
+              position.y = -0.6f + static_cast<float>(rand()) /
+                                     (static_cast<float>(RAND_MAX / 0.5f));
             } else if (cName.name.ends_with("bottom")) {
               // 1.2 shortest 0.7 longest
-              cTransform.position.y =
-                1.2f - static_cast<float>(rand()) /
-                         (static_cast<float>(RAND_MAX / 0.5f));
+              position.y = 1.2f - static_cast<float>(rand()) /
+                                    (static_cast<float>(RAND_MAX / 0.5f));
             }
-            cTransform.position.x = 2.f;
+            position.x = 2.f;
+            m_moves.emplace_back(pipe, position);
             cShaderProgram.isVisible = true;
             pipes_config.pipes--;
             delay += 30;
@@ -121,4 +114,13 @@ void PipesSystem::update(entt::registry& registry, const engine::Time& ts) {
       }
     });
 }
+
+void PipesSystem::commit(entt::registry& registry, const engine::Time& ts) {
+  // patched as pipes are static geometry for the render
+  for (const auto& [pipe, position] : m_moves) {
+    registry.patch<engine::CTransform>(
+      pipe, [&](engine::CTransform& c) { c.position = position; });
+  }
+  m_moves.clear();
+}
 }
\ No newline at end of file
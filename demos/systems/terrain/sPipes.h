@@ -14,6 +14,13 @@ class PipesSystem : public engine::systems::System {
     void init(entt::registry& registry) override final;
     void update(entt::registry& registry,
                 const engine::Time& ts) override final;
+    void commit(entt::registry& registry,
+                const engine::Time& ts) override final;
+    engine::systems::SystemAccess getAccess() const override final;
+
+  private:
+    // new positions of the pipes, found in update and applied in commit
+    std::vector<std::pair<entt::entity, glm::vec3>> m_moves;
 };
 
 }
@@ -21,13 +21,13 @@ glm::vec3 calculateTriangleNormal(glm::vec3 v1, glm::vec3 v2, glm::vec3 v3) {
 }
 
 glm::vec3 calculateQuadNormal(int col, int row,
-                              const std::vector<std::vector<float>>& heights) {
-  const float heightLeft = col > 0 ? heights[row][col - 1] : heights[row][col];
+                              const engine::Grid<float>& heights) {
+  const float heightLeft = col > 0 ? heights(row, col - 1) : heights(row, col);
   const float heightRight =
-    col < heights[row].size() - 1 ? heights[row][col + 1] : heights[row][col];
-  const float heightDown = row > 0 ? heights[row - 1][col] : heights[row][col];
+    col < heights.getCols() - 1 ? heights(row, col + 1) : heights(row, col);
+  const float heightDown = row > 0 ? heights(row - 1, col) : heights(row, col);
   const float heightUp =
-    row < heights.size() - 1 ? heights[row + 1][col] : heights[row][col];
+    row < heights.getRows() - 1 ? heights(row + 1, col) : heights(row, col);
 
   return glm::normalize(
     glm::vec3(heightLeft - heightRight, 2.f, heightDown - heightUp));
@@ -51,11 +51,22 @@ glm::vec3 calculateBiomeColor(float height, uint32_t amplitude) {
   }
 }
 
+glm::vec3 calculateAtlasOffset(int index,
+                               const engine::CTextureAtlas& cTextureAtlas) {
+  int rows = cTextureAtlas.rows;
+  uint32_t col = index % rows;
+  float coll = static_cast<float>(col) / rows;
+  uint32_t row = index / rows;
+  float roww = static_cast<float>(row) / rows;
+
+  return {static_cast<float>(coll) / rows, static_cast<float>(roww) / rows,
+          0.f};
+}
+
 glm::vec3 calculateBiomeTexture(float height, uint32_t amplitude,
                                 const engine::CTextureAtlas& cTextureAtlas) {
   height = (height + amplitude) / (2 * amplitude);
 
-  int rows = cTextureAtlas.rows;
   int index = 5; // default
 
   if (height < 0.2f) { // TODO constants
@@ -72,73 +83,46 @@ glm::vec3 calculateBiomeTexture(float height, uint32_t amplitude,
     index = 6; // snow
   }
 
-  uint32_t col = index % rows;
-  float coll = static_cast<float>(col) / rows;
-  uint32_t row = index / rows;
-  float roww = static_cast<float>(row) / rows;
-
-  return {static_cast<float>(coll) / rows, static_cast<float>(roww) / rows,
-          0.f};
+  return calculateAtlasOffset(index, cTextureAtlas);
 }
 
-std::vector<std::vector<float>> generateHeights(uint32_t chunkSize,
-                                                const engine::CNoise& noise,
-                                                int xOffset, int zOffset) {
-  std::vector<std::vector<float>> heights; // z = row, x = col
-  heights.reserve(chunkSize + 1);
-  for (int row = 0; row < chunkSize + 1; ++row) {
-    heights.emplace_back(std::vector<float>());
-    heights[row].reserve(chunkSize + 1);
-    for (int col = 0; col < chunkSize + 1; ++col) {
-      heights[row].emplace_back(noise.getNoise(
-        static_cast<float>(col + xOffset), static_cast<float>(row + zOffset)));
-    }
-  }
+engine::Grid<float> generateHeights(uint32_t chunkSize,
+                                    const engine::CNoise& noise, int xOffset,
+                                    int zOffset) {
+  engine::Grid<float> heights(chunkSize + 1, chunkSize + 1); // z = row, x = col
+  noise.getNoise(heights, xOffset, zOffset);
 
   return heights;
 }
 
-std::vector<std::vector<glm::vec3>>
-generateBiomes(std::vector<std::vector<float>> heights, uint32_t amplitude) {
-  std::vector<std::vector<glm::vec3>> biomes; // z = row, x = col
-  biomes.reserve(heights.size());
-  for (uint32_t row = 0; row < heights.size(); ++row) {
-    biomes.emplace_back(std::vector<glm::vec3>());
-    biomes[row].reserve(heights[row].size());
-    for (uint32_t col = 0; col < heights[row].size(); ++col) {
-      biomes[row].emplace_back(
-        calculateBiomeColor(heights[row][col], amplitude));
-    }
+engine::Grid<glm::vec3> generateBiomes(const engine::Grid<float>& heights,
+                                       uint32_t amplitude) {
+  engine::Grid<glm::vec3> biomes(heights.getRows(), heights.getCols());
+  for (size_t i = 0; i < heights.size(); ++i) {
+    biomes.data()[i] = calculateBiomeColor(heights.data()[i], amplitude);
   }
 
   return biomes;
 }
 
-std::vector<std::vector<glm::vec3>>
-generateBiomesTextures(std::vector<std::vector<float>> heights,
-                       uint32_t amplitude,
+engine::Grid<glm::vec3>
+generateBiomesTextures(const engine::Grid<float>& heights, uint32_t amplitude,
                        const engine::CTextureAtlas& cTextureAtlas) {
-  std::vector<std::vector<glm::vec3>> textures; // z = row, x = col
-  textures.reserve(heights.size());
-  for (uint32_t row = 0; row < heights.size(); ++row) {
-    textures.emplace_back(std::vector<glm::vec3>());
-    textures[row].reserve(heights[row].size());
-    for (uint32_t col = 0; col < heights[row].size(); ++col) {
-      textures[row].emplace_back(
-        calculateBiomeTexture(heights[row][col], amplitude, cTextureAtlas));
-    }
+  engine::Grid<glm::vec3> textures(heights.getRows(), heights.getCols());
+  for (size_t i = 0; i < heights.size(); ++i) {
+    textures.data()[i] =
+      calculateBiomeTexture(heights.data()[i], amplitude, cTextureAtlas);
   }
 
   return textures;
 }
 
-engine::CMesh generateTriangleMesh(
+ChunkMeshData generateTriangleMesh(
   uint32_t chunkSize, uint32_t blockSize,
-  const std::vector<std::vector<float>>& heights,
+  const engine::Grid<float>& heights,
   const std::optional<
-    std::reference_wrapper<std::vector<std::vector<glm::vec3>>>>
+    std::reference_wrapper<engine::Grid<glm::vec3>>>
     biomes = std::nullopt) {
-  engine::CMesh mesh;
   uint32_t totalVertices =
     (chunkSize + 1) *
     (chunkSize + 1); // Triangles share vertices making impossible to use more
@@ -155,7 +139,7 @@ engine::CMesh generateTriangleMesh(
   for (uint32_t row = 0; row < chunkSize + 1; ++row) {
     for (uint32_t col = 0; col < chunkSize + 1; ++col) {
       float x = static_cast<float>(col) * blockSize;
-      float y = heights[row][col] * blockSize;
+      float y = heights(row, col) * blockSize;
       float z = static_cast<float>(row) * blockSize;
 
       glm::vec3 position(x, y, z);
@@ -165,7 +149,7 @@ engine::CMesh generateTriangleMesh(
       glm::vec2 textureCoords{};
       glm::vec3 color{};
       if (biomes.has_value()) { // color per vertex
-        color = biomes.value().get()[row][col];
+        color = biomes.value().get()(row, col);
       } else { // one texture for all the mesh
         textureCoords = {static_cast<float>(col) / chunkSize,
                          static_cast<float>(row) / chunkSize};
@@ -191,10 +175,7 @@ engine::CMesh generateTriangleMesh(
     }
   }
 
-  mesh.vertexType = "terrain";
-  mesh.vbo = engine::VBO::CreateTerrain(vertices);
-  mesh.indices = std::move(indices);
-  return mesh;
+  return {std::move(vertices), std::move(indices)};
 }
 
 void addQuadVertexData(std::vector<engine::TerrainVertex>& vertices,
@@ -248,20 +229,20 @@ void addTriangleVertexData(std::vector<engine::TerrainVertex>& vertices,
 
 std::array<glm::vec3, 4>
 calculateQuadPositions(uint32_t col, uint32_t row,
-                       const std::vector<std::vector<float>>& heights,
+                       const engine::Grid<float>& heights,
                        uint32_t blockSize) {
   std::array<glm::vec3, 4> positions;
   positions[0] = {static_cast<float>(col) * blockSize,
-                  heights[row][col] * blockSize,
+                  heights(row, col) * blockSize,
                   static_cast<float>(row) * blockSize}; // top left
   positions[1] = {static_cast<float>(col) * blockSize,
-                  heights[row + 1][col] * blockSize,
+                  heights(row + 1, col) * blockSize,
                   static_cast<float>(row + 1) * blockSize}; // bottom left
   positions[2] = {static_cast<float>(col + 1) * blockSize,
-                  heights[row][col + 1] * blockSize,
+                  heights(row, col + 1) * blockSize,
                   static_cast<float>(row) * blockSize}; // top right
   positions[3] = {static_cast<float>(col + 1) * blockSize,
-                  heights[row + 1][col + 1] * blockSize,
+                  heights(row + 1, col + 1) * blockSize,
                   static_cast<float>(row + 1) * blockSize}; // bottom right
 
   return positions;
@@ -269,26 +250,26 @@ calculateQuadPositions(uint32_t col, uint32_t row,
 
 std::array<glm::vec3, 4>
 calculateBiomeColors(uint32_t col, uint32_t row,
-                     const std::vector<std::vector<glm::vec3>>& biomes) {
+                     const engine::Grid<glm::vec3>& biomes) {
   std::array<glm::vec3, 4> colors;
-  colors[0] = biomes[row][col];         // top left
-  colors[1] = biomes[row + 1][col];     // bottom left
-  colors[2] = biomes[row][col + 1];     // top right
-  colors[3] = biomes[row + 1][col + 1]; // bottom right
+  colors[0] = biomes(row, col);         // top left
+  colors[1] = biomes(row + 1, col);     // bottom left
+  colors[2] = biomes(row, col + 1);     // top right
+  colors[3] = biomes(row + 1, col + 1); // bottom right
 
   return colors;
 }
 
 std::array<glm::vec2, 4>
 calculateBiomeTextures(uint32_t col, uint32_t row,
-                       const std::vector<std::vector<glm::vec3>>& biomes) {
+                       const engine::Grid<glm::vec3>& biomes) {
   std::array<glm::vec2, 4>
     textureCoordinates; // TODO Do i need to multiply by blocksize?
   // TODO this is the offset I still need the texture coordinates
-  textureCoordinates[0] = glm::vec2(biomes[row][col]);         // top left
-  textureCoordinates[1] = glm::vec2(biomes[row + 1][col]);     // bottom left
-  textureCoordinates[2] = glm::vec2(biomes[row][col + 1]);     // top right
-  textureCoordinates[3] = glm::vec2(biomes[row + 1][col + 1]); // bottom right
+  textureCoordinates[0] = glm::vec2(biomes(row, col));         // top left
+  textureCoordinates[1] = glm::vec2(biomes(row + 1, col));     // bottom left
+  textureCoordinates[2] = glm::vec2(biomes(row, col + 1));     // top right
+  textureCoordinates[3] = glm::vec2(biomes(row + 1, col + 1)); // bottom right
 
   return textureCoordinates;
 }
@@ -297,9 +278,9 @@ void addQuad(std::vector<engine::TerrainVertex>& vertices,
              std::vector<uint32_t>& indices, uint32_t col, uint32_t row,
              uint32_t chunkSize, uint32_t blockSize, bool duplicateVertices,
              engine::CTexture::DrawMode drawMode,
-             const std::vector<std::vector<float>>& heights,
+             const engine::Grid<float>& heights,
              const std::optional<
-               std::reference_wrapper<std::vector<std::vector<glm::vec3>>>>
+               std::reference_wrapper<engine::Grid<glm::vec3>>>
                biomes = std::nullopt) {
   std::array<glm::vec3, 4> positions =
     calculateQuadPositions(col, row, heights, blockSize);
@@ -332,14 +313,13 @@ void addQuad(std::vector<engine::TerrainVertex>& vertices,
   }
 }
 
-engine::CMesh
+ChunkMeshData
 generateQuadMesh(uint32_t chunkSize, uint32_t blockSize, bool duplicateVertices,
                  engine::CTexture::DrawMode drawMode,
-                 const std::vector<std::vector<float>>& heights,
+                 const engine::Grid<float>& heights,
                  const std::optional<
-                   std::reference_wrapper<std::vector<std::vector<glm::vec3>>>>
+                   std::reference_wrapper<engine::Grid<glm::vec3>>>
                    biomes = std::nullopt) {
-  engine::CMesh mesh;
   uint32_t totalVertices =
     chunkSize * chunkSize * 4; // 4 vertices per quad, triangles share vertices
   if (duplicateVertices) {
@@ -368,20 +348,17 @@ generateQuadMesh(uint32_t chunkSize, uint32_t blockSize, bool duplicateVertices,
     }
   }
 
-  mesh.vertexType = "terrain";
-  mesh.vbo = engine::VBO::CreateTerrain(vertices);
-  mesh.indices = std::move(indices);
-  return mesh;
+  return {std::move(vertices), std::move(indices)};
 }
 
-engine::CMesh
+ChunkMeshData
 generateTerrain(engine::CChunkManager::MeshType meshType,
                 engine::CChunkManager::MeshAlgorithm meshAlgorithm,
                 uint32_t chunkSize, uint32_t blockSize,
                 engine::CTexture::DrawMode drawMode,
-                const std::vector<std::vector<float>>& heights,
+                const engine::Grid<float>& heights,
                 const std::optional<
-                  std::reference_wrapper<std::vector<std::vector<glm::vec3>>>>
+                  std::reference_wrapper<engine::Grid<glm::vec3>>>
                   biomes = std::nullopt) {
   if (meshType == engine::CChunkManager::MeshType::Plane) {
     if (meshAlgorithm ==
@@ -414,15 +391,370 @@ generateTerrain(engine::CChunkManager::MeshType meshType,
       }
     }
   } else if (meshType == engine::CChunkManager::MeshType::Chunk) {
-    if (meshAlgorithm == engine::CChunkManager::MeshAlgorithm::Greedy) {
-      // return generateChunkMesh(chunkSize, blockSize, heights);
-    }
+    ENGINE_ASSERT(false, "Voxel chunks are meshed from their blocks, see "
+                         "generateVoxelChunk");
   } else if (meshType == engine::CChunkManager::MeshType::Sphere) {
     // return generateSphereMesh(chunkSize, blockSize, heights);
   } else {
     ENGINE_ERROR("Mesh type {} not supported", static_cast<int>(meshType));
   }
-  return engine::CMesh{};
+  return ChunkMeshData{};
+}
+
+engine::CBlock::Type calculateBlockType(float height, int depth) {
+  engine::CBlock::Type surface;
+  if (height < 0.2f) {
+    surface = engine::CBlock::Type::Water;
+  } else if (height < 0.3f) {
+    surface = engine::CBlock::Type::Sand;
+  } else if (height < 0.6f) {
+    surface = engine::CBlock::Type::Grass;
+  } else if (height < 0.8f) {
+    surface = engine::CBlock::Type::Dirt;
+  } else if (height < 0.9f) {
+    surface = engine::CBlock::Type::Stone;
+  } else {
+    surface = engine::CBlock::Type::Snow;
+  }
+
+  if (depth == 0) {
+    return surface;
+  } else if (depth < 3) {
+    return surface == engine::CBlock::Type::Water or
+               surface == engine::CBlock::Type::Sand
+             ? engine::CBlock::Type::Sand
+             : engine::CBlock::Type::Dirt;
+  }
+  return engine::CBlock::Type::Stone;
+}
+
+glm::vec3 calculateBlockColor(engine::CBlock::Type type) {
+  switch (type) {
+  case engine::CBlock::Type::Water: return LIGHT_BLUE;
+  case engine::CBlock::Type::Sand: return LIGHT_YELLOW;
+  case engine::CBlock::Type::Grass: return LIGHT_GREEN;
+  case engine::CBlock::Type::Dirt: return DARK_GREEN;
+  case engine::CBlock::Type::Snow: return WHITE;
+  default: return LIGHT_GREY;
+  }
+}
+
+int calculateBlockTextureIndex(engine::CBlock::Type type) {
+  switch (type) {
+  case engine::CBlock::Type::Water: return 4;
+  case engine::CBlock::Type::Sand: return 3;
+  case engine::CBlock::Type::Grass: return 2;
+  case engine::CBlock::Type::Dirt: return 1;
+  case engine::CBlock::Type::Stone: return 8;
+  case engine::CBlock::Type::Snow: return 6;
+  default: return 5;
+  }
+}
+
+VoxelVolume generateVoxels(const ChunkSettings& settings, glm::ivec3 coords) {
+  int size = static_cast<int>(settings.chunkSize);
+  uint32_t amplitude = settings.noise.amplitude;
+
+  // one extra column on every side for the neighbour border
+  engine::Grid<float> heights(size + 2, size + 2); // z = row, x = col
+  settings.noise.getNoise(heights, coords.x * size - 1, coords.z * size - 1);
+
+  VoxelVolume volume(size);
+  for (int row = 0; row < size + 2; ++row) {
+    for (int col = 0; col < size + 2; ++col) {
+      float height = (heights(row, col) + amplitude) / (2 * amplitude);
+      int surface =
+        std::clamp(static_cast<int>(height * size), 1, size); // blocks
+      for (int y = 0; y < size; ++y) {
+        volume.set(col - 1, y, row - 1,
+                   y < surface ? calculateBlockType(height, surface - 1 - y)
+                               : engine::CBlock::Type::Air);
+      }
+    }
+  }
+
+  return volume;
+}
+
+void addGreedyQuad(ChunkMeshData& data, glm::vec3 origin, glm::vec3 du,
+                   glm::vec3 dv, glm::vec3 normal, bool frontFace,
+                   engine::CBlock::Type type, float width, float height,
+                   engine::CTexture::DrawMode drawMode,
+                   const engine::CTextureAtlas& cTextureAtlas) {
+  std::array<glm::vec2, 4> textureCoordinates{
+    glm::vec2{0.f, 0.f}, glm::vec2{width, 0.f}, glm::vec2{width, height},
+    glm::vec2{0.f, height}}; // repeats the texture once per block
+  glm::vec3 color{};
+  if (drawMode == engine::CTexture::DrawMode::COLOR) {
+    color = calculateBlockColor(type);
+  } else if (drawMode == engine::CTexture::DrawMode::TEXTURE_ATLAS or
+             drawMode == engine::CTexture::DrawMode::TEXTURE_ATLAS_BLEND or
+             drawMode ==
+               engine::CTexture::DrawMode::TEXTURE_ATLAS_BLEND_COLOR) {
+    textureCoordinates.fill(glm::vec2(calculateAtlasOffset(
+      calculateBlockTextureIndex(type), cTextureAtlas)));
+    color = calculateBlockColor(type);
+  }
+
+  uint32_t first = data.vertices.size();
+  data.vertices.push_back({origin, normal, textureCoordinates[0], color});
+  data.vertices.push_back({origin + du, normal, textureCoordinates[1], color});
+  data.vertices.push_back(
+    {origin + du + dv, normal, textureCoordinates[2], color});
+  data.vertices.push_back({origin + dv, normal, textureCoordinates[3], color});
+
+  // du x dv points along the normal for front faces, counter clockwise
+  if (frontFace) {
+    data.indices.insert(data.indices.end(), {first, first + 1, first + 2,
+                                             first, first + 2, first + 3});
+  } else {
+    data.indices.insert(data.indices.end(), {first, first + 2, first + 1,
+                                             first, first + 3, first + 2});
+  }
+}
+
+// https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
+// sweeps every axis one slice at a time, building a mask of the visible faces
+// between two layers and merging equal neighbours into maximal rectangles
+ChunkMeshData generateChunkMesh(const VoxelVolume& volume, uint32_t blockSize,
+                                engine::CTexture::DrawMode drawMode,
+                                const engine::CTextureAtlas& cTextureAtlas,
+                                bool merge) {
+  int size = volume.getSize();
+  ChunkMeshData data;
+  // 0 no face, +type face looking to +axis, -type face looking to -axis
+  std::vector<int> mask(size * size);
+
+  for (int d = 0; d < 3; ++d) {
+    int u = (d + 1) % 3; // u x v = d so front faces wind counter clockwise
+    int v = (d + 2) % 3;
+    glm::ivec3 x{};
+    glm::ivec3 q{};
+    q[d] = 1;
+
+    for (x[d] = -1; x[d] < size; ++x[d]) {
+      // faces between layer x[d] and x[d] + 1, the ones owned by blocks
+      // outside the chunk are left to the neighbour
+      int n = 0;
+      for (x[v] = 0; x[v] < size; ++x[v]) {
+        for (x[u] = 0; x[u] < size; ++x[u], ++n) {
+          engine::CBlock::Type a = volume.get(x.x, x.y, x.z);
+          engine::CBlock::Type b = volume.get(x.x + q.x, x.y + q.y, x.z + q.z);
+          bool solidA = a not_eq engine::CBlock::Type::Air;
+          bool solidB = b not_eq engine::CBlock::Type::Air;
+          mask[n] = 0;
+          if (solidA and not solidB and x[d] >= 0) {
+            mask[n] = static_cast<int>(a);
+          } else if (solidB and not solidA and x[d] + 1 < size) {
+            mask[n] = -static_cast<int>(b);
+          }
+          if (mask[n] not_eq 0) {
+            ++data.visibleFaces;
+          }
+        }
+      }
+
+      n = 0;
+      for (int j = 0; j < size; ++j) {
+        for (int i = 0; i < size;) {
+          int face = mask[n];
+          if (face == 0) {
+            ++i;
+            ++n;
+            continue;
+          }
+
+          int width = 1;
+          while (merge and i + width < size and mask[n + width] == face) {
+            ++width;
+          }
+          int height = 1;
+          for (; merge and j + height < size; ++height) {
+            bool fullRow = true;
+            for (int k = 0; k < width; ++k) {
+              if (mask[n + k + height * size] not_eq face) {
+                fullRow = false;
+                break;
+              }
+            }
+            if (not fullRow) {
+              break;
+            }
+          }
+
+          glm::vec3 origin{};
+          origin[d] = static_cast<float>(x[d] + 1);
+          origin[u] = static_cast<float>(i);
+          origin[v] = static_cast<float>(j);
+          glm::vec3 du{};
+          du[u] = static_cast<float>(width);
+          glm::vec3 dv{};
+          dv[v] = static_cast<float>(height);
+          glm::vec3 normal{};
+          normal[d] = face > 0 ? 1.f : -1.f;
+          addGreedyQuad(data, origin * static_cast<float>(blockSize),
+                        du * static_cast<float>(blockSize),
+                        dv * static_cast<float>(blockSize), normal, face > 0,
+                        static_cast<engine::CBlock::Type>(std::abs(face)),
+                        static_cast<float>(width), static_cast<float>(height),
+                        drawMode, cTextureAtlas);
+
+          for (int l = 0; l < height; ++l) {
+            for (int k = 0; k < width; ++k) {
+              mask[n + k + l * size] = 0;
+            }
+          }
+          i += width;
+          n += width;
+        }
+      }
+    }
+  }
+
+  return data;
+}
+
+ChunkMeshData generateVoxelChunk(const ChunkSettings& settings,
+                                 glm::ivec3 coords) {
+  ENGINE_ASSERT(settings.meshAlgorithm ==
+                  engine::CChunkManager::MeshAlgorithm::Greedy,
+                "Mesh algorithm {} not supported for voxel chunks",
+                static_cast<int>(settings.meshAlgorithm));
+  VoxelVolume volume = generateVoxels(settings, coords);
+  ChunkMeshData data = generateChunkMesh(volume, settings.blockSize,
+                                         settings.drawMode,
+                                         settings.textureAtlas);
+  data.blocks = volume.getBlocks();
+  return data;
+}
+
+// blocks of a loaded chunk with the borders of its neighbours, taken from the
+// loaded or edited ones and from the noise for the rest like when generated
+VoxelVolume gatherVoxels(const ChunkSettings& settings,
+                         const engine::CChunkManager& cChunkManager,
+                         glm::ivec3 coords) {
+  VoxelVolume volume = generateVoxels(settings, coords);
+  int size = volume.getSize();
+  const auto& blocks = cChunkManager.chunks.at(coords).blocks;
+  for (int y = 0; y < size; ++y) {
+    for (int z = 0; z < size; ++z) {
+      for (int x = 0; x < size; ++x) {
+        volume.set(x, y, z, blocks.get(x, y, z));
+      }
+    }
+  }
+
+  for (glm::ivec3 offset : {glm::ivec3{-1, 0, 0}, glm::ivec3{1, 0, 0},
+                            glm::ivec3{0, 0, -1}, glm::ivec3{0, 0, 1}}) {
+    const auto* neighbourBlocks = cChunkManager.findBlocks(coords + offset);
+    if (not neighbourBlocks) {
+      continue;
+    }
+    for (int y = 0; y < size; ++y) {
+      for (int i = 0; i < size; ++i) {
+        // one block past the border, in this chunk and in the neighbour
+        glm::ivec3 position =
+          offset.x not_eq 0 ? glm::ivec3{offset.x < 0 ? -1 : size, y, i}
+                            : glm::ivec3{i, y, offset.z < 0 ? -1 : size};
+        glm::ivec3 local = position - offset * size;
+        volume.set(position.x, position.y, position.z,
+                   neighbourBlocks->get(local.x, local.y, local.z));
+      }
+    }
+  }
+
+  return volume;
+}
+
+// runs on a worker thread, it must not create any GL object
+ChunkMeshData generateChunk(const ChunkSettings& settings, glm::ivec3 coords) {
+  if (settings.meshType == engine::CChunkManager::MeshType::Chunk) {
+    return generateVoxelChunk(settings, coords);
+  }
+
+  // noise is sampled in grid units so neighbour chunks share their borders
+  engine::Grid<float> heights =
+    generateHeights(settings.chunkSize, settings.noise,
+                    coords.x * static_cast<int>(settings.chunkSize),
+                    coords.z * static_cast<int>(settings.chunkSize));
+  if (not settings.useBiomes) {
+    return generateTerrain(settings.meshType, settings.meshAlgorithm,
+                           settings.chunkSize, settings.blockSize,
+                           settings.drawMode, heights);
+  }
+
+  engine::Grid<glm::vec3> biomes;
+  if (settings.drawMode == engine::CTexture::DrawMode::COLOR) {
+    biomes = generateBiomes(heights, settings.noise.amplitude);
+  } else if (settings.drawMode == engine::CTexture::DrawMode::TEXTURE_ATLAS or
+             settings.drawMode ==
+               engine::CTexture::DrawMode::TEXTURE_ATLAS_BLEND or
+             settings.drawMode ==
+               engine::CTexture::DrawMode::TEXTURE_ATLAS_BLEND_COLOR) {
+    biomes = generateBiomesTextures(heights, settings.noise.amplitude,
+                                    settings.textureAtlas);
+  }
+  return generateTerrain(settings.meshType, settings.meshAlgorithm,
+                         settings.chunkSize, settings.blockSize,
+                         settings.drawMode, heights, biomes);
+}
+
+engine::AABB getBounds(const std::vector<engine::TerrainVertex>& vertices) {
+  engine::AABB bounds;
+  for (const engine::TerrainVertex& vertex : vertices) {
+    bounds.expand(vertex.position);
+  }
+  return bounds;
+}
+
+// runs on the main thread, owner of the GL context
+engine::CMesh uploadChunkMesh(ChunkMeshData&& data) {
+  engine::CMesh mesh;
+  if (data.vertices.empty()) {
+    return mesh;
+  }
+  mesh.bounds = getBounds(data.vertices);
+  mesh.indices = std::move(data.indices);
+  mesh.setupTerrainMesh(data.vertices);
+  return mesh;
+}
+
+// keeps the ranges of a chunk already in the geometry pool, edits rarely
+// grow a chunk past them so they are rewritten in place
+void updateChunkMesh(engine::CMesh& mesh, ChunkMeshData&& data) {
+  if (data.vertices.empty() or not mesh.geometry) {
+    mesh = uploadChunkMesh(std::move(data));
+    return;
+  }
+  mesh.bounds = getBounds(data.vertices);
+  mesh.indices = std::move(data.indices);
+  mesh.updateTerrainMesh(data.vertices);
+}
+
+// a chunk generated again after the cache evicted it gets its edits back, and
+// it is re-meshed when it or a neighbour was edited since the noise is stale
+void restoreEdits(engine::CChunkManager& cChunkManager, glm::ivec3 coords,
+                  engine::CChunk& chunk) {
+  if (auto edited = cChunkManager.editedChunks.find(coords);
+      edited not_eq cChunkManager.editedChunks.end()) {
+    chunk.blocks = edited->second;
+  }
+  if (cChunkManager.hasEditsAround(coords)) {
+    cChunkManager.markDirty(coords);
+  }
+}
+
+int getRingDistance(glm::ivec3 lhs, glm::ivec3 rhs) {
+  return std::max(std::abs(lhs.x - rhs.x), std::abs(lhs.z - rhs.z));
+}
+
+engine::CChunk createChunk(const engine::CChunkManager& cChunkManager,
+                           glm::ivec3 coords, ChunkMeshData&& data) {
+  engine::CChunk chunk{"plains"};
+  chunk.blocks = std::move(data.blocks);
+  chunk.terrainMesh = uploadChunkMesh(std::move(data));
+  chunk.transform.position = cChunkManager.getChunkPosition(coords);
+  return chunk;
 }
 
 void TerrainSystem::init(entt::registry& registry) {
@@ -443,64 +775,237 @@ void TerrainSystem::init(entt::registry& registry) {
                       cUUID.uuid);
       }
 
+      auto settings = std::make_shared<const ChunkSettings>(ChunkSettings{
+        cChunkManager.chunkSize, cChunkManager.blockSize,
+        cChunkManager.meshType, cChunkManager.meshAlgorithm,
+        cChunkManager.useBiomes, cTexture.drawMode, cNoise,
+        cTextureAtlas ? *cTextureAtlas : engine::CTextureAtlas{}});
+      m_settings[e] = settings;
+
+      if (cChunkManager.streaming) {
+        ENGINE_ASSERT(cChunkManager.unloadRadius >= cChunkManager.loadRadius,
+                      "Chunk unload radius {} is smaller than load radius {}",
+                      cChunkManager.unloadRadius, cChunkManager.loadRadius);
+        // chunks are streamed in around the camera from update
+        m_streams.try_emplace(e);
+        return;
+      }
+
       // Create chunks around 0 0 0
       // TODO y axis should infinite, maybe rename z to depth
-      // TODO fix this, it's not working heights is always the same maybe is
-      // something with int and uint32_t?
-      std::vector<std::vector<float>> heights;
-      std::vector<std::vector<glm::vec3>> biomes;
-      engine::CChunk chunk;
+      engine::Timer timer;
+      const auto& thread_pool = engine::Application::Get().getThreadPool();
+      std::vector<std::pair<glm::ivec3, std::future<ChunkMeshData>>> jobs;
+      jobs.reserve((2 * cChunkManager.width + 1) *
+                   (2 * cChunkManager.height + 1));
       for (int row = -cChunkManager.width; row <= cChunkManager.width; ++row) {
         for (int col = -cChunkManager.height; col <= cChunkManager.height;
              ++col) {
-          chunk = engine::CChunk{"plains"};
-          heights = generateHeights(cChunkManager.chunkSize, cNoise, col, row);
-          if (cChunkManager.useBiomes) {
-            if (cTexture.drawMode == engine::CTexture::DrawMode::COLOR) {
-              biomes = generateBiomes(heights, cNoise.amplitude);
-            } else if (cTexture.drawMode ==
-                         engine::CTexture::DrawMode::TEXTURE_ATLAS or
-                       cTexture.drawMode ==
-                         engine::CTexture::DrawMode::TEXTURE_ATLAS_BLEND or
-                       cTexture.drawMode == engine::CTexture::DrawMode::
-                                              TEXTURE_ATLAS_BLEND_COLOR) {
-              biomes = generateBiomesTextures(heights, cNoise.amplitude,
-                                              *cTextureAtlas);
-            }
-            chunk.terrainMesh = std::move(generateTerrain(
-              cChunkManager.meshType, cChunkManager.meshAlgorithm,
-              cChunkManager.chunkSize, cChunkManager.blockSize,
-              cTexture.drawMode, heights, biomes));
-          } else {
-            chunk.terrainMesh = std::move(generateTerrain(
-              cChunkManager.meshType, cChunkManager.meshAlgorithm,
-              cChunkManager.chunkSize, cChunkManager.blockSize,
-              cTexture.drawMode, heights));
-          }
-          chunk.transform.position =
-            glm::vec3{static_cast<float>(col) * cChunkManager.chunkSize *
-                        cChunkManager.blockSize,
-                      0.f,
-                      static_cast<float>(row) * cChunkManager.chunkSize *
-                        cChunkManager.blockSize};
-          cChunkManager.chunks.emplace(
-            glm::vec3{static_cast<float>(col) * cChunkManager.chunkSize *
-                        cChunkManager.blockSize,
-                      0.f,
-                      static_cast<float>(row) * cChunkManager.chunkSize *
-                        cChunkManager.blockSize},
-            std::move(chunk)); // TODO check if this work with blocksize
+          glm::ivec3 coords{col, 0, row};
+          jobs.emplace_back(coords, thread_pool->submit([settings, coords]() {
+            return generateChunk(*settings, coords);
+          }));
         }
       }
+
+      uint32_t visibleFaces = 0;
+      uint32_t quads = 0;
+      for (auto& [coords, job] : jobs) {
+        ChunkMeshData data = job.get();
+        visibleFaces += data.visibleFaces;
+        quads += data.indices.size() / 6;
+        // TODO check if this work with blocksize
+        auto [chunk, _] = cChunkManager.chunks.emplace(
+          coords, createChunk(cChunkManager, coords, std::move(data)));
+        cChunkManager.onChunkLoaded(chunk->second);
+      }
+
+      float elapsed = timer.getSeconds();
+      APP_INFO("Generated {} chunks of size {} ({}x{}) on {} threads in {:.3f} "
+               "ms, {:.1f} chunks/s",
+               jobs.size(), cChunkManager.chunkSize,
+               2 * cChunkManager.width + 1, 2 * cChunkManager.height + 1,
+               thread_pool->getThreadCount(), elapsed * 1000.f,
+               elapsed > 0.f ? jobs.size() / elapsed : 0.f);
+      if (cChunkManager.meshType == engine::CChunkManager::MeshType::Chunk) {
+        // a per face mesher would emit one quad per visible face
+        APP_INFO("Greedy meshing merged {} visible faces into {} quads, {} "
+                 "triangles instead of {}",
+                 visibleFaces, quads, quads * 2, visibleFaces * 2);
+      }
     });
 }
 
+void TerrainSystem::stream(entt::entity e,
+                           engine::CChunkManager& cChunkManager,
+                           glm::vec3 cameraPosition) {
+  ChunkStream& chunkStream = m_streams.at(e);
+  glm::ivec3 center = cChunkManager.getChunkCoords(cameraPosition);
+  int loadRadius = cChunkManager.loadRadius;
+  int unloadRadius = cChunkManager.unloadRadius;
+
+  // unload ring: move far chunks to the cache, keeping their gpu buffers
+  for (auto it = cChunkManager.chunks.begin();
+       it != cChunkManager.chunks.end();) {
+    glm::ivec3 coords = it->first;
+    if (getRingDistance(coords, center) <= unloadRadius) {
+      ++it;
+      continue;
+    }
+    cChunkManager.onChunkUnloaded(it->second);
+    cChunkManager.dirtyChunks.erase(coords);
+    chunkStream.cache.emplace_front(coords, std::move(it->second));
+    chunkStream.cacheIndex[coords] = chunkStream.cache.begin();
+    it = cChunkManager.chunks.erase(it);
+  }
+  while (chunkStream.cache.size() > cChunkManager.cacheSize) {
+    chunkStream.cacheIndex.erase(chunkStream.cache.back().first);
+    chunkStream.cache.pop_back(); // releases the gpu buffers
+  }
+  // results of jobs that left the ring are dropped once they finish
+  std::erase_if(chunkStream.pending, [&](const auto& job) {
+    return getRingDistance(job.first, center) > unloadRadius;
+  });
+
+  // load ring: nearest rings first so the area under the camera fills in
+  // before the horizon
+  const auto& thread_pool = engine::Application::Get().getThreadPool();
+  for (int ring = 0; ring <= loadRadius; ++ring) {
+    for (int row = center.z - ring; row <= center.z + ring; ++row) {
+      for (int col = center.x - ring; col <= center.x + ring; ++col) {
+        glm::ivec3 coords{col, 0, row};
+        if (getRingDistance(coords, center) not_eq ring or
+            chunkStream.pending.contains(coords) or
+            cChunkManager.chunks.contains(coords)) {
+          continue;
+        }
+        if (auto cached = chunkStream.cacheIndex.find(coords);
+            cached not_eq chunkStream.cacheIndex.end()) {
+          // its blocks are current, its mesh may miss edits made around it
+          // while it was cached
+          auto [chunk, _] = cChunkManager.chunks.emplace(
+            coords, std::move(cached->second->second));
+          if (cChunkManager.hasEditsAround(coords)) {
+            cChunkManager.markDirty(coords);
+          }
+          cChunkManager.onChunkLoaded(chunk->second);
+          chunkStream.cache.erase(cached->second);
+          chunkStream.cacheIndex.erase(cached);
+          continue;
+        }
+        auto settings = m_settings.at(e);
+        chunkStream.pending.emplace(
+          coords, thread_pool->submit([settings, coords]() {
+            return generateChunk(*settings, coords);
+          }));
+      }
+    }
+  }
+
+  // gpu uploads are bounded per frame to avoid spikes
+  uint32_t uploads = 0;
+  for (auto it = chunkStream.pending.begin();
+       it != chunkStream.pending.end() and
+       uploads < cChunkManager.uploadsPerFrame;) {
+    if (it->second.wait_for(std::chrono::seconds(0)) not_eq
+        std::future_status::ready) {
+      ++it;
+      continue;
+    }
+    auto [chunk, _] = cChunkManager.chunks.emplace(
+      it->first, createChunk(cChunkManager, it->first, it->second.get()));
+    restoreEdits(cChunkManager, it->first, chunk->second);
+    cChunkManager.onChunkLoaded(chunk->second);
+    it = chunkStream.pending.erase(it);
+    ++uploads;
+  }
+}
+
+void TerrainSystem::remesh(entt::entity e,
+                           engine::CChunkManager& cChunkManager) {
+  const ChunkSettings& settings = *m_settings.at(e);
+  engine::Timer timer;
+  uint32_t remeshed = 0;
+  // at least one chunk per frame so a small budget never starves the edits
+  for (auto dirty = cChunkManager.dirtyChunks.begin();
+       dirty not_eq cChunkManager.dirtyChunks.end() and
+       (remeshed == 0 or
+        timer.getMilliseconds() < cChunkManager.remeshBudget);) {
+    glm::ivec3 coords = *dirty;
+    dirty = cChunkManager.dirtyChunks.erase(dirty);
+    auto it = cChunkManager.chunks.find(coords);
+    if (it == cChunkManager.chunks.end()) {
+      continue;
+    }
+
+    engine::CChunk& chunk = it->second;
+    ChunkMeshData data =
+      generateChunkMesh(gatherVoxels(settings, cChunkManager, coords),
+                        settings.blockSize, settings.drawMode,
+                        settings.textureAtlas);
+    updateChunkMesh(chunk.terrainMesh, std::move(data));
+    cChunkManager.onChunkRemeshed();
+    size_t bytes = chunk.blocks.getBytes();
+    chunk.blocks.compress();
+    cChunkManager.voxelBytes =
+      cChunkManager.voxelBytes - bytes + chunk.blocks.getBytes();
+    if (auto edited = cChunkManager.editedChunks.find(coords);
+        edited not_eq cChunkManager.editedChunks.end()) {
+      edited->second.compress();
+    }
+    ++remeshed;
+  }
+}
+
+engine::systems::SystemAccess TerrainSystem::getAccess() const {
+  // the chunk meshes are uploaded to the GL context
+  return engine::systems::SystemAccess()
+    .read<engine::CCamera, engine::CActiveCamera, engine::CTransform>()
+    .write<engine::CChunkManager>()
+    .onMainThread();
+}
+
 void TerrainSystem::update(entt::registry& registry, const engine::Time& ts) {
+  auto isInvalid = [&](const auto& entry) {
+    return not registry.valid(entry.first);
+  };
+  std::erase_if(m_settings, isInvalid);
+  std::erase_if(m_streams, isInvalid);
+
+  // edits are shown even while the game is paused
+  for (const auto& [e, settings] : m_settings) {
+    engine::CChunkManager* cChunkManager =
+      registry.try_get<engine::CChunkManager>(e);
+    if (cChunkManager and not cChunkManager->dirtyChunks.empty() and
+        settings->meshType == engine::CChunkManager::MeshType::Chunk) {
+      remesh(e, *cChunkManager);
+    }
+  }
+
   auto& app = engine::Application::Get();
   if (app.isGamePaused()) {
     return;
   }
 
-  // TODO here we rebuild meshes and stuff
+  if (m_streams.empty()) {
+    return;
+  }
+
+  entt::entity camera =
+    registry
+      .view<engine::CCamera, engine::CActiveCamera, engine::CTransform>()
+      .front();
+  if (camera == entt::null) {
+    return;
+  }
+  glm::vec3 cameraPosition = registry.get<engine::CTransform>(camera).position;
+
+  for (auto& [e, _] : m_streams) {
+    engine::CChunkManager* cChunkManager =
+      registry.try_get<engine::CChunkManager>(e);
+    if (cChunkManager and cChunkManager->streaming) {
+      stream(e, *cChunkManager, cameraPosition);
+    }
+  }
+}
 }
-}
\ No newline at end of file
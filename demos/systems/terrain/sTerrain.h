@@ -1,11 +1,93 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <future>
+#include <list>
 
 #include "engineAPI.h"
 
 namespace demos::systems {
 
+// cpu side of a chunk mesh, built by the workers and uploaded later
+struct ChunkMeshData {
+    std::vector<engine::TerrainVertex> vertices;
+    std::vector<uint32_t> indices;
+    // only for voxel chunks
+    engine::PalettedVolume<engine::CBlock::Type> blocks;
+    uint32_t visibleFaces{}; // block faces before greedy merging
+};
+
+// everything a worker needs to build a chunk, copied out of the registry so
+// jobs can outlive the components they were created from
+struct ChunkSettings {
+    uint32_t chunkSize{};
+    uint32_t blockSize{};
+    engine::CChunkManager::MeshType meshType{};
+    engine::CChunkManager::MeshAlgorithm meshAlgorithm{};
+    bool useBiomes{};
+    engine::CTexture::DrawMode drawMode{};
+    engine::CNoise noise;
+    engine::CTextureAtlas textureAtlas;
+};
+
+// block types of a chunk plus a one block border copied from its neighbours,
+// so faces between chunks can be culled without reading other chunks
+class VoxelVolume {
+  public:
+    explicit VoxelVolume(int size)
+      : m_size(size), m_types((size + 2) * (size + 2) * size) {}
+
+    int getSize() const { return m_size; }
+
+    // x and z in [-1, size], y in [0, size)
+    void set(int x, int y, int z, engine::CBlock::Type type) {
+      m_types[getIndex(x, y, z)] = type;
+    }
+
+    // below the chunk is treated as solid so bottom faces are never emitted
+    engine::CBlock::Type get(int x, int y, int z) const {
+      if (y < 0) {
+        return engine::CBlock::Type::Bedrock;
+      }
+      if (y >= m_size) {
+        return engine::CBlock::Type::Air;
+      }
+      return m_types[getIndex(x, y, z)];
+    }
+
+    engine::PalettedVolume<engine::CBlock::Type> getBlocks() const {
+      engine::PalettedVolume<engine::CBlock::Type> blocks(m_size);
+      for (int y = 0; y < m_size; ++y) {
+        for (int z = 0; z < m_size; ++z) {
+          for (int x = 0; x < m_size; ++x) {
+            blocks.set(x, y, z, get(x, y, z));
+          }
+        }
+      }
+      blocks.compress(); // chunks stay at rest until edited
+      return blocks;
+    }
+
+  private:
+    int getIndex(int x, int y, int z) const {
+      return (y * (m_size + 2) + z + 1) * (m_size + 2) + x + 1;
+    }
+
+    int m_size{};
+    std::vector<engine::CBlock::Type> m_types;
+};
+
+// cpu side of the chunk at coords, generated from the noise. It touches no
+// registry nor GL object so it can run on any thread
+ChunkMeshData generateChunk(const ChunkSettings& settings, glm::ivec3 coords);
+VoxelVolume generateVoxels(const ChunkSettings& settings, glm::ivec3 coords);
+// merges equal faces into maximal quads, without merge every visible face is
+// its own quad like a per face mesher
+ChunkMeshData generateChunkMesh(const VoxelVolume& volume, uint32_t blockSize,
+                                engine::CTexture::DrawMode drawMode,
+                                const engine::CTextureAtlas& cTextureAtlas,
+                                bool merge = true);
+
 class TerrainSystem : public engine::systems::System {
   public:
     TerrainSystem(int priority) : engine::systems::System(priority) {}
@@ -13,6 +95,27 @@ class TerrainSystem : public engine::systems::System {
     void init(entt::registry& registry) override final;
     void update(entt::registry& registry,
                 const engine::Time& ts) override final;
+    engine::systems::SystemAccess getAccess() const override final;
+
+  private:
+    struct ChunkStream {
+        std::unordered_map<glm::ivec3, std::future<ChunkMeshData>> pending;
+        // least recently unloaded chunks at the back
+        std::list<std::pair<glm::ivec3, engine::CChunk>> cache;
+        std::unordered_map<
+          glm::ivec3,
+          std::list<std::pair<glm::ivec3, engine::CChunk>>::iterator>
+          cacheIndex;
+    };
+
+    void stream(entt::entity e, engine::CChunkManager& cChunkManager,
+                glm::vec3 cameraPosition);
+    // rebuilds edited chunks within the manager's remesh budget
+    void remesh(entt::entity e, engine::CChunkManager& cChunkManager);
+
+    std::unordered_map<entt::entity, std::shared_ptr<const ChunkSettings>>
+      m_settings;
+    std::unordered_map<entt::entity, ChunkStream> m_streams;
 };
 
 }
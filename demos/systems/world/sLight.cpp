@@ -5,25 +5,38 @@ using namespace entt::literals;
 namespace demos::systems {
 
 void LightSystem::init(entt::registry& registry) {
+  const auto& render_manager = engine::Application::Get().getRenderManager();
+  render_manager->clearLights();
   registry.view<engine::CLight, engine::CTransform, engine::CUUID>().each(
     [&](const engine::CLight& cLight, const engine::CTransform& cTransform,
         const engine::CUUID& cUUID) {
-      entt::monostate<"lightPosition"_hs>{} = cTransform.position;
-      entt::monostate<"lightColor"_hs>{} = cLight.color;
+      render_manager->addLight(cTransform.position, cLight.color,
+                               cLight.range);
     });
 }
 
-void LightSystem::update(entt::registry& registry, const engine::Time& ts) {
+engine::systems::SystemAccess LightSystem::getAccess() const {
+  // the lights are handed to the render manager after the stage, so they
+  // follow the transforms the systems before them defer
+  return engine::systems::SystemAccess()
+    .read<engine::CLight, engine::CUUID>()
+    .defer<engine::CTransform>()
+    .onMainThread();
+}
+
+void LightSystem::commit(entt::registry& registry, const engine::Time& ts) {
   if (engine::Application::Get().isGamePaused()) {
     return;
   }
 
-  // TODO this only works with one light fix
+  // lights with range are clustered, the others light the whole scene
+  const auto& render_manager = engine::Application::Get().getRenderManager();
+  render_manager->clearLights();
   registry.view<engine::CLight, engine::CTransform, engine::CUUID>().each(
     [&](const engine::CLight& cLight, const engine::CTransform& cTransform,
         const engine::CUUID& cUUID) {
-      entt::monostate<"lightPosition"_hs>{} = cTransform.position;
-      entt::monostate<"lightColor"_hs>{} = cLight.color;
+      render_manager->addLight(cTransform.position, cLight.color,
+                               cLight.range);
     });
 }
 }
\ No newline at end of file
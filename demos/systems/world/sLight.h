@@ -11,8 +11,9 @@ class LightSystem : public engine::systems::System {
     LightSystem(int priority) : engine::systems::System(priority) {}
 
     void init(entt::registry& registry) override final;
-    void update(entt::registry& registry,
+    void commit(entt::registry& registry,
                 const engine::Time& ts) override final;
+    engine::systems::SystemAccess getAccess() const override final;
 };
 
 }
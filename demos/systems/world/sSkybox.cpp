@@ -4,8 +4,8 @@ using namespace entt::literals;
 
 namespace demos::systems {
 
+// the fog is reset by RenderManager::clear with the scene
 SkyboxSystem::~SkyboxSystem() {
-  entt::monostate<"useFog"_hs>{} = 0.f;
   entt::monostate<"useSkyBlending"_hs>{} = 0.f;
 }
 
@@ -13,7 +13,8 @@ void SkyboxSystem::init(entt::registry& registry) {
   registry
     .view<engine::CSkybox, engine::CTransform, engine::CRigidBody,
           engine::CTime, engine::CTexture, engine::CUUID>()
-    .each([&](const engine::CSkybox& cSkybox, engine::CTransform& cTransform,
+    .each([&](entt::entity e, const engine::CSkybox& cSkybox,
+              engine::CTransform& cTransform,
               const engine::CRigidBody& cRigidBody, const engine::CTime& cTime,
               engine::CTexture& cTexture, const engine::CUUID& cUUID) {
       if (cTexture.drawMode == engine::CTexture::DrawMode::TEXTURES_BLEND) {
@@ -38,24 +39,36 @@ void SkyboxSystem::init(entt::registry& registry) {
               (cTime.currentHour - cTime.nightTransitionStart) * cTime.fps) /
              120.f);
         }
-        cTexture.blendFactor = blendFactor;
+        if (cTexture.blendFactor not_eq blendFactor) {
+          // patched for the render system to share the new blend
+          registry.patch<engine::CTexture>(
+            e, [&](engine::CTexture& c) { c.blendFactor = blendFactor; });
+        }
         entt::monostate<"skyBlendFactor"_hs>{} = blendFactor;
         entt::monostate<"useSkyBlending"_hs>{} = 1.f;
       } else {
         entt::monostate<"useSkyBlending"_hs>{} = 0.f;
       }
 
+      const auto& render_manager =
+        engine::Application::Get().getRenderManager();
       if (cSkybox.useFog) {
-        entt::monostate<"useFog"_hs>{} = 1.f;
-        entt::monostate<"fogDensity"_hs>{} = cSkybox.fogDensity;
-        entt::monostate<"fogGradient"_hs>{} = cSkybox.fogGradient;
-        entt::monostate<"fogColor"_hs>{} = cSkybox.fogColor;
+        render_manager->setFog(cSkybox.fogColor, cSkybox.fogDensity,
+                               cSkybox.fogGradient);
       } else {
-        entt::monostate<"useFog"_hs>{} = 0.f;
+        render_manager->disableFog();
       }
     });
 }
 
+engine::systems::SystemAccess SkyboxSystem::getAccess() const {
+  // the sky blending is set on the render manager and the monostates
+  return engine::systems::SystemAccess()
+    .read<engine::CSkybox, engine::CRigidBody, engine::CTime, engine::CUUID>()
+    .write<engine::CTransform, engine::CTexture>()
+    .onMainThread();
+}
+
 void SkyboxSystem::update(entt::registry& registry, const engine::Time& ts) {
   if (engine::Application::Get().isGamePaused()) {
     return;
@@ -64,7 +77,8 @@ void SkyboxSystem::update(entt::registry& registry, const engine::Time& ts) {
   registry
     .view<engine::CSkybox, engine::CTransform, engine::CRigidBody,
           engine::CTime, engine::CTexture, engine::CUUID>()
-    .each([&](const engine::CSkybox& cSkybox, engine::CTransform& cTransform,
+    .each([&](entt::entity e, const engine::CSkybox& cSkybox,
+              engine::CTransform& cTransform,
               const engine::CRigidBody& cRigidBody, const engine::CTime& cTime,
               engine::CTexture& cTexture, const engine::CUUID& cUUID) {
       if (cTexture.drawMode == engine::CTexture::DrawMode::TEXTURES_BLEND) {
@@ -89,20 +103,24 @@ void SkyboxSystem::update(entt::registry& registry, const engine::Time& ts) {
               (cTime.currentHour - cTime.nightTransitionStart) * cTime.fps) /
              120.f);
         }
-        cTexture.blendFactor = blendFactor;
+        if (cTexture.blendFactor not_eq blendFactor) {
+          // patched for the render system to share the new blend
+          registry.patch<engine::CTexture>(
+            e, [&](engine::CTexture& c) { c.blendFactor = blendFactor; });
+        }
         entt::monostate<"skyBlendFactor"_hs>{} = blendFactor;
         entt::monostate<"useSkyBlending"_hs>{} = 1.f;
       } else {
         entt::monostate<"useSkyBlending"_hs>{} = 0.f;
       }
 
+      const auto& render_manager =
+        engine::Application::Get().getRenderManager();
       if (cSkybox.useFog) {
-        entt::monostate<"useFog"_hs>{} = 1.f;
-        entt::monostate<"fogDensity"_hs>{} = cSkybox.fogDensity;
-        entt::monostate<"fogGradient"_hs>{} = cSkybox.fogGradient;
-        entt::monostate<"fogColor"_hs>{} = cSkybox.fogColor;
+        render_manager->setFog(cSkybox.fogColor, cSkybox.fogDensity,
+                               cSkybox.fogGradient);
       } else {
-        entt::monostate<"useFog"_hs>{} = 0.f;
+        render_manager->disableFog();
       }
 
       if (cRigidBody.isKinematic) {
@@ -5,6 +5,7 @@
 
 #include "core/application.h"
 #include "render/buffer.h"
+#include "utils/meshSimplifier.h"
 
 namespace potatoengine::assets {
 
@@ -74,20 +75,11 @@ CMesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
         glm::vec3(bitangentVector.x, bitangentVector.y, bitangentVector.z);
     }
 
-    if (mesh->HasBones()) {
-      // TODO bones
-    }
-
     if (mesh->HasVertexColors(0)) {
       const auto& color = mesh->mColors[0][i];
       vertex.color = glm::vec4(color.r, color.g, color.b, color.a);
     }
 
-    if (mesh->mAABB.mMin not_eq aiVector3D(0.f, 0.f, 0.f) and
-        mesh->mAABB.mMax not_eq aiVector3D(0.f, 0.f, 0.f)) {
-      // TODO aabb with models
-    }
-
     if (mesh->HasFaces()) {
       // TODO faces
     }
@@ -95,6 +87,23 @@ CMesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
     vertices.emplace_back(std::move(vertex));
   }
 
+  // only the influences, there is no skeleton animation yet
+  for (uint32_t i = 0; i < mesh->mNumBones; ++i) {
+    const aiBone* bone = mesh->mBones[i];
+    for (uint32_t j = 0; j < bone->mNumWeights; ++j) {
+      const aiVertexWeight& weight = bone->mWeights[j];
+      Vertex& vertex = vertices[weight.mVertexId];
+      // past MAX_BONE_INFLUENCE the influences are dropped
+      for (uint32_t k = 0; k < MAX_BONE_INFLUENCE; ++k) {
+        if (vertex.boneWeights[k] == 0.f) {
+          vertex.boneIDs[k] = i;
+          vertex.boneWeights[k] = weight.mWeight;
+          break;
+        }
+      }
+    }
+  }
+
   for (uint32_t i = 0; i < mesh->mNumFaces; ++i) {
     aiFace face = mesh->mFaces[i];
     indices.reserve(face.mNumIndices);
@@ -138,7 +147,11 @@ CMesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
   }
   m_materials.emplace_back(std::move(materialData));
 
-  return CMesh(std::move(vertices), std::move(indices), std::move(textures));
+  CMesh cMesh(std::move(vertices), std::move(indices), std::move(textures));
+  cMesh.hasBones = mesh->HasBones();
+  cMesh.lods = MeshSimplifier::GenerateLODs(cMesh.vertices, cMesh.indices,
+                                            CMesh::MaxLODs);
+  return cMesh;
 }
 
 std::vector<std::shared_ptr<Texture>>
@@ -211,6 +224,10 @@ const std::map<std::string, std::string, NumericComparator>& Model::getInfo() {
   m_info["Filepath"] = m_filepath;
   m_info["Meshes"] = std::to_string(m_meshes.size());
   m_info["Materials"] = std::to_string(m_materials.size());
+  for (uint32_t i = 0; i < m_meshes.size(); ++i) {
+    m_info["Mesh " + std::to_string(i) + " LODs"] =
+      std::to_string(m_meshes[i].lods.size() + 1);
+  }
   for (uint32_t i = 0; i < m_loadedTextures.size(); ++i) {
     m_info["Loaded Texture " + std::to_string(i)] = std::to_string(i);
   }
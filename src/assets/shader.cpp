@@ -12,7 +12,13 @@ Shader::Shader(std::filesystem::path&& fp)
   std::string data(std::istreambuf_iterator<char>(f), {});
   f.close();
 
-  m_type = fp.extension() == ".vert" ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER;
+  if (fp.extension() == ".vert") {
+    m_type = GL_VERTEX_SHADER;
+  } else if (fp.extension() == ".comp") {
+    m_type = GL_COMPUTE_SHADER;
+  } else {
+    m_type = GL_FRAGMENT_SHADER;
+  }
   m_id = glCreateShader(m_type);
 
   const GLchar* source = data.data();
@@ -13,6 +13,7 @@ Application::Application(std::unique_ptr<SettingsManager>&& s, CLArgs&& args)
   m_name = m_settings_manager->appName;
   std::filesystem::current_path(m_settings_manager->root);
   m_states_manager = StatesManager::Create();
+  m_thread_pool = ThreadPool::Create();
   m_assets_manager = assets::AssetsManager::Create();
 
   m_windows_manager = WindowsManager::Create(m_settings_manager);
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
+
 #include "assets/assetsManager.h"
 #include "core/windowsManager.h"
 #include "core/settingsManager.h"
 #include "core/state.h"
 #include "core/statesManager.h"
+#include "core/threadPool.h"
 #include "events/event.h"
 #include "pch.h"
 #include "render/renderManager.h"
@@ -50,6 +53,9 @@ class Application {
     const std::unique_ptr<StatesManager>& getStatesManager() const {
       return m_states_manager;
     }
+    const std::unique_ptr<ThreadPool>& getThreadPool() const {
+      return m_thread_pool;
+    }
 
     void close() { m_running = false; }
     void minimize(bool minimize) { m_minimized = minimize; }
@@ -71,6 +77,7 @@ class Application {
     std::unique_ptr<SettingsManager> m_settings_manager;
     std::unique_ptr<StatesManager> m_states_manager;
     std::unique_ptr<WindowsManager> m_windows_manager;
+    std::unique_ptr<ThreadPool> m_thread_pool;
     std::unique_ptr<ImGuiLayer> m_imgui_layer;
 
   private:
@@ -79,7 +86,8 @@ class Application {
     std::string m_name;
     bool m_running{true};
     bool m_minimized{};
-    bool m_gamePaused{};
+    // toggled by the events of main thread systems while workers read it
+    std::atomic<bool> m_gamePaused{};
     bool m_restoreGamePaused{};
     bool m_debugging{};
     float m_lastFrame{};
@@ -34,6 +34,7 @@ struct SettingsManager {
     bool debugEnabled = true; // TODO use for something
     bool displayFPS = false;  // TODO implement with debugEnabled maybe?
     bool displayCollisionBoxes = false;
+    bool displayOcclusionCulling = false;
 
     bool enableEngineLogger = true;
     bool enableAppLogger = true;
@@ -59,8 +60,9 @@ struct SettingsManager {
     bool reloadPrototypes = false;
 
     std::vector<const char*> scenes{
-      "Sponza", "Dabrovic Sponza", "Lowpoly City", "Skycrapers", "Trailer park",
-      "Cubes",  "Plane terrain",   "Primitives",   "Empty",      "Flappy Bird"};
+      "Sponza",       "Dabrovic Sponza", "Lowpoly City",  "Skycrapers",
+      "Trailer park", "Cubes",           "Plane terrain", "Primitives",
+      "Lights",       "Empty",           "Flappy Bird"};
     std::vector<const char*> scenesPaths{
       "assets/scenes/sponza_scene.json",
       "assets/scenes/dabrovic_sponza_scene.json",
@@ -70,6 +72,7 @@ struct SettingsManager {
       "assets/scenes/cubes_scene.json",
       "assets/scenes/plane_terrain_scene.json",
       "assets/scenes/primitives_scene.json",
+      "assets/scenes/lights_scene.json",
       "assets/scenes/empty_scene.json",
       "assets/scenes/flappy_bird_scene.json"};
     std::vector<const char*> cursorModes{"Normal", "Hidden", "Disabled"};
@@ -83,5 +86,6 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
   debugEnabled, displayFPS, enableEngineLogger, enableAppLogger, engineLogLevel,
   appLogLevel, engineFlushLevel, appFlushLevel, enableEngineBacktraceLogger,
   enableAppBacktraceLogger, clearColor, clearDepth, activeScene,
-  activeScenePath, reloadPrototypes, displayCollisionBoxes);
+  activeScenePath, reloadPrototypes, displayCollisionBoxes,
+  displayOcclusionCulling);
 }
\ No newline at end of file
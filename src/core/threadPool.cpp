@@ -0,0 +1,53 @@
+#include "core/threadPool.h"
+
+namespace potatoengine {
+
+ThreadPool::ThreadPool(uint32_t threads) {
+  // hardware_concurrency can return 0 when it is not computable
+  threads = std::max(threads, 1u);
+  ENGINE_TRACE("Initializing thread pool with {} workers...", threads);
+  m_workers.reserve(threads);
+  for (uint32_t i = 0; i < threads; ++i) {
+    m_workers.emplace_back([this]() { work(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  ENGINE_WARN("Deleting thread pool");
+  {
+    std::scoped_lock lock(m_mutex);
+    m_stopping = true;
+  }
+  m_condition.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+uint32_t ThreadPool::getPendingJobs() {
+  std::scoped_lock lock(m_mutex);
+  return m_jobs.size();
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock lock(m_mutex);
+      m_condition.wait(
+        lock, [this]() { return m_stopping or not m_jobs.empty(); });
+      if (m_stopping and m_jobs.empty()) {
+        return;
+      }
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    job();
+  }
+}
+
+std::unique_ptr<ThreadPool> ThreadPool::Create(uint32_t threads) {
+  return std::make_unique<ThreadPool>(threads);
+}
+
+}
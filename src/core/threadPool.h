@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "pch.h"
+
+namespace potatoengine {
+
+class ThreadPool {
+  public:
+    ThreadPool(uint32_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // jobs must not touch the registry or the GL context, they run outside
+    // the main thread
+    template <typename F> auto submit(F&& f) -> std::future<decltype(f())> {
+      using R = decltype(f());
+      auto task =
+        std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+      std::future<R> result = task->get_future();
+      {
+        std::scoped_lock lock(m_mutex);
+        ENGINE_ASSERT(not m_stopping, "Submitting job to a stopped pool");
+        m_jobs.emplace_back([task]() { (*task)(); });
+      }
+      m_condition.notify_one();
+      return result;
+    }
+
+    // calls f(begin, end) over chunks of [0, count) of at least minChunk
+    // elements. The caller works on the chunks too and returns when all of
+    // them are done, so it can be called from a job of the pool. Workers
+    // busy with other jobs never hold it up, chunks are taken from a shared
+    // counter only by whoever is free
+    template <typename F>
+    void parallelFor(size_t count, size_t minChunk, F&& f) {
+      size_t chunks = std::min<size_t>(count / std::max<size_t>(minChunk, 1),
+                                       m_workers.size() * 4);
+      if (chunks <= 1) {
+        if (count > 0) {
+          f(size_t{0}, count);
+        }
+        return;
+      }
+
+      struct State {
+          std::atomic<size_t> next{};
+          std::atomic<size_t> done{};
+          std::mutex mutex;
+          std::exception_ptr error;
+      };
+      // jobs that start after the loop is over only read the counter, the
+      // state outlives them but f does not
+      auto state = std::make_shared<State>();
+      size_t chunkSize = (count + chunks - 1) / chunks;
+      chunks = (count + chunkSize - 1) / chunkSize;
+      auto drain = [state, chunks, chunkSize, count, &f]() {
+        size_t chunk;
+        while ((chunk = state->next.fetch_add(1)) < chunks) {
+          size_t begin = chunk * chunkSize;
+          try {
+            f(begin, std::min(begin + chunkSize, count));
+          } catch (...) {
+            std::scoped_lock lock(state->mutex);
+            if (not state->error) {
+              state->error = std::current_exception();
+            }
+          }
+          if (state->done.fetch_add(1) + 1 == chunks) {
+            state->done.notify_all();
+          }
+        }
+      };
+
+      size_t helpers = std::min<size_t>(m_workers.size(), chunks - 1);
+      {
+        std::scoped_lock lock(m_mutex);
+        ENGINE_ASSERT(not m_stopping, "Submitting job to a stopped pool");
+        for (size_t i = 0; i < helpers; ++i) {
+          m_jobs.emplace_back(drain);
+        }
+      }
+      m_condition.notify_all();
+      drain();
+
+      size_t done;
+      while ((done = state->done.load()) < chunks) {
+        state->done.wait(done);
+      }
+      if (state->error) {
+        std::rethrow_exception(state->error);
+      }
+    }
+
+    uint32_t getThreadCount() const { return m_workers.size(); }
+    uint32_t getPendingJobs();
+
+    static std::unique_ptr<ThreadPool>
+    Create(uint32_t threads = std::thread::hardware_concurrency());
+
+  private:
+    void work();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping{};
+};
+
+}
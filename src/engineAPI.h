@@ -11,8 +11,10 @@ namespace engine = potatoengine;
 #include "core/application.h"
 #include "core/input.h"
 #include "core/keyCodes.h"
+#include "core/mouseCodes.h"
 #include "core/settingsManager.h"
 #include "core/state.h"
+#include "core/threadPool.h"
 #include "core/time.h"
 
 // scene
@@ -43,7 +45,9 @@ namespace engine = potatoengine;
 #include "scene/components/utils/cNoise.h"
 #include "scene/components/world/cLight.h"
 #include "scene/components/world/cSkybox.h"
+#include "scene/groups.h"
 #include "scene/meta.h"
+#include "scene/parallelEach.h"
 #include "scene/sceneManager.h"
 #include "scene/system.h"
 
@@ -52,6 +56,9 @@ namespace engine = potatoengine;
 
 // render
 #include "render/buffer.h"
+#include "render/depthPyramid.h"
+#include "render/frustum.h"
+#include "render/geometryPool.h"
 #include "render/renderAPI.h"
 #include "render/renderManager.h"
 
@@ -66,6 +73,12 @@ namespace engine = potatoengine;
 #include "events/windowEvent.h"
 
 // utils
+#include "utils/aabb.h"
+#include "utils/bvh.h"
+#include "utils/chunkMap.h"
 #include "utils/getDefaultRoamingPath.h"
+#include "utils/meshSimplifier.h"
+#include "utils/multiArray.h"
 #include "utils/numericComparator.h"
+#include "utils/palettedVolume.h"
 #include "utils/timer.h"
@@ -142,6 +142,8 @@ drawSettingsManager(const std::unique_ptr<SettingsManager>& settings_manager,
       ImGui::Checkbox("Display FPS", &settings_manager->displayFPS); // TODO use for something
       ImGui::Checkbox("Display collision boxes",
                       &settings_manager->displayCollisionBoxes);
+      ImGui::Checkbox("Display occlusion culling",
+                      &settings_manager->displayOcclusionCulling);
     } else if (selectedSettingsManagerTabKey == "Logger") {
       ImGui::Checkbox("Enable engine logger",
                       &settings_manager->enableEngineLogger);
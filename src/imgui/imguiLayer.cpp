@@ -7,6 +7,7 @@
 
 #include "core/application.h"
 #include "imgui/imdebugger.h"
+#include "imgui/imoverlay.h"
 #include "imgui/imutils.h"
 #include "pch.h"
 
@@ -62,6 +63,7 @@ void ImGuiLayer::onImguiUpdate() {
     const auto& states_manager = app.getStatesManager();
     drawDebugger(settings_manager, assets_manager, render_manager,
                  scene_manager, states_manager);
+    drawOcclusionOverlay(settings_manager, render_manager);
   }
 }
 
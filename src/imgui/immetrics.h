@@ -40,6 +40,13 @@ drawMetrics(const std::unique_ptr<assets::AssetsManager>& assets_manager,
       ImGui::Text("%s: %s", key.c_str(), value.c_str());
     }
 
+    ImGui::SeparatorText("Systems");
+    for (const auto& timing : scene_manager->getSystemTimings()) {
+      ImGui::Text("Stage %u %s: %.3f ms (%s)", timing.stage,
+                  timing.name.c_str(), timing.milliseconds,
+                  timing.mainThread ? "main thread" : "worker");
+    }
+
     ImGui::SeparatorText("Assets Manager");
     for (const auto& [key, value] : assets_manager->getMetrics()) {
       ImGui::Text("%s: %s", key.c_str(), value.c_str());
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <imgui.h>
+
+#include "core/settingsManager.h"
+#include "pch.h"
+#include "render/renderManager.h"
+
+namespace potatoengine {
+
+// counters of the last frame in a corner on top of the scene
+inline void
+drawOcclusionOverlay(const std::unique_ptr<SettingsManager>& settings_manager,
+                     const std::unique_ptr<RenderManager>& render_manager) {
+  if (not settings_manager->displayOcclusionCulling) {
+    return;
+  }
+
+  ImGuiWindowFlags window_flags =
+    ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+    ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+    ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+  const ImGuiViewport* main_viewport = ImGui::GetMainViewport();
+  ImGui::SetNextWindowPos(
+    ImVec2(main_viewport->WorkPos.x + main_viewport->WorkSize.x - 10.f,
+           main_viewport->WorkPos.y + 10.f),
+    ImGuiCond_Always, ImVec2(1.f, 0.f));
+  ImGui::SetNextWindowBgAlpha(0.35f);
+  if (ImGui::Begin("Occlusion culling", nullptr, window_flags)) {
+    ImGui::Text("Occluded meshes: %u", render_manager->getOccludedCount());
+  }
+  ImGui::End();
+}
+}
@@ -2,14 +2,66 @@
 
 #include <glad/glad.h>
 
+#include <glm/gtc/packing.hpp>
+
 namespace potatoengine {
 
+namespace {
+PackedVertex pack(const Vertex& vertex) {
+  // the bitangent is only kept as the side of the tangent it is on
+  float sign =
+    glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.f
+      ? -1.f
+      : 1.f;
+  return {vertex.position,
+          glm::packSnorm3x10_1x2(glm::vec4(vertex.normal, 0.f)),
+          glm::packSnorm3x10_1x2(glm::vec4(vertex.tangent, sign)),
+          glm::packHalf2x16(vertex.textureCoords),
+          glm::packUnorm4x8(vertex.color)};
+}
+}
+
+std::vector<PackedVertex> PackVertices(const std::vector<Vertex>& vertices) {
+  std::vector<PackedVertex> packed;
+  packed.reserve(vertices.size());
+  for (const Vertex& vertex : vertices) {
+    packed.emplace_back(pack(vertex));
+  }
+  return packed;
+}
+
+std::vector<PackedSkinnedVertex>
+PackSkinnedVertices(const std::vector<Vertex>& vertices) {
+  std::vector<PackedSkinnedVertex> packed;
+  packed.reserve(vertices.size());
+  for (const Vertex& vertex : vertices) {
+    PackedVertex base = pack(vertex);
+    PackedSkinnedVertex& skinned = packed.emplace_back(
+      base.position, base.normal, base.tangent, base.textureCoords, base.color);
+    float total = 0.f;
+    for (float weight : vertex.boneWeights) {
+      total += weight;
+    }
+    for (uint32_t i = 0; i < MAX_BONE_INFLUENCE; ++i) {
+      ENGINE_ASSERT(vertex.boneIDs[i] >= 0 and vertex.boneIDs[i] < 256,
+                    "Bone {} does not fit in a packed vertex",
+                    vertex.boneIDs[i]);
+      skinned.boneIDs[i] = vertex.boneIDs[i];
+      float weight = total > 0.f ? vertex.boneWeights[i] / total : 0.f;
+      skinned.boneWeights[i] = std::lround(weight * 255.f);
+    }
+  }
+  return packed;
+}
+
 static constexpr GLbitfield mapping_flags =
     GL_MAP_WRITE_BIT | GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
 static constexpr GLbitfield storage_flags =
     GL_DYNAMIC_STORAGE_BIT | mapping_flags; // allow modification of the buffer but not resizing
 
-VBO::VBO(const std::vector<Vertex>& vertices) : m_count(vertices.size()), m_immutable(true) {
+VBO::VBO(const std::vector<Vertex>& vertices)
+  : m_count(vertices.size()), m_capacity(sizeof(Vertex) * vertices.size()),
+    m_immutable(true) {
   if (m_immutable) {
     glCreateBuffers(1, &m_id);
     glNamedBufferStorage(m_id, sizeof(Vertex) * vertices.size(), vertices.data(), storage_flags);
@@ -19,22 +71,54 @@ VBO::VBO(const std::vector<Vertex>& vertices) : m_count(vertices.size()), m_immu
   }
 }
 
-VBO::VBO(const std::vector<ShapeVertex>& vertices): m_count(vertices.size()) {
+VBO::VBO(const std::vector<ShapeVertex>& vertices)
+  : m_count(vertices.size()),
+    m_capacity(sizeof(ShapeVertex) * vertices.size()), m_immutable(true) {
   glCreateBuffers(1, &m_id);
   glNamedBufferStorage(m_id, sizeof(ShapeVertex) * vertices.size(), vertices.data(), storage_flags);
 }
 
-VBO::VBO(const std::vector<TerrainVertex>& vertices) : m_count(vertices.size()) {
+VBO::VBO(const std::vector<TerrainVertex>& vertices)
+  : m_count(vertices.size()),
+    m_capacity(sizeof(TerrainVertex) * vertices.size()), m_immutable(true) {
   glCreateBuffers(1, &m_id);
   glNamedBufferStorage(m_id, sizeof(TerrainVertex) * vertices.size(), vertices.data(), storage_flags);
 }
 
-void VBO::reload(const std::vector<Vertex>& vertices) {
+VBO::VBO(size_t size) : m_capacity(size), m_immutable(true) {
+  glCreateBuffers(1, &m_id);
+  glNamedBufferStorage(m_id, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
+
+bool VBO::reload(const std::vector<Vertex>& vertices) {
+  return write(vertices.data(), sizeof(Vertex) * vertices.size(),
+               vertices.size());
+}
+
+bool VBO::reload(const std::vector<TerrainVertex>& vertices) {
+  return write(vertices.data(), sizeof(TerrainVertex) * vertices.size(),
+               vertices.size());
+}
+
+bool VBO::write(const void* data, size_t size, uint32_t count) {
   if (m_immutable) {
-    glNamedBufferSubData(m_id, 0, sizeof(Vertex) * vertices.size(), vertices.data());
+    // immutable storage can not grow
+    if (size > m_capacity) {
+      return false;
+    }
+    glNamedBufferSubData(m_id, 0, size, data);
   } else {
-    glNamedBufferData(m_id, sizeof(Vertex) * vertices.size(), vertices.data(), GL_DYNAMIC_DRAW);
+    glNamedBufferData(m_id, size, data, GL_DYNAMIC_DRAW);
+    m_capacity = size;
   }
+  m_count = count;
+  return true;
+}
+
+void VBO::update(size_t offset, const void* data, size_t size) {
+  ENGINE_ASSERT(offset + size <= m_capacity, "VBO {} write out of range",
+                m_id);
+  glNamedBufferSubData(m_id, offset, size, data);
 }
 
 VBO::~VBO() {
@@ -52,7 +136,13 @@ std::unique_ptr<VBO> VBO::CreateTerrain(const std::vector<TerrainVertex>& vertic
   return std::make_unique<VBO>(vertices);
 }
 
-IBO::IBO(const std::vector<uint32_t>& indices) : m_count(indices.size()), m_immutable(true) {
+std::unique_ptr<VBO> VBO::CreateStorage(size_t size) {
+  return std::make_unique<VBO>(size);
+}
+
+IBO::IBO(const std::vector<uint32_t>& indices)
+  : m_count(indices.size()), m_capacity(sizeof(uint32_t) * indices.size()),
+    m_immutable(true) {
   if (m_immutable) {
     glCreateBuffers(1, &m_id);
     glNamedBufferStorage(m_id, sizeof(uint32_t) * indices.size(), indices.data(), storage_flags);
@@ -62,13 +152,30 @@ IBO::IBO(const std::vector<uint32_t>& indices) : m_count(indices.size()), m_immu
   }
 }
 
-void IBO::reload(const std::vector<uint32_t>& indices) {
+IBO::IBO(size_t size) : m_capacity(size), m_immutable(true) {
+  glCreateBuffers(1, &m_id);
+  glNamedBufferStorage(m_id, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
+
+bool IBO::reload(const std::vector<uint32_t>& indices) {
+  size_t size = sizeof(uint32_t) * indices.size();
   if (m_immutable) {
-    glNamedBufferSubData(m_id, 0, sizeof(uint32_t) * indices.size(), indices.data());
+    if (size > m_capacity) {
+      return false;
+    }
+    glNamedBufferSubData(m_id, 0, size, indices.data());
   } else {
-    glNamedBufferData(m_id, sizeof(uint32_t) * indices.size(), indices.data(), GL_DYNAMIC_DRAW);
+    glNamedBufferData(m_id, size, indices.data(), GL_DYNAMIC_DRAW);
+    m_capacity = size;
   }
   m_count = indices.size();
+  return true;
+}
+
+void IBO::update(size_t offset, const void* data, size_t size) {
+  ENGINE_ASSERT(offset + size <= m_capacity, "IBO {} write out of range",
+                m_id);
+  glNamedBufferSubData(m_id, offset, size, data);
 }
 
 IBO::~IBO() {
@@ -77,4 +184,132 @@ IBO::~IBO() {
 }
 
 std::unique_ptr<IBO> IBO::Create(const std::vector<uint32_t>& indices) { return std::make_unique<IBO>(indices); }
+
+std::unique_ptr<IBO> IBO::CreateStorage(size_t size) {
+  return std::make_unique<IBO>(size);
+}
+
+UBO::UBO(size_t size, uint32_t binding) : m_size(size) {
+  glCreateBuffers(1, &m_id);
+  glNamedBufferStorage(m_id, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_id);
+}
+
+UBO::~UBO() {
+  ENGINE_WARN("Deleting UBO {}", m_id);
+  glDeleteBuffers(1, &m_id);
+}
+
+void UBO::update(const void* data, size_t size) {
+  ENGINE_ASSERT(size <= m_size, "UBO {} update of {} bytes out of range", m_id,
+                size);
+  glNamedBufferSubData(m_id, 0, size, data);
+}
+
+std::unique_ptr<UBO> UBO::Create(size_t size, uint32_t binding) { return std::make_unique<UBO>(size, binding); }
+
+SSBO::SSBO(uint32_t binding) : m_binding(binding) {
+  glCreateBuffers(1, &m_id);
+}
+
+SSBO::~SSBO() {
+  ENGINE_WARN("Deleting SSBO {}", m_id);
+  glDeleteBuffers(1, &m_id);
+}
+
+void SSBO::upload(const void* data, size_t size) {
+  if (size > m_capacity or m_capacity == 0) {
+    // empty stores can not be bound, keep at least a few bytes
+    m_capacity = std::max({size, m_capacity * 2, size_t{16}});
+  }
+  glNamedBufferData(m_id, m_capacity, nullptr, GL_STREAM_DRAW);
+  glNamedBufferSubData(m_id, 0, size, data);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_binding, m_id);
+}
+
+std::unique_ptr<SSBO> SSBO::Create(uint32_t binding) { return std::make_unique<SSBO>(binding); }
+
+namespace {
+// offsets of every kind of binding are aligned to this, and the regions too
+constexpr size_t RingAlignment = 256;
+
+size_t alignUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+}
+
+RingBuffer::RingBuffer(size_t frameSize)
+  : m_frameSize(alignUp(std::max(frameSize, RingAlignment), RingAlignment)) {
+  createStorage();
+}
+
+RingBuffer::~RingBuffer() {
+  ENGINE_WARN("Deleting ring buffer {}", m_id);
+  for (void*& fence : m_fences) {
+    glDeleteSync(static_cast<GLsync>(fence));
+  }
+  glUnmapNamedBuffer(m_id);
+  glDeleteBuffers(1, &m_id);
+}
+
+void RingBuffer::createStorage() {
+  constexpr GLbitfield flags =
+    GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  size_t size = m_frameSize * FramesInFlight;
+  glCreateBuffers(1, &m_id);
+  glNamedBufferStorage(m_id, size, nullptr, flags);
+  m_data = static_cast<std::byte*>(glMapNamedBufferRange(m_id, 0, size, flags));
+  ENGINE_ASSERT(m_data, "Ring buffer {} could not be mapped", m_id);
+}
+
+void RingBuffer::beginFrame() {
+  m_head = 0;
+  void*& fence = m_fences[m_frame];
+  if (not fence) {
+    return;
+  }
+  // only blocks when the cpu is more than FramesInFlight frames ahead
+  GLenum status = GL_TIMEOUT_EXPIRED;
+  while (status == GL_TIMEOUT_EXPIRED) {
+    status = glClientWaitSync(static_cast<GLsync>(fence),
+                              GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+  }
+  ENGINE_ASSERT(status not_eq GL_WAIT_FAILED, "Ring buffer {} wait failed",
+                m_id);
+  glDeleteSync(static_cast<GLsync>(fence));
+  fence = nullptr;
+}
+
+void RingBuffer::endFrame() {
+  m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  m_frame = (m_frame + 1) % FramesInFlight;
+  m_head = 0;
+}
+
+RingBuffer::Allocation RingBuffer::allocate(size_t size, size_t alignment) {
+  ENGINE_ASSERT(RingAlignment % alignment == 0,
+                "Ring buffer alignment {} not supported", alignment);
+  size_t offset = alignUp(m_head, alignment);
+  if (offset + size > m_frameSize) {
+    // the draws already submitted keep the old storage alive until they
+    // finish, so it can be deleted right away
+    ENGINE_WARN("Growing ring buffer {} for {} bytes", m_id, size);
+    for (void*& fence : m_fences) {
+      glDeleteSync(static_cast<GLsync>(fence));
+      fence = nullptr;
+    }
+    glUnmapNamedBuffer(m_id);
+    glDeleteBuffers(1, &m_id);
+    m_frameSize =
+      alignUp(std::max(m_frameSize * 2, offset + size), RingAlignment);
+    createStorage();
+  }
+  m_head = offset + size;
+  size_t start = m_frameSize * m_frame + offset;
+  return {m_data + start, start};
+}
+
+std::unique_ptr<RingBuffer> RingBuffer::Create(size_t frameSize) {
+  return std::make_unique<RingBuffer>(frameSize);
+}
 }
\ No newline at end of file
@@ -6,7 +6,7 @@
 #include "pch.h"
 
 namespace potatoengine {
-#define MAX_BONE_INFLUENCE 4 // TODO use
+#define MAX_BONE_INFLUENCE 4
 
 struct Vertex { // TODO move
     glm::vec3 position{};
@@ -31,14 +31,50 @@ struct TerrainVertex {
     glm::vec3 color{};
 };
 
+// Vertex in 28 bytes instead of 104. Normals and tangents are snorm
+// 10:10:10:2, the 2 bits of the tangent hold the sign of the bitangent,
+// which is cross(normal, tangent) * sign. Texture coordinates are half
+// floats so tiled ones keep working, and the color is rgba8
+struct PackedVertex {
+    glm::vec3 position{};
+    uint32_t normal{};
+    uint32_t tangent{};
+    uint32_t textureCoords{};
+    uint32_t color{};
+};
+static_assert(sizeof(PackedVertex) == 28, "PackedVertex is not packed");
+
+// PackedVertex with the bone data, only used by meshes with bones
+struct PackedSkinnedVertex {
+    glm::vec3 position{};
+    uint32_t normal{};
+    uint32_t tangent{};
+    uint32_t textureCoords{};
+    uint32_t color{};
+    uint8_t boneIDs[MAX_BONE_INFLUENCE]{};
+    uint8_t boneWeights[MAX_BONE_INFLUENCE]{}; // unorm
+};
+static_assert(sizeof(PackedSkinnedVertex) == 36,
+              "PackedSkinnedVertex is not packed");
+
+std::vector<PackedVertex> PackVertices(const std::vector<Vertex>& vertices);
+std::vector<PackedSkinnedVertex>
+PackSkinnedVertices(const std::vector<Vertex>& vertices);
+
 class VBO {
   public:
     VBO(const std::vector<Vertex>& vertices);
     VBO(const std::vector<ShapeVertex>& vertices);
     VBO(const std::vector<TerrainVertex>& vertices);
+    // empty storage of size bytes shared by several meshes, written in parts
+    explicit VBO(size_t size);
     ~VBO();
 
-    void reload(const std::vector<Vertex>& vertices);
+    // rewrites the storage in place, false when the vertices do not fit and
+    // a new VBO is needed
+    bool reload(const std::vector<Vertex>& vertices);
+    bool reload(const std::vector<TerrainVertex>& vertices);
+    void update(size_t offset, const void* data, size_t size);
 
     uint32_t getCount() const { return m_count; }
     uint32_t getID() const { return m_id; }
@@ -49,29 +85,115 @@ class VBO {
     CreateShape(const std::vector<ShapeVertex>& vertices);
     static std::unique_ptr<VBO>
     CreateTerrain(const std::vector<TerrainVertex>& vertices);
+    static std::unique_ptr<VBO> CreateStorage(size_t size);
 
   private:
+    bool write(const void* data, size_t size, uint32_t count);
+
     uint32_t m_id{};
     uint32_t m_count{};
+    size_t m_capacity{}; // bytes
     bool m_immutable{};
 };
 
 class IBO {
   public:
     IBO(const std::vector<uint32_t>& indices);
+    // empty storage of size bytes shared by several meshes, written in parts
+    explicit IBO(size_t size);
     ~IBO();
 
-    void reload(const std::vector<uint32_t>& indices);
+    // rewrites the storage in place, false when the indices do not fit
+    bool reload(const std::vector<uint32_t>& indices);
+    void update(size_t offset, const void* data, size_t size);
 
     uint32_t getCount() const { return m_count; }
     uint32_t getID() const { return m_id; }
     bool isImmutable() const { return m_immutable; }
 
     static std::unique_ptr<IBO> Create(const std::vector<uint32_t>& indices);
+    static std::unique_ptr<IBO> CreateStorage(size_t size);
 
   private:
     uint32_t m_id{};
     uint32_t m_count{};
+    size_t m_capacity{}; // bytes
     bool m_immutable{};
 };
+
+// uniform block shared by every program that declares it at the binding
+class UBO {
+  public:
+    UBO(size_t size, uint32_t binding);
+    ~UBO();
+
+    void update(const void* data, size_t size);
+
+    uint32_t getID() const { return m_id; }
+
+    static std::unique_ptr<UBO> Create(size_t size, uint32_t binding);
+
+  private:
+    uint32_t m_id{};
+    size_t m_size{};
+};
+
+// shader storage buffer bound at the binding, rewritten every frame
+class SSBO {
+  public:
+    SSBO(uint32_t binding);
+    ~SSBO();
+
+    void upload(const void* data, size_t size);
+
+    uint32_t getID() const { return m_id; }
+
+    static std::unique_ptr<SSBO> Create(uint32_t binding);
+
+  private:
+    uint32_t m_id{};
+    uint32_t m_binding{};
+    size_t m_capacity{}; // bytes
+};
+
+// persistently mapped buffer for data rewritten every frame, like the model
+// matrices of instanced draws. It is split in one region per frame in
+// flight: the cpu writes the region of the current frame while the gpu reads
+// the older ones, and a fence keeps a region from being reused before the
+// gpu is done with it. There is no buffer creation or orphaning per frame
+class RingBuffer {
+  public:
+    static constexpr uint32_t FramesInFlight = 3;
+
+    struct Allocation {
+        void* data{};    // mapped memory, valid until endFrame
+        size_t offset{}; // in bytes from the start of the buffer
+    };
+
+    RingBuffer(size_t frameSize);
+    ~RingBuffer();
+
+    // waits until the gpu has finished with the region of the new frame
+    void beginFrame();
+    // fences the region of the frame and moves to the next one
+    void endFrame();
+    // a full region moves the ring to a bigger buffer, so the id can change
+    // between allocations and must be read after allocating
+    Allocation allocate(size_t size, size_t alignment);
+
+    uint32_t getID() const { return m_id; }
+    size_t getFrameSize() const { return m_frameSize; }
+
+    static std::unique_ptr<RingBuffer> Create(size_t frameSize);
+
+  private:
+    void createStorage();
+
+    uint32_t m_id{};
+    std::byte* m_data{};
+    size_t m_frameSize{}; // bytes of each region
+    size_t m_head{};      // bytes used in the region of the frame
+    uint32_t m_frame{};
+    std::array<void*, FramesInFlight> m_fences{};
+};
 }
\ No newline at end of file
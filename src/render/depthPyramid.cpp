@@ -0,0 +1,237 @@
+#include "render/depthPyramid.h"
+
+#include <glad/glad.h>
+
+#include "render/framebuffer.h"
+#include "render/shaderProgram.h"
+
+namespace potatoengine {
+
+namespace {
+// local size of the hiz compute shader
+constexpr uint32_t GroupSize = 8;
+
+uint32_t halve(uint32_t size) { return std::max(size / 2, 1u); }
+
+// the last texel of an odd level also covers the texel the halving drops
+uint32_t lastCovered(uint32_t texel, uint32_t size, uint32_t sourceSize) {
+  return texel == size - 1 ? sourceSize - 1 : texel * 2 + 1;
+}
+}
+
+DepthPyramid::~DepthPyramid() {
+  clear();
+  deleteTexture();
+}
+
+void DepthPyramid::deleteTexture() {
+  if (m_texture) {
+    ENGINE_WARN("Deleting depth pyramid {}", m_texture);
+    glDeleteTextures(1, &m_texture);
+    m_texture = 0;
+  }
+  for (Readback& readback : m_readbacks) {
+    glDeleteBuffers(1, &readback.buffer);
+    readback.buffer = 0;
+  }
+}
+
+void DepthPyramid::clear() {
+  for (Readback& readback : m_readbacks) {
+    if (readback.fence) {
+      glDeleteSync(static_cast<GLsync>(readback.fence));
+      readback.fence = nullptr;
+    }
+  }
+  m_levels.clear();
+}
+
+void DepthPyramid::resize(uint32_t width, uint32_t height) {
+  clear();
+  deleteTexture();
+  m_width = width;
+  m_height = height;
+
+  // the gpu only reduces down to the level read back
+  uint32_t levelWidth = halve(width);
+  uint32_t levelHeight = halve(height);
+  m_readbackLevel = 0;
+  while (levelWidth > ReadbackWidth) {
+    levelWidth = halve(levelWidth);
+    levelHeight = halve(levelHeight);
+    ++m_readbackLevel;
+  }
+  m_mipLevels = m_readbackLevel + 1;
+  glCreateTextures(GL_TEXTURE_2D, 1, &m_texture);
+  glTextureStorage2D(m_texture, m_mipLevels, GL_R32F, halve(width),
+                     halve(height));
+  glTextureParameteri(m_texture, GL_TEXTURE_MIN_FILTER,
+                      GL_NEAREST_MIPMAP_NEAREST);
+  glTextureParameteri(m_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  for (Readback& readback : m_readbacks) {
+    glCreateBuffers(1, &readback.buffer);
+    glNamedBufferData(readback.buffer,
+                      sizeof(float) * levelWidth * levelHeight, nullptr,
+                      GL_STREAM_READ);
+  }
+}
+
+void DepthPyramid::build(const FBO& fbo, ShaderProgram& sp,
+                         const glm::mat4& viewProjection) {
+  const std::unique_ptr<assets::Texture>& depth = fbo.getDepthTexture();
+  ENGINE_ASSERT(depth, "The depth pyramid needs a depth texture");
+  if (depth->getWidth() not_eq m_width or depth->getHeight() not_eq m_height) {
+    resize(depth->getWidth(), depth->getHeight());
+  }
+
+  sp.use();
+  uint32_t sourceWidth = m_width;
+  uint32_t sourceHeight = m_height;
+  for (uint32_t level = 0; level < m_mipLevels; ++level) {
+    uint32_t width = halve(sourceWidth);
+    uint32_t height = halve(sourceHeight);
+    glBindTextureUnit(0, level == 0 ? depth->getID() : m_texture);
+    sp.setInt("sourceLevel", level == 0 ? 0 : level - 1);
+    glBindImageTexture(0, m_texture, level, GL_FALSE, 0, GL_WRITE_ONLY,
+                       GL_R32F);
+    glDispatchCompute((width + GroupSize - 1) / GroupSize,
+                      (height + GroupSize - 1) / GroupSize, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    sourceWidth = width;
+    sourceHeight = height;
+  }
+  glBindTextureUnit(0, 0);
+  sp.unuse();
+
+  // oldest first so the newest finished readback ends up in the pyramid
+  for (uint32_t i = 0; i < Readbacks; ++i) {
+    Readback& readback = m_readbacks[(m_nextReadback + i) % Readbacks];
+    if (not readback.fence) {
+      continue;
+    }
+    GLenum status =
+      glClientWaitSync(static_cast<GLsync>(readback.fence), 0, 0);
+    if (status == GL_ALREADY_SIGNALED or status == GL_CONDITION_SATISFIED) {
+      read(readback);
+    }
+  }
+
+  // the gpu is still busy with the previous readbacks, try next frame
+  Readback& readback = m_readbacks[m_nextReadback];
+  if (readback.fence) {
+    return;
+  }
+  glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+  glGetTextureImage(m_texture, m_readbackLevel, GL_RED, GL_FLOAT,
+                    sizeof(float) * sourceWidth * sourceHeight, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  readback.viewProjection = viewProjection;
+  readback.width = m_width;
+  readback.height = m_height;
+  m_nextReadback = (m_nextReadback + 1) % Readbacks;
+}
+
+void DepthPyramid::read(Readback& readback) {
+  glDeleteSync(static_cast<GLsync>(readback.fence));
+  readback.fence = nullptr;
+
+  m_levels.resize(1);
+  Level& first = m_levels.front();
+  first.width = halve(m_width);
+  first.height = halve(m_height);
+  for (uint32_t level = 0; level < m_readbackLevel; ++level) {
+    first.width = halve(first.width);
+    first.height = halve(first.height);
+  }
+  first.depths.resize(first.width * first.height);
+  glGetNamedBufferSubData(readback.buffer, 0,
+                          sizeof(float) * first.depths.size(),
+                          first.depths.data());
+  m_viewProjection = readback.viewProjection;
+  m_sourceWidth = readback.width;
+  m_sourceHeight = readback.height;
+  m_shift = m_readbackLevel + 1;
+
+  // the same farthest depth reduction as the compute shader
+  while (m_levels.back().width > 1 or m_levels.back().height > 1) {
+    const Level& source = m_levels.back();
+    Level level{halve(source.width), halve(source.height), {}};
+    level.depths.resize(level.width * level.height);
+    for (uint32_t y = 0; y < level.height; ++y) {
+      uint32_t lastY = lastCovered(y, level.height, source.height);
+      for (uint32_t x = 0; x < level.width; ++x) {
+        uint32_t lastX = lastCovered(x, level.width, source.width);
+        float depth = 0.f;
+        for (uint32_t sy = y * 2; sy <= lastY; ++sy) {
+          for (uint32_t sx = x * 2; sx <= lastX; ++sx) {
+            depth = std::max(depth, source.depths[sx + sy * source.width]);
+          }
+        }
+        level.depths[x + y * level.width] = depth;
+      }
+    }
+    m_levels.emplace_back(std::move(level));
+  }
+}
+
+bool DepthPyramid::isOccluded(const AABB& box) const {
+  if (m_levels.empty()) {
+    return false;
+  }
+  glm::vec3 ndcMin(std::numeric_limits<float>::max());
+  glm::vec3 ndcMax(std::numeric_limits<float>::lowest());
+  for (uint32_t i = 0; i < 8; ++i) {
+    glm::vec3 corner{i & 1 ? box.max.x : box.min.x,
+                     i & 2 ? box.max.y : box.min.y,
+                     i & 4 ? box.max.z : box.min.z};
+    glm::vec4 clip = m_viewProjection * glm::vec4(corner, 1.f);
+    if (clip.w <= 0.f) {
+      return false;
+    }
+    glm::vec3 ndc = glm::vec3(clip) / clip.w;
+    ndcMin = glm::min(ndcMin, ndc);
+    ndcMax = glm::max(ndcMax, ndc);
+  }
+  if (ndcMin.x > 1.f or ndcMin.y > 1.f or ndcMax.x < -1.f or
+      ndcMax.y < -1.f or ndcMin.z < -1.f) {
+    return false;
+  }
+
+  // pixels of the fbo covered by the box
+  glm::uvec2 size(m_sourceWidth, m_sourceHeight);
+  glm::vec2 uvMin = glm::clamp(glm::vec2(ndcMin) * 0.5f + 0.5f, 0.f, 1.f);
+  glm::vec2 uvMax = glm::clamp(glm::vec2(ndcMax) * 0.5f + 0.5f, 0.f, 1.f);
+  glm::uvec2 first = glm::min(glm::uvec2(uvMin * glm::vec2(size)), size - 1u);
+  glm::uvec2 last = glm::min(glm::uvec2(uvMax * glm::vec2(size)), size - 1u);
+
+  // the finest level where the box covers at most 2x2 texels, a texel of
+  // level i holds the pixels p >> (m_shift + i)
+  auto covers = [&](uint32_t index) {
+    glm::uvec2 texels = (last >> (m_shift + index)) -
+                        (first >> (m_shift + index));
+    return glm::max(texels.x, texels.y) + 1;
+  };
+  uint32_t index = 0;
+  while (index + 1 < m_levels.size() and covers(index) > 2) {
+    ++index;
+  }
+  const Level& level = m_levels[index];
+  uint32_t shift = m_shift + index;
+  uint32_t x0 = std::min(first.x >> shift, level.width - 1);
+  uint32_t x1 = std::min(last.x >> shift, level.width - 1);
+  uint32_t y0 = std::min(first.y >> shift, level.height - 1);
+  uint32_t y1 = std::min(last.y >> shift, level.height - 1);
+  float farthest = 0.f;
+  for (uint32_t y = y0; y <= y1; ++y) {
+    for (uint32_t x = x0; x <= x1; ++x) {
+      farthest = std::max(farthest, level.depths[x + y * level.width]);
+    }
+  }
+  // nearest depth of the box in the same [0, 1] range as the depth buffer
+  return ndcMin.z * 0.5f + 0.5f > farthest;
+}
+
+}
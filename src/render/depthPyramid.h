@@ -0,0 +1,80 @@
+#pragma once
+
+#define GLM_FORCE_CTOR_INIT
+#include <glm/glm.hpp>
+
+#include "pch.h"
+#include "utils/aabb.h"
+
+namespace potatoengine {
+
+class FBO;
+class ShaderProgram;
+
+// hierarchical z buffer of the opaque depth of a frame. A compute shader
+// builds the mip chain on the gpu keeping the farthest depth of each 2x2
+// texels, and a coarse level is read back asynchronously so the boxes of
+// the next frames can be tested on the cpu without waiting for the gpu. The
+// boxes are projected with the view projection the depth was rendered with,
+// so moving occluders can hide something for a frame or two
+class DepthPyramid {
+  public:
+    DepthPyramid() = default;
+    ~DepthPyramid();
+    DepthPyramid(const DepthPyramid&) = delete;
+    DepthPyramid& operator=(const DepthPyramid&) = delete;
+
+    // reduces the depth texture of the fbo with the program and starts
+    // reading it back, the readbacks that finished since become the
+    // pyramid the boxes are tested against
+    void build(const FBO& fbo, ShaderProgram& sp,
+               const glm::mat4& viewProjection);
+    // true when the box is behind the depth everywhere it covers, boxes
+    // crossing the camera plane or outside the view never are
+    bool isOccluded(const AABB& box) const;
+    // drops the pyramid and the pending readbacks
+    void clear();
+
+    bool empty() const { return m_levels.empty(); }
+
+  private:
+    // the widest level the cpu reads back, coarser ones are built from it
+    static constexpr uint32_t ReadbackWidth = 256;
+    static constexpr uint32_t Readbacks = 2;
+
+    struct Level {
+        uint32_t width{};
+        uint32_t height{};
+        std::vector<float> depths;
+    };
+
+    struct Readback {
+        uint32_t buffer{};
+        void* fence{};
+        glm::mat4 viewProjection{};
+        uint32_t width{};  // of the fbo
+        uint32_t height{}; // of the fbo
+    };
+
+    void resize(uint32_t width, uint32_t height);
+    void read(Readback& readback);
+    void deleteTexture();
+
+    uint32_t m_texture{};
+    uint32_t m_width{};  // of the fbo
+    uint32_t m_height{}; // of the fbo
+    uint32_t m_mipLevels{};
+    uint32_t m_readbackLevel{};
+    std::array<Readback, Readbacks> m_readbacks{};
+    uint32_t m_nextReadback{};
+
+    // cpu pyramid from the last readback, level 0 is m_readbackLevel + 1
+    // halvings of the fbo it was read from
+    std::vector<Level> m_levels;
+    glm::mat4 m_viewProjection{};
+    uint32_t m_sourceWidth{};
+    uint32_t m_sourceHeight{};
+    uint32_t m_shift{};
+};
+
+}
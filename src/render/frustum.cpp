@@ -0,0 +1,92 @@
+#include "render/frustum.h"
+
+#if defined(__x86_64__) or defined(_M_X64)
+#define POTATOENGINE_SIMD_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace potatoengine {
+
+uint32_t AABBBatch::add(const AABB& box) {
+  glm::vec3 center = box.getCenter();
+  glm::vec3 extents = box.getExtents();
+  centerX.emplace_back(center.x);
+  centerY.emplace_back(center.y);
+  centerZ.emplace_back(center.z);
+  extentX.emplace_back(extents.x);
+  extentY.emplace_back(extents.y);
+  extentZ.emplace_back(extents.z);
+  return size() - 1;
+}
+
+void AABBBatch::clear() {
+  centerX.clear();
+  centerY.clear();
+  centerZ.clear();
+  extentX.clear();
+  extentY.clear();
+  extentZ.clear();
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+  // Gribb and Hartmann, each plane is the last row plus or minus another one
+  glm::mat4 m = glm::transpose(viewProjection);
+  m_planes = {m[3] + m[0], m[3] - m[0], m[3] + m[1],
+              m[3] - m[1], m[3] + m[2], m[3] - m[2]};
+}
+
+bool Frustum::isVisible(const AABB& box) const {
+  glm::vec3 center = box.getCenter();
+  glm::vec3 extents = box.getExtents();
+  for (const glm::vec4& plane : m_planes) {
+    glm::vec3 normal = glm::vec3(plane);
+    float distance = glm::dot(normal, center) + plane.w;
+    float radius = glm::dot(glm::abs(normal), extents);
+    if (distance + radius < 0.f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Frustum::cull(const AABBBatch& boxes,
+                   std::vector<uint8_t>& visible) const {
+  uint32_t count = boxes.size();
+  visible.resize(count);
+  uint32_t i = 0;
+#ifdef POTATOENGINE_SIMD_SSE
+  // 4 boxes per iteration, a box is out when it is behind any plane
+  const __m128 zero = _mm_setzero_ps();
+  for (; i + 4 <= count; i += 4) {
+    __m128 cx = _mm_loadu_ps(&boxes.centerX[i]);
+    __m128 cy = _mm_loadu_ps(&boxes.centerY[i]);
+    __m128 cz = _mm_loadu_ps(&boxes.centerZ[i]);
+    __m128 ex = _mm_loadu_ps(&boxes.extentX[i]);
+    __m128 ey = _mm_loadu_ps(&boxes.extentY[i]);
+    __m128 ez = _mm_loadu_ps(&boxes.extentZ[i]);
+    __m128 outside = zero;
+    for (const glm::vec4& plane : m_planes) {
+      __m128 distance = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)),
+                   _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+        _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)),
+                   _mm_set1_ps(plane.w)));
+      __m128 radius = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(std::abs(plane.x))),
+                   _mm_mul_ps(ey, _mm_set1_ps(std::abs(plane.y)))),
+        _mm_mul_ps(ez, _mm_set1_ps(std::abs(plane.z))));
+      outside =
+        _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+    }
+    int mask = _mm_movemask_ps(outside);
+    for (uint32_t j = 0; j < 4; ++j) {
+      visible[i + j] = not(mask & (1 << j));
+    }
+  }
+#endif
+  for (; i < count; ++i) {
+    visible[i] = isVisible(boxes.get(i));
+  }
+}
+
+}
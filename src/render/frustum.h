@@ -0,0 +1,50 @@
+#pragma once
+
+#define GLM_FORCE_CTOR_INIT
+#include <glm/glm.hpp>
+
+#include "pch.h"
+#include "utils/aabb.h"
+
+namespace potatoengine {
+
+// boxes as centers and half extents, one array per component so the
+// frustum can test several of them at once
+struct AABBBatch {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+
+    // index of the box in the batch
+    uint32_t add(const AABB& box);
+    AABB get(uint32_t index) const {
+      glm::vec3 center{centerX[index], centerY[index], centerZ[index]};
+      glm::vec3 extents{extentX[index], extentY[index], extentZ[index]};
+      return {center - extents, center + extents};
+    }
+    uint32_t size() const { return centerX.size(); }
+    void clear();
+};
+
+// planes of the clip space of a view projection matrix, a default frustum
+// has no planes and sees everything
+class Frustum {
+  public:
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    // conservative, boxes near the corners can pass without being inside
+    bool isVisible(const AABB& box) const;
+    // visible[i] is 1 when the box i is visible, several boxes are tested
+    // per iteration when the cpu supports it
+    void cull(const AABBBatch& boxes, std::vector<uint8_t>& visible) const;
+
+  private:
+    // normal in xyz pointing inside and distance in w, not normalized
+    std::array<glm::vec4, 6> m_planes{};
+};
+
+}
@@ -0,0 +1,279 @@
+#include "render/geometryPool.h"
+
+#include <glad/glad.h>
+
+namespace potatoengine {
+
+namespace {
+// elements each layout starts with, the buffers double when they are full
+constexpr uint32_t InitialVertices = 1 << 16;
+constexpr uint32_t InitialIndices = 1 << 18;
+
+// free ranges of a buffer by offset, the first one big enough is taken and
+// neighbours are merged back when a range is freed
+class RangeAllocator {
+  public:
+    static constexpr uint32_t NoSpace = std::numeric_limits<uint32_t>::max();
+
+    explicit RangeAllocator(uint32_t capacity) : m_capacity(capacity) {
+      m_free.emplace(0, capacity);
+    }
+
+    uint32_t allocate(uint32_t count) {
+      if (count == 0) {
+        return 0;
+      }
+      for (auto it = m_free.begin(); it not_eq m_free.end(); ++it) {
+        auto [offset, available] = *it;
+        if (available < count) {
+          continue;
+        }
+        m_free.erase(it);
+        if (available > count) {
+          m_free.emplace(offset + count, available - count);
+        }
+        m_used += count;
+        return offset;
+      }
+      return NoSpace;
+    }
+
+    void free(uint32_t offset, uint32_t count) {
+      if (count == 0) {
+        return;
+      }
+      m_used -= count;
+      auto next = m_free.lower_bound(offset);
+      if (next not_eq m_free.end() and offset + count == next->first) {
+        count += next->second;
+        next = m_free.erase(next);
+      }
+      if (next not_eq m_free.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+          previous->second += count;
+          return;
+        }
+      }
+      m_free.emplace(offset, count);
+    }
+
+    // the elements past the old capacity become free
+    void grow(uint32_t capacity) {
+      uint32_t added = capacity - m_capacity;
+      m_used += added;
+      free(m_capacity, added);
+      m_capacity = capacity;
+    }
+
+    uint32_t getCapacity() const { return m_capacity; }
+    uint32_t getUsed() const { return m_used; }
+
+  private:
+    std::map<uint32_t, uint32_t> m_free; // offset to count
+    uint32_t m_capacity{};
+    uint32_t m_used{};
+};
+}
+
+struct GeometryPool::Arena {
+    VAO::VertexType type;
+    size_t vertexSize;
+    std::shared_ptr<VAO> vao;
+    RangeAllocator vertices{InitialVertices};
+    RangeAllocator indices{InitialIndices};
+
+    explicit Arena(VAO::VertexType t)
+      : type(t), vertexSize(VAO::GetVertexSize(t)) {
+      vao = VAO::Create();
+      vao->attachVertex(VBO::CreateStorage(vertexSize * InitialVertices), type);
+      vao->setIndex(IBO::CreateStorage(sizeof(uint32_t) * InitialIndices));
+    }
+
+    uint32_t allocateVertices(uint32_t count) {
+      uint32_t offset = vertices.allocate(count);
+      if (offset not_eq RangeAllocator::NoSpace) {
+        return offset;
+      }
+      // the vao keeps its attribute formats, only the buffer behind changes
+      uint32_t old = vertices.getCapacity();
+      uint32_t capacity = std::max(old * 2, old + count);
+      std::shared_ptr<VBO> vbo = VBO::CreateStorage(vertexSize * capacity);
+      glCopyNamedBufferSubData(vao->getVBOs().front()->getID(), vbo->getID(),
+                               0, 0, vertexSize * old);
+      vao->updateVertex(std::move(vbo), 0, type);
+      vertices.grow(capacity);
+      ENGINE_TRACE("Geometry pool VAO {} grown to {} vertices", vao->getID(),
+                   capacity);
+      return vertices.allocate(count);
+    }
+
+    uint32_t allocateIndices(uint32_t count) {
+      uint32_t offset = indices.allocate(count);
+      if (offset not_eq RangeAllocator::NoSpace) {
+        return offset;
+      }
+      uint32_t old = indices.getCapacity();
+      uint32_t capacity = std::max(old * 2, old + count);
+      std::unique_ptr<IBO> ibo =
+        IBO::CreateStorage(sizeof(uint32_t) * capacity);
+      glCopyNamedBufferSubData(vao->getEBO()->getID(), ibo->getID(), 0, 0,
+                               sizeof(uint32_t) * old);
+      vao->setIndex(std::move(ibo));
+      indices.grow(capacity);
+      ENGINE_TRACE("Geometry pool VAO {} grown to {} indices", vao->getID(),
+                   capacity);
+      return indices.allocate(count);
+    }
+};
+
+GeometryPool::Mesh::~Mesh() {
+  m_arena->vertices.free(m_vertices.offset, m_vertices.reserved);
+  for (const Range& level : m_levels) {
+    m_arena->indices.free(level.offset, level.reserved);
+  }
+}
+
+GeometryPool::Draw GeometryPool::Mesh::getDraw(uint32_t level) const {
+  const Range& indices =
+    m_levels[std::min<uint32_t>(level, m_levels.size() - 1)];
+  return {m_arena->vao.get(), indices.offset, indices.count,
+          static_cast<int32_t>(m_vertices.offset), m_vertices.count};
+}
+
+std::map<std::string, std::string, NumericComparator>
+GeometryPool::Mesh::getInfo() const {
+  std::map<std::string, std::string, NumericComparator> info =
+    m_arena->vao->getInfo();
+  info["Base vertex"] = std::to_string(m_vertices.offset);
+  info["Vertices"] = std::to_string(m_vertices.count);
+  for (uint32_t i = 0; i < m_levels.size(); ++i) {
+    info["Level " + std::to_string(i) + " first index"] =
+      std::to_string(m_levels[i].offset);
+    info["Level " + std::to_string(i) + " indices"] =
+      std::to_string(m_levels[i].count);
+  }
+  return info;
+}
+
+std::shared_ptr<GeometryPool::Mesh>
+GeometryPool::add(const std::vector<Vertex>& vertices,
+                  const std::vector<uint32_t>& indices,
+                  const std::vector<std::vector<uint32_t>>& lods) {
+  std::vector<const std::vector<uint32_t>*> levels{&indices};
+  for (const std::vector<uint32_t>& lod : lods) {
+    levels.emplace_back(&lod);
+  }
+  return add(VAO::VertexType::VERTEX, vertices.data(), vertices.size(),
+             levels);
+}
+
+std::shared_ptr<GeometryPool::Mesh>
+GeometryPool::add(const std::vector<PackedVertex>& vertices,
+                  const std::vector<uint32_t>& indices,
+                  const std::vector<std::vector<uint32_t>>& lods) {
+  std::vector<const std::vector<uint32_t>*> levels{&indices};
+  for (const std::vector<uint32_t>& lod : lods) {
+    levels.emplace_back(&lod);
+  }
+  return add(VAO::VertexType::PACKED_VERTEX, vertices.data(), vertices.size(),
+             levels);
+}
+
+std::shared_ptr<GeometryPool::Mesh>
+GeometryPool::add(const std::vector<PackedSkinnedVertex>& vertices,
+                  const std::vector<uint32_t>& indices,
+                  const std::vector<std::vector<uint32_t>>& lods) {
+  std::vector<const std::vector<uint32_t>*> levels{&indices};
+  for (const std::vector<uint32_t>& lod : lods) {
+    levels.emplace_back(&lod);
+  }
+  return add(VAO::VertexType::PACKED_SKINNED_VERTEX, vertices.data(),
+             vertices.size(), levels);
+}
+
+std::shared_ptr<GeometryPool::Mesh>
+GeometryPool::add(const std::vector<ShapeVertex>& vertices,
+                  const std::vector<uint32_t>& indices) {
+  return add(VAO::VertexType::SHAPE_VERTEX, vertices.data(), vertices.size(),
+             {&indices});
+}
+
+std::shared_ptr<GeometryPool::Mesh>
+GeometryPool::add(const std::vector<TerrainVertex>& vertices,
+                  const std::vector<uint32_t>& indices) {
+  return add(VAO::VertexType::TERRAIN_VERTEX, vertices.data(),
+             vertices.size(), {&indices});
+}
+
+std::shared_ptr<GeometryPool::Mesh>
+GeometryPool::add(VAO::VertexType type, const void* vertices,
+                  uint32_t vertexCount,
+                  const std::vector<const std::vector<uint32_t>*>& levels) {
+  Arena& arena = getArena(type);
+  auto mesh = std::make_shared<Mesh>();
+  mesh->m_arena = m_arenas[static_cast<uint32_t>(type)];
+  uint32_t offset = arena.allocateVertices(vertexCount);
+  mesh->m_vertices = {offset, vertexCount, vertexCount};
+  arena.vao->getVBOs().front()->update(arena.vertexSize * offset, vertices,
+                                       arena.vertexSize * vertexCount);
+  for (const std::vector<uint32_t>* indices : levels) {
+    uint32_t count = indices->size();
+    offset = arena.allocateIndices(count);
+    mesh->m_levels.push_back({offset, count, count});
+    arena.vao->getEBO()->update(sizeof(uint32_t) * offset, indices->data(),
+                                sizeof(uint32_t) * count);
+  }
+  return mesh;
+}
+
+bool GeometryPool::update(Mesh& mesh,
+                          const std::vector<TerrainVertex>& vertices,
+                          const std::vector<uint32_t>& indices) {
+  Mesh::Range& level = mesh.m_levels.front();
+  if (vertices.size() > mesh.m_vertices.reserved or
+      indices.size() > level.reserved or mesh.m_levels.size() > 1) {
+    return false;
+  }
+  Arena& arena = *mesh.m_arena;
+  arena.vao->getVBOs().front()->update(
+    sizeof(TerrainVertex) * mesh.m_vertices.offset, vertices.data(),
+    sizeof(TerrainVertex) * vertices.size());
+  arena.vao->getEBO()->update(sizeof(uint32_t) * level.offset, indices.data(),
+                              sizeof(uint32_t) * indices.size());
+  mesh.m_vertices.count = vertices.size();
+  level.count = indices.size();
+  return true;
+}
+
+GeometryPool::Arena& GeometryPool::getArena(VAO::VertexType type) {
+  std::shared_ptr<Arena>& arena = m_arenas[static_cast<uint32_t>(type)];
+  if (not arena) {
+    arena = std::make_shared<Arena>(type);
+  }
+  return *arena;
+}
+
+size_t GeometryPool::getCapacity() const {
+  size_t bytes = 0;
+  for (const std::shared_ptr<Arena>& arena : m_arenas) {
+    if (arena) {
+      bytes += arena->vertexSize * arena->vertices.getCapacity() +
+               sizeof(uint32_t) * arena->indices.getCapacity();
+    }
+  }
+  return bytes;
+}
+
+size_t GeometryPool::getUsedBytes() const {
+  size_t bytes = 0;
+  for (const std::shared_ptr<Arena>& arena : m_arenas) {
+    if (arena) {
+      bytes += arena->vertexSize * arena->vertices.getUsed() +
+               sizeof(uint32_t) * arena->indices.getUsed();
+    }
+  }
+  return bytes;
+}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "pch.h"
+#include "render/buffer.h"
+#include "render/vao.h"
+
+namespace potatoengine {
+
+// vertices and indices of every mesh sub-allocated from a few large buffers,
+// one vertex and one index buffer per vertex layout behind a single VAO, so
+// the meshes of a layout are drawn without switching VAOs and a whole run of
+// them can be issued with one multi draw indirect call
+class GeometryPool {
+  public:
+    // the part of the buffers a draw call reads
+    struct Draw {
+        VAO* vao{};
+        uint32_t firstIndex{};
+        uint32_t indexCount{};
+        int32_t baseVertex{};
+        uint32_t vertexCount{};
+    };
+
+    // buffers and free ranges of one vertex layout
+    struct Arena;
+
+    // the vertices of a mesh and the indices of each of its levels of detail,
+    // they go back to the pool when the last owner releases it
+    class Mesh {
+      public:
+        ~Mesh();
+
+        // level 0 is the full mesh, levels past the last one get the last
+        Draw getDraw(uint32_t level = 0) const;
+        uint32_t getLevelCount() const { return m_levels.size(); }
+        std::map<std::string, std::string, NumericComparator> getInfo() const;
+
+      private:
+        friend class GeometryPool;
+
+        struct Range {
+            uint32_t offset{};   // in elements
+            uint32_t count{};    // drawn
+            uint32_t reserved{}; // updates can grow count up to it
+        };
+
+        std::shared_ptr<Arena> m_arena;
+        Range m_vertices;
+        std::vector<Range> m_levels;
+    };
+
+    // lods are the indices of the simplified levels after the full mesh,
+    // over the same vertices
+    std::shared_ptr<Mesh>
+    add(const std::vector<Vertex>& vertices,
+        const std::vector<uint32_t>& indices,
+        const std::vector<std::vector<uint32_t>>& lods = {});
+    std::shared_ptr<Mesh>
+    add(const std::vector<PackedVertex>& vertices,
+        const std::vector<uint32_t>& indices,
+        const std::vector<std::vector<uint32_t>>& lods = {});
+    std::shared_ptr<Mesh>
+    add(const std::vector<PackedSkinnedVertex>& vertices,
+        const std::vector<uint32_t>& indices,
+        const std::vector<std::vector<uint32_t>>& lods = {});
+    std::shared_ptr<Mesh> add(const std::vector<ShapeVertex>& vertices,
+                              const std::vector<uint32_t>& indices);
+    std::shared_ptr<Mesh> add(const std::vector<TerrainVertex>& vertices,
+                              const std::vector<uint32_t>& indices);
+    // rewrites the ranges of the mesh in place, false when the new data does
+    // not fit in them and the mesh has to be added again
+    bool update(Mesh& mesh, const std::vector<TerrainVertex>& vertices,
+                const std::vector<uint32_t>& indices);
+
+    // bytes reserved by the buffers of every layout
+    size_t getCapacity() const;
+    // bytes taken by live meshes
+    size_t getUsedBytes() const;
+
+  private:
+    std::shared_ptr<Mesh>
+    add(VAO::VertexType type, const void* vertices, uint32_t vertexCount,
+        const std::vector<const std::vector<uint32_t>*>& levels);
+    Arena& getArena(VAO::VertexType type);
+
+    std::array<std::shared_ptr<Arena>, VAO::VertexTypes> m_arenas;
+};
+
+}
@@ -0,0 +1,165 @@
+#include "render/lightClusters.h"
+
+#include "core/threadPool.h"
+
+namespace potatoengine {
+
+namespace {
+// below this binning is faster than waking up the workers
+constexpr uint32_t MinLightsPerJob = 64;
+
+uint32_t getClusterIndex(uint32_t x, uint32_t y, uint32_t z) {
+  return x + LightClusters::GridX * (y + LightClusters::GridY * z);
+}
+
+uint32_t getFirstSlice(uint32_t job, uint32_t jobs) {
+  return LightClusters::GridZ * job / jobs;
+}
+}
+
+void LightClusters::add(glm::vec3 position, glm::vec3 color, float range) {
+  m_lights.emplace_back(glm::vec4(position, range), glm::vec4(color, 1.f));
+}
+
+bool LightClusters::build(const glm::mat4& view, const glm::mat4& projection,
+                          ThreadPool& threadPool) {
+  if (not m_lightsBuffer) {
+    m_lightsBuffer = SSBO::Create(LightsBinding);
+    m_clustersBuffer = SSBO::Create(ClustersBinding);
+    m_indicesBuffer = SSBO::Create(IndicesBinding);
+  }
+  // only perspective projections have w = -z
+  if (projection[2][3] not_eq -1.f or projection[3][3] not_eq 0.f) {
+    m_indices.clear();
+    return false;
+  }
+  if (projection not_eq m_projection) {
+    float nearClip = projection[3][2] / (projection[2][2] - 1.f);
+    float farClip = projection[3][2] / (projection[2][2] + 1.f);
+    buildBounds(projection, nearClip, farClip);
+    m_projection = projection;
+  }
+
+  m_viewLights.clear();
+  for (const ClusterLight& light : m_lights) {
+    glm::vec4 position = view * glm::vec4(glm::vec3(light.positionRange), 1.f);
+    m_viewLights.emplace_back(glm::vec3(position), light.positionRange.w);
+  }
+
+  // each job bins a group of slices into its own index list, the clusters
+  // of different jobs never overlap so they can be written without locks
+  uint32_t jobs = std::clamp<uint32_t>(m_lights.size() / MinLightsPerJob, 1,
+                                       std::min(threadPool.getThreadCount() + 1,
+                                                GridZ));
+  m_jobIndices.resize(jobs);
+  std::vector<std::future<void>> futures;
+  futures.reserve(jobs - 1);
+  for (uint32_t job = 1; job < jobs; ++job) {
+    futures.emplace_back(threadPool.submit([this, job, jobs]() {
+      binSlices(getFirstSlice(job, jobs), getFirstSlice(job + 1, jobs),
+                m_jobIndices[job]);
+    }));
+  }
+  binSlices(0, getFirstSlice(1, jobs), m_jobIndices[0]);
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  m_indices.clear();
+  for (uint32_t job = 0; job < jobs; ++job) {
+    uint32_t base = m_indices.size();
+    uint32_t first = getClusterIndex(0, 0, getFirstSlice(job, jobs));
+    uint32_t last = getClusterIndex(0, 0, getFirstSlice(job + 1, jobs));
+    for (uint32_t i = first; i < last; ++i) {
+      m_clusters[i].offset += base;
+    }
+    m_indices.insert(m_indices.end(), m_jobIndices[job].begin(),
+                     m_jobIndices[job].end());
+  }
+
+  m_lightsBuffer->upload(m_lights.data(),
+                         sizeof(ClusterLight) * m_lights.size());
+  m_clustersBuffer->upload(m_clusters.data(),
+                           sizeof(Cluster) * m_clusters.size());
+  m_indicesBuffer->upload(m_indices.data(),
+                          sizeof(uint32_t) * m_indices.size());
+  return true;
+}
+
+void LightClusters::buildBounds(const glm::mat4& projection, float nearClip,
+                                float farClip) {
+  for (uint32_t z = 0; z <= GridZ; ++z) {
+    m_sliceDepths[z] =
+      nearClip * std::pow(farClip / nearClip, static_cast<float>(z) / GridZ);
+  }
+  float logRatio = std::log(farClip / nearClip);
+  m_depthScale = GridZ / logRatio;
+  m_depthBias = GridZ * std::log(nearClip) / logRatio;
+
+  // view space ray through a tile corner, scaled to reach depth 1
+  glm::mat4 inverse = glm::inverse(projection);
+  auto getRay = [&](uint32_t x, uint32_t y) {
+    glm::vec4 point =
+      inverse * glm::vec4(2.f * x / GridX - 1.f, 2.f * y / GridY - 1.f, -1.f,
+                          1.f);
+    glm::vec3 ray = glm::vec3(point) / point.w;
+    return ray / -ray.z;
+  };
+
+  for (uint32_t y = 0; y < GridY; ++y) {
+    for (uint32_t x = 0; x < GridX; ++x) {
+      std::array<glm::vec3, 4> rays{getRay(x, y), getRay(x + 1, y),
+                                    getRay(x, y + 1), getRay(x + 1, y + 1)};
+      for (uint32_t z = 0; z < GridZ; ++z) {
+        Bounds bounds{glm::vec3(std::numeric_limits<float>::max()),
+                      glm::vec3(std::numeric_limits<float>::lowest())};
+        for (const glm::vec3& ray : rays) {
+          for (float depth : {m_sliceDepths[z], m_sliceDepths[z + 1]}) {
+            bounds.min = glm::min(bounds.min, ray * depth);
+            bounds.max = glm::max(bounds.max, ray * depth);
+          }
+        }
+        m_bounds[getClusterIndex(x, y, z)] = bounds;
+      }
+    }
+  }
+}
+
+void LightClusters::binSlices(uint32_t firstSlice, uint32_t lastSlice,
+                              std::vector<uint32_t>& indices) {
+  indices.clear();
+  std::vector<uint32_t> sliceLights;
+  for (uint32_t z = firstSlice; z < lastSlice; ++z) {
+    // the view looks down -z, so depths are negated positions
+    sliceLights.clear();
+    for (uint32_t i = 0; i < m_viewLights.size(); ++i) {
+      float depth = -m_viewLights[i].z;
+      float range = m_viewLights[i].w;
+      if (depth + range >= m_sliceDepths[z] and
+          depth - range <= m_sliceDepths[z + 1]) {
+        sliceLights.emplace_back(i);
+      }
+    }
+
+    for (uint32_t y = 0; y < GridY; ++y) {
+      for (uint32_t x = 0; x < GridX; ++x) {
+        uint32_t index = getClusterIndex(x, y, z);
+        const Bounds& bounds = m_bounds[index];
+        Cluster& cluster = m_clusters[index];
+        cluster.offset = indices.size();
+        for (uint32_t light : sliceLights) {
+          glm::vec3 center = glm::vec3(m_viewLights[light]);
+          float range = m_viewLights[light].w;
+          glm::vec3 distance =
+            glm::clamp(center, bounds.min, bounds.max) - center;
+          if (glm::dot(distance, distance) <= range * range) {
+            indices.emplace_back(light);
+          }
+        }
+        cluster.count = indices.size() - cluster.offset;
+      }
+    }
+  }
+}
+
+}
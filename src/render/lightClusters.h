@@ -0,0 +1,79 @@
+#pragma once
+
+#define GLM_FORCE_CTOR_INIT
+#include <glm/glm.hpp>
+
+#include "pch.h"
+#include "render/buffer.h"
+
+namespace potatoengine {
+
+class ThreadPool;
+
+// std430 layout of the lights in the ClusterLights buffer of the shaders
+struct ClusterLight {
+    glm::vec4 positionRange{}; // world position and range
+    glm::vec4 color{};         // w unused
+};
+
+// view space grid over the frustum. x and y split the screen in tiles and z
+// splits the depth exponentially between the near and far planes so far
+// slices are not much bigger than near ones on screen. Every frame each light
+// is binned into the clusters its sphere touches and the shaders only loop
+// over the lights of the cluster of the fragment
+class LightClusters {
+  public:
+    static constexpr uint32_t GridX = 16;
+    static constexpr uint32_t GridY = 9;
+    static constexpr uint32_t GridZ = 24;
+    static constexpr uint32_t ClusterCount = GridX * GridY * GridZ;
+    static constexpr uint32_t LightsBinding = 1;
+    static constexpr uint32_t ClustersBinding = 2;
+    static constexpr uint32_t IndicesBinding = 3;
+
+    void clear() { m_lights.clear(); }
+    void add(glm::vec3 position, glm::vec3 color, float range);
+
+    // bins the lights and uploads the buffers, orthographic projections are
+    // not split and return false, the shaders skip the clusters then
+    bool build(const glm::mat4& view, const glm::mat4& projection,
+               ThreadPool& threadPool);
+
+    float getDepthScale() const { return m_depthScale; }
+    float getDepthBias() const { return m_depthBias; }
+    uint32_t getLightCount() const { return m_lights.size(); }
+    uint32_t getIndexCount() const { return m_indices.size(); }
+
+  private:
+    struct Cluster {
+        uint32_t offset{}; // in m_indices
+        uint32_t count{};
+    };
+
+    struct Bounds {
+        glm::vec3 min{};
+        glm::vec3 max{};
+    };
+
+    void buildBounds(const glm::mat4& projection, float nearClip,
+                     float farClip);
+    // fills the clusters of the slices with offsets relative to indices
+    void binSlices(uint32_t firstSlice, uint32_t lastSlice,
+                   std::vector<uint32_t>& indices);
+
+    std::vector<ClusterLight> m_lights;
+    std::vector<glm::vec4> m_viewLights; // view position and range
+    std::array<Cluster, ClusterCount> m_clusters{};
+    std::array<Bounds, ClusterCount> m_bounds{};
+    std::array<float, GridZ + 1> m_sliceDepths{};
+    std::vector<std::vector<uint32_t>> m_jobIndices;
+    std::vector<uint32_t> m_indices;
+    glm::mat4 m_projection{}; // the bounds were built for
+    float m_depthScale{};
+    float m_depthBias{};
+    std::unique_ptr<SSBO> m_lightsBuffer;
+    std::unique_ptr<SSBO> m_clustersBuffer;
+    std::unique_ptr<SSBO> m_indicesBuffer;
+};
+
+}
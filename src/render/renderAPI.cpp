@@ -122,4 +122,29 @@ void RenderAPI::DrawIndexed(const std::shared_ptr<VAO>& vao) {
   vao->unbind();
 }
 
+void RenderAPI::DrawIndexed(uint32_t count) {
+  glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+}
+
+void RenderAPI::DrawIndexedInstanced(uint32_t count, uint32_t instances) {
+  glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr,
+                          instances);
+}
+
+void RenderAPI::DrawIndexed(uint32_t count, uint32_t firstIndex,
+                            int32_t baseVertex) {
+  glDrawElementsBaseVertex(
+    GL_TRIANGLES, count, GL_UNSIGNED_INT,
+    reinterpret_cast<const void*>(sizeof(uint32_t) * firstIndex), baseVertex);
+}
+
+void RenderAPI::MultiDrawIndexedIndirect(uint32_t buffer, size_t offset,
+                                         uint32_t drawCount) {
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+  glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                              reinterpret_cast<const void*>(offset),
+                              drawCount, sizeof(DrawIndirectCommand));
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
 }
\ No newline at end of file
@@ -6,6 +6,15 @@
 #include "render/vao.h"
 
 namespace potatoengine {
+// layout of the commands read by MultiDrawIndexedIndirect
+struct DrawIndirectCommand {
+    uint32_t count{};
+    uint32_t instanceCount{};
+    uint32_t firstIndex{};
+    int32_t baseVertex{};
+    uint32_t baseInstance{}; // first element of the per instance attributes
+};
+
 class RenderAPI {
   public:
     static void Init();
@@ -22,5 +31,14 @@ class RenderAPI {
     static void ClearColor();
     static void ClearDepth();
     static void DrawIndexed(const std::shared_ptr<VAO>& vao);
+    // draws the vao that is already bound
+    static void DrawIndexed(uint32_t count);
+    static void DrawIndexedInstanced(uint32_t count, uint32_t instances);
+    // draws part of the index buffer of the bound vao
+    static void DrawIndexed(uint32_t count, uint32_t firstIndex,
+                            int32_t baseVertex);
+    // draws the commands stored in the buffer from the byte offset on
+    static void MultiDrawIndexedIndirect(uint32_t buffer, size_t offset,
+                                         uint32_t drawCount);
 };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "render/renderManager.h"
 
 #include "assets/texture.h"
+#include "core/application.h"
 #include "render/renderAPI.h"
 #include "imgui/imscene.h"
 
@@ -18,24 +19,84 @@ void RenderManager::onWindowResize(uint32_t w, uint32_t h) const {
 
 void RenderManager::beginScene(glm::mat4 view, glm::mat4 projection,
                           glm::vec3 cameraPosition) {
-  m_view = view;
-  m_projection = projection;
-  m_cameraPosition = cameraPosition;
+  m_frameData.view = view;
+  m_frameData.projection = projection;
+  m_frameData.cameraPosition = cameraPosition;
+  m_viewProjection = projection * view;
+  m_frustum = Frustum(m_viewProjection);
+  if (m_lightClusters.build(view, projection,
+                            *Application::Get().getThreadPool())) {
+    m_frameData.clusterGrid = {LightClusters::GridX, LightClusters::GridY,
+                               LightClusters::GridZ, 0};
+    m_frameData.clusterScale = m_lightClusters.getDepthScale();
+    m_frameData.clusterBias = m_lightClusters.getDepthBias();
+  } else {
+    m_frameData.clusterGrid = {};
+  }
+  if (not m_frameUBO) {
+    m_frameUBO = UBO::Create(sizeof(FrameData), FrameData::Binding);
+  }
+  m_frameUBO->update(&m_frameData, sizeof(FrameData));
+  if (not m_streamBuffer) {
+    m_streamBuffer = RingBuffer::Create(StreamFrameSize);
+  }
+  m_streamBuffer->beginFrame();
+}
+
+void RenderManager::endScene() {
+  ENGINE_ASSERT(m_packets.empty(), "endScene called before flushing {} packets",
+                m_packets.size());
+  m_streamBuffer->endFrame();
+}
+
+void RenderManager::setFog(glm::vec3 color, float density, float gradient) {
+  m_frameData.useFog = 1.f;
+  m_frameData.fogColor = color;
+  m_frameData.fogDensity = density;
+  m_frameData.fogGradient = gradient;
+}
+
+void RenderManager::disableFog() { m_frameData.useFog = 0.f; }
+
+void RenderManager::clearLights() {
+  m_frameData.lightCount = 0;
+  m_frameData.lights = {};
+  m_lightClusters.clear();
 }
 
-void RenderManager::endScene() {}
+// lights without range past FrameData::MaxLights are ignored
+void RenderManager::addLight(glm::vec3 position, glm::vec3 color,
+                             float range) {
+  if (range > 0.f) {
+    m_lightClusters.add(position, color, range);
+    return;
+  }
+  if (m_frameData.lightCount == FrameData::MaxLights) {
+    return;
+  }
+  m_frameData.lights[m_frameData.lightCount++] = {glm::vec4(position, 1.f),
+                                                  glm::vec4(color, 1.f)};
+}
 
 void RenderManager::addShaderProgram(
   std::string&& name,
   const std::unique_ptr<assets::AssetsManager>& assets_manager) {
   auto newShaderProgram = ShaderProgram::Create(std::string(name));
-  const auto& vs = assets_manager->get<assets::Shader>("v" + name);
-  const auto& fs = assets_manager->get<assets::Shader>("f" + name);
-  newShaderProgram->attach(*vs);
-  newShaderProgram->attach(*fs);
-  newShaderProgram->link();
-  newShaderProgram->detach(*vs);
-  newShaderProgram->detach(*fs);
+  // compute programs are made of a single shader
+  if (assets_manager->contains<assets::Shader>("c" + name)) {
+    const auto& cs = assets_manager->get<assets::Shader>("c" + name);
+    newShaderProgram->attach(*cs);
+    newShaderProgram->link();
+    newShaderProgram->detach(*cs);
+  } else {
+    const auto& vs = assets_manager->get<assets::Shader>("v" + name);
+    const auto& fs = assets_manager->get<assets::Shader>("f" + name);
+    newShaderProgram->attach(*vs);
+    newShaderProgram->attach(*fs);
+    newShaderProgram->link();
+    newShaderProgram->detach(*vs);
+    newShaderProgram->detach(*fs);
+  }
   ENGINE_TRACE("Shader {} linked!", name);
   m_shaderPrograms.emplace(std::move(name), std::move(newShaderProgram));
 }
@@ -49,7 +110,7 @@ void RenderManager::deleteFramebuffer(std::string_view name) {
   m_framebuffers.erase(name.data());
 }
 
-void RenderManager::renderFBO(const std::shared_ptr<VAO>& vao,
+void RenderManager::renderFBO(const GeometryPool::Draw& draw,
                          std::string_view fbo) {
   auto& sp = getShaderProgram("fbo");
 
@@ -57,18 +118,16 @@ void RenderManager::renderFBO(const std::shared_ptr<VAO>& vao,
   sp->setInt("screenTexture", 100);
   m_framebuffers.at(fbo.data())->getColorTexture()->bindSlot(100);
 
-  RenderAPI::DrawIndexed(vao);
+  draw.vao->bind();
+  RenderAPI::DrawIndexed(draw.indexCount, draw.firstIndex, draw.baseVertex);
+  draw.vao->unbind();
 
-  m_drawCalls++;
-  m_triangles += vao->getEBO()->getCount() / 3;
-  for (const auto& vbo : vao->getVBOs()) {
-    m_vertices += vbo->getCount();
-  }
-  m_indices += vao->getEBO()->getCount();
+  ++m_drawCalls;
+  countGeometry(draw);
   sp->unuse();
 }
 
-void RenderManager::renderInsideImGui(const std::shared_ptr<VAO>& vao,
+void RenderManager::renderInsideImGui(const GeometryPool::Draw& draw,
                                  std::string_view fbo, std::string_view title,
                                  glm::vec2 size, glm::vec2 position,
                                  bool fitToWindow) {
@@ -76,34 +135,277 @@ void RenderManager::renderInsideImGui(const std::shared_ptr<VAO>& vao,
   renderScene(fbo_->getColorTexture()->getID(), title, size, position,
                   fitToWindow);
 
-  m_drawCalls++;
-  m_triangles += vao->getEBO()->getCount() / 3;
-  for (const auto& vbo : vao->getVBOs()) {
-    m_vertices += vbo->getCount();
+  ++m_drawCalls;
+  countGeometry(draw);
+}
+
+void RenderManager::submit(const GeometryPool::Draw& draw,
+                           const glm::mat4& transform,
+                           std::string_view shaderProgram, uint32_t material,
+                           const AABB& bounds, uint32_t lod,
+                           bool inFrustum) {
+  ENGINE_ASSERT(material < m_materials.size(), "Material {} not found!",
+                material);
+  RenderMaterial::Layer layer = m_materials[material].layer;
+  // skyboxes are drawn around the camera whatever their transform is
+  uint32_t boundsIndex = RenderPacket::NoBounds;
+  AABB worldBounds;
+  if (bounds.isValid() and layer not_eq RenderMaterial::Layer::Skybox) {
+    worldBounds = bounds.transform(transform);
+    boundsIndex = inFrustum ? m_frustumBounds.add(worldBounds)
+                            : m_bounds.add(worldBounds);
+  }
+  // transparent packets are blended back to front by the view depth of
+  // their center, or of their origin when they have no bounds
+  float depth = 0.f;
+  if (layer == RenderMaterial::Layer::Transparent) {
+    glm::vec3 center = worldBounds.isValid() ? worldBounds.getCenter()
+                                             : glm::vec3(transform[3]);
+    depth = -(m_frameData.view * glm::vec4(center, 1.f)).z;
+  }
+  m_packets.emplace_back(layer, getShaderProgram(shaderProgram).get(),
+                         material, draw,
+                         static_cast<uint32_t>(m_packets.size()), boundsIndex,
+                         inFrustum, lod, depth, transform);
+}
+
+void RenderManager::cull() {
+  m_submittedPackets += m_packets.size();
+  auto hasBounds = [](const RenderPacket& p) {
+    return p.bounds not_eq RenderPacket::NoBounds;
+  };
+  auto getBounds = [&](const RenderPacket& p) {
+    return p.inFrustum ? m_frustumBounds.get(p.bounds) : m_bounds.get(p.bounds);
+  };
+  if (m_bounds.size() > 0) {
+    m_frustum.cull(m_bounds, m_visible);
+    m_culledPackets += std::erase_if(m_packets, [&](const RenderPacket& p) {
+      return hasBounds(p) and not p.inFrustum and not m_visible[p.bounds];
+    });
+  }
+  if (not m_depthPyramid.empty() and
+      m_bounds.size() + m_frustumBounds.size() > 0) {
+    m_occludedPackets += std::erase_if(m_packets, [&](const RenderPacket& p) {
+      return hasBounds(p) and m_depthPyramid.isOccluded(getBounds(p));
+    });
   }
-  m_indices += vao->getEBO()->getCount();
+  m_bounds.clear();
+  m_frustumBounds.clear();
 }
 
-void RenderManager::render(const std::shared_ptr<VAO>& vao,
-                      const glm::mat4& transform,
-                      std::string_view shaderProgram) {
-  auto& sp = getShaderProgram(shaderProgram);
+void RenderManager::flush() {
+  using Layer = RenderMaterial::Layer;
+  cull();
+  std::ranges::sort(m_packets, [](const RenderPacket& lhs,
+                                  const RenderPacket& rhs) {
+    if (lhs.layer not_eq rhs.layer) {
+      return lhs.layer < rhs.layer;
+    }
+    if (lhs.layer == Layer::Transparent) {
+      return lhs.depth not_eq rhs.depth ? lhs.depth > rhs.depth
+                                        : lhs.order < rhs.order;
+    }
+    return std::tuple(lhs.shaderProgram->getID(), lhs.material,
+                      lhs.draw.vao->getID(), lhs.draw.firstIndex,
+                      lhs.draw.baseVertex, lhs.order) <
+           std::tuple(rhs.shaderProgram->getID(), rhs.material,
+                      rhs.draw.vao->getID(), rhs.draw.firstIndex,
+                      rhs.draw.baseVertex, rhs.order);
+  });
 
-  sp->use();
-  sp->setMat4("projection", m_projection);
-  sp->setMat4("view", m_view);
-  sp->setVec3("cameraPosition", m_cameraPosition);
-  sp->setMat4("model", transform);
+  // runs of packets with the same shader, material and vao are drawn with
+  // one multi draw indirect call when the shader can read the model matrix
+  // per instance, the packets of the same mesh become one instanced command
+  auto sameMesh = [](const GeometryPool::Draw& lhs,
+                     const GeometryPool::Draw& rhs) {
+    return lhs.firstIndex == rhs.firstIndex and
+           lhs.indexCount == rhs.indexCount and
+           lhs.baseVertex == rhs.baseVertex;
+  };
+  m_batches.clear();
+  m_commands.clear();
+  uint32_t instances = 0;
+  ShaderProgram* instancedSp = nullptr;
+  bool canInstance = false;
+  for (uint32_t first = 0; first < m_packets.size();) {
+    const RenderPacket& packet = m_packets[first];
+    if (packet.shaderProgram not_eq instancedSp) {
+      instancedSp = packet.shaderProgram;
+      canInstance = instancedSp->getUniform("useInstancing").isValid();
+    }
+    uint32_t last = first + 1;
+    if (canInstance and packet.layer not_eq Layer::Transparent) {
+      while (last < m_packets.size() and
+             m_packets[last].layer == packet.layer and
+             m_packets[last].shaderProgram == packet.shaderProgram and
+             m_packets[last].material == packet.material and
+             m_packets[last].draw.vao == packet.draw.vao) {
+        ++last;
+      }
+    }
+    uint32_t count = last - first;
+    if (count == 1) {
+      m_batches.emplace_back(first, 1, 0, 0, 0);
+    } else {
+      uint32_t commandOffset = m_commands.size();
+      for (uint32_t i = first; i < last; ++i) {
+        const GeometryPool::Draw& draw = m_packets[i].draw;
+        if (i > first and sameMesh(m_packets[i - 1].draw, draw)) {
+          ++m_commands.back().instanceCount;
+        } else {
+          // baseInstance picks the model matrix of the first instance
+          m_commands.push_back({draw.indexCount, 1, draw.firstIndex,
+                                draw.baseVertex, instances + i - first});
+        }
+      }
+      m_batches.emplace_back(first, count, instances, commandOffset,
+                             m_commands.size() - commandOffset);
+      instances += count;
+    }
+    first = last;
+  }
+  // the model matrices and the commands go straight into the mapped memory
+  // of the frame, in one allocation so both end up in the same buffer
+  RingBuffer::Allocation allocation;
+  size_t commandsOffset = 0;
+  if (instances > 0) {
+    ENGINE_ASSERT(m_streamBuffer, "flush called outside of a scene");
+    size_t matricesSize = sizeof(glm::mat4) * instances;
+    allocation = m_streamBuffer->allocate(
+      matricesSize + sizeof(DrawIndirectCommand) * m_commands.size(),
+      alignof(glm::mat4));
+    auto* matrices = static_cast<glm::mat4*>(allocation.data);
+    for (const Batch& batch : m_batches) {
+      if (batch.commandCount == 0) {
+        continue;
+      }
+      for (uint32_t i = 0; i < batch.count; ++i) {
+        matrices[batch.instanceOffset + i] =
+          m_packets[batch.first + i].transform;
+      }
+    }
+    std::memcpy(static_cast<std::byte*>(allocation.data) + matricesSize,
+                m_commands.data(),
+                sizeof(DrawIndirectCommand) * m_commands.size());
+    commandsOffset = allocation.offset + matricesSize;
+  }
 
-  RenderAPI::DrawIndexed(vao);
+  ShaderProgram* sp = nullptr;
+  RenderMaterial* material = nullptr;
+  VAO* vao = nullptr;
+  Layer layer = Layer::Opaque;
+  UniformHandle model;
+  UniformHandle useInstancing;
+  for (const Batch& batch : m_batches) {
+    const RenderPacket& packet = m_packets[batch.first];
+    if (packet.layer not_eq layer) {
+      if (layer == Layer::Skybox) {
+        RenderAPI::SetDepthLess();
+      }
+      if (packet.layer == Layer::Skybox) {
+        RenderAPI::SetDepthLEqual();
+      } else if (packet.layer == Layer::Transparent) {
+        // transparent packets do not hide what is behind them
+        if (captureDepth()) {
+          sp = nullptr;
+        }
+        RenderAPI::ToggleCulling(false);
+      }
+      layer = packet.layer;
+    }
+    if (packet.shaderProgram not_eq sp) {
+      sp = packet.shaderProgram;
+      sp->use();
+      model = sp->getUniform("model");
+      useInstancing = sp->getUniform("useInstancing");
+      material = nullptr; // uniforms are per program
+      ++m_shaderChanges;
+    }
+    if (&m_materials[packet.material] not_eq material) {
+      if (material and material->unbind) {
+        material->unbind();
+      }
+      material = &m_materials[packet.material];
+      auto& program = getShaderProgram(sp->getName());
+      if (material->bind) {
+        material->bind(program);
+      }
+      sp->use();
+      ++m_materialChanges;
+    }
+    if (packet.draw.vao not_eq vao) {
+      vao = packet.draw.vao;
+      vao->bind();
+      ++m_vaoChanges;
+    }
+
+    for (uint32_t i = batch.first; i < batch.first + batch.count; ++i) {
+      const RenderPacket& drawn = m_packets[i];
+      if (drawn.lod >= m_lodTriangles.size()) {
+        m_lodTriangles.resize(drawn.lod + 1);
+      }
+      m_lodTriangles[drawn.lod] += drawn.draw.indexCount / 3;
+      countGeometry(drawn.draw);
+    }
+    ++m_drawCalls;
+    if (batch.commandCount == 0) {
+      sp->setFloat(useInstancing, 0.f);
+      sp->setMat4(model, packet.transform);
+      RenderAPI::DrawIndexed(packet.draw.indexCount, packet.draw.firstIndex,
+                             packet.draw.baseVertex);
+    } else {
+      sp->setFloat(useInstancing, 1.f);
+      vao->setInstanceBuffer(*m_streamBuffer, allocation.offset);
+      RenderAPI::MultiDrawIndexedIndirect(
+        m_streamBuffer->getID(),
+        commandsOffset + sizeof(DrawIndirectCommand) * batch.commandOffset,
+        batch.commandCount);
+      ++m_multiDrawCalls;
+      m_indirectCommands += batch.commandCount;
+      m_drawnInstances += batch.count;
+    }
+  }
+
+  if (vao) {
+    vao->unbind();
+  }
+  captureDepth();
+  if (material and material->unbind) {
+    material->unbind();
+  }
+  if (layer == Layer::Skybox) {
+    RenderAPI::SetDepthLess();
+  } else if (layer == Layer::Transparent) {
+    RenderAPI::ToggleCulling(true);
+  }
+  if (sp) {
+    sp->unuse();
+  }
+  m_packets.clear();
+  m_materials.clear();
+  m_materialIndices.clear();
+}
 
-  m_drawCalls++;
-  m_triangles += vao->getEBO()->getCount() / 3;
-  for (const auto& vbo : vao->getVBOs()) {
-    m_vertices += vbo->getCount();
+bool RenderManager::captureDepth() {
+  if (m_occlusionFBO.empty()) {
+    return false;
   }
-  m_indices += vao->getEBO()->getCount();
-  sp->unuse(); // DONT unuse before the draw call
+  auto fbo = m_framebuffers.find(m_occlusionFBO);
+  auto sp = m_shaderPrograms.find("hiz");
+  m_occlusionFBO.clear();
+  if (fbo == m_framebuffers.end() or sp == m_shaderPrograms.end() or
+      not fbo->second->getDepthTexture()) {
+    return false;
+  }
+  m_depthPyramid.build(*fbo->second, *sp->second, m_viewProjection);
+  return true;
+}
+
+void RenderManager::countGeometry(const GeometryPool::Draw& draw,
+                                  uint32_t instances) {
+  m_triangles += draw.indexCount / 3 * instances;
+  m_vertices += draw.vertexCount * instances;
+  m_indices += draw.indexCount * instances;
 }
 
 void RenderManager::clear() {
@@ -112,7 +414,16 @@ void RenderManager::clear() {
     // to avoid problems after using scenes with fbo
     RenderAPI::ToggleDepthTest(true);
   }
+  m_packets.clear();
+  m_bounds.clear();
+  m_frustumBounds.clear();
+  m_depthPyramid.clear();
+  m_occlusionFBO.clear();
+  m_materials.clear();
+  m_materialIndices.clear();
   m_shaderPrograms.clear();
+  m_frameData = {};
+  m_lightClusters.clear();
 }
 
 std::unique_ptr<RenderManager> RenderManager::Create() {
@@ -130,19 +441,67 @@ const std::map<std::string, std::string, NumericComparator>&
 RenderManager::getMetrics() {
   m_metrics["Framebuffers"] = std::to_string(m_framebuffers.size());
   m_metrics["Shader programs"] = std::to_string(m_shaderPrograms.size());
+  m_metrics["Meshes submitted"] = std::to_string(m_submittedPackets);
+  m_metrics["Meshes culled"] = std::to_string(m_culledPackets);
+  m_metrics["Meshes occluded"] = std::to_string(m_occludedPackets);
   m_metrics["Draw calls"] = std::to_string(m_drawCalls);
+  m_metrics["Multi draw indirect calls"] = std::to_string(m_multiDrawCalls);
+  m_metrics["Indirect commands"] = std::to_string(m_indirectCommands);
+  m_metrics["Instances"] = std::to_string(m_drawnInstances);
+  m_metrics["Geometry pool KB"] =
+    std::to_string(m_geometryPool.getCapacity() / 1024);
+  m_metrics["Geometry pool KB used"] =
+    std::to_string(m_geometryPool.getUsedBytes() / 1024);
+  if (m_streamBuffer) {
+    m_metrics["Stream buffer KB per frame"] =
+      std::to_string(m_streamBuffer->getFrameSize() / 1024);
+  }
+  m_metrics["Shader changes"] = std::to_string(m_shaderChanges);
+  m_metrics["Material changes"] = std::to_string(m_materialChanges);
+  m_metrics["VAO changes"] = std::to_string(m_vaoChanges);
+  m_metrics["State changes"] =
+    std::to_string(m_shaderChanges + m_materialChanges + m_vaoChanges);
+  uint32_t uniformWrites = 0;
+  uint32_t skippedUniformWrites = 0;
+  for (const auto& [name, sp] : m_shaderPrograms) {
+    uniformWrites += sp->getUniformWrites();
+    skippedUniformWrites += sp->getSkippedUniformWrites();
+  }
+  m_metrics["Uniform writes"] = std::to_string(uniformWrites);
+  m_metrics["Uniform writes skipped"] = std::to_string(skippedUniformWrites);
+  m_metrics["Lights"] = std::to_string(m_frameData.lightCount +
+                                       m_lightClusters.getLightCount());
+  m_metrics["Clustered light indices"] =
+    std::to_string(m_lightClusters.getIndexCount());
   m_metrics["Triangles"] = std::to_string(m_triangles);
   m_metrics["Vertices"] = std::to_string(m_vertices);
   m_metrics["Indices"] = std::to_string(m_indices);
+  for (uint32_t i = 0; i < m_lodTriangles.size(); ++i) {
+    m_metrics["LOD " + std::to_string(i) + " triangles"] =
+      std::to_string(m_lodTriangles[i]);
+  }
 
   return m_metrics;
 }
 
 void RenderManager::resetMetrics() {
+  m_submittedPackets = 0;
+  m_culledPackets = 0;
+  m_occludedPackets = 0;
   m_drawCalls = 0;
+  m_multiDrawCalls = 0;
+  m_indirectCommands = 0;
+  m_drawnInstances = 0;
+  m_shaderChanges = 0;
+  m_materialChanges = 0;
+  m_vaoChanges = 0;
+  for (const auto& [name, sp] : m_shaderPrograms) {
+    sp->resetUniformMetrics();
+  }
   m_triangles = 0;
   m_vertices = 0;
   m_indices = 0;
+  m_lodTriangles.clear();
   m_metrics.clear();
 }
 }
\ No newline at end of file
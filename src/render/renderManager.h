@@ -6,12 +6,65 @@
 #include "assets/assetsManager.h"
 #include "pch.h"
 #include "render/framebuffer.h"
+#include "render/depthPyramid.h"
+#include "render/frustum.h"
+#include "render/geometryPool.h"
+#include "render/lightClusters.h"
+#include "render/renderAPI.h"
 #include "render/shaderProgram.h"
 #include "render/vao.h"
+#include "utils/aabb.h"
 #include "utils/numericComparator.h"
 
 namespace potatoengine {
 
+// std140 layout of the FrameData uniform block declared by the shaders, it
+// is written once per frame and read by every program
+struct FrameData {
+    static constexpr uint32_t Binding = 0;
+    static constexpr uint32_t MaxLights = 8;
+
+    struct Light {
+        glm::vec4 position{}; // w unused
+        glm::vec4 color{};    // w unused
+    };
+
+    glm::mat4 projection{};
+    glm::mat4 view{};
+    glm::vec3 cameraPosition{};
+    float useFog{};
+    glm::vec3 fogColor{};
+    float fogDensity{};
+    float fogGradient{};
+    int lightCount{};
+    float padding[2]{}; // arrays of structs start at 16 bytes
+    std::array<Light, MaxLights> lights{}; // without range, never clustered
+    glm::uvec4 clusterGrid{}; // x, y, z, w unused. z is 0 without clusters
+    float clusterScale{};     // slice = log(depth) * scale - bias
+    float clusterBias{};
+    float clusterPadding[2]{};
+};
+static_assert(offsetof(FrameData, cameraPosition) == 128 and
+                offsetof(FrameData, fogColor) == 144 and
+                offsetof(FrameData, lights) == 176 and
+                offsetof(FrameData, clusterGrid) == 432,
+              "FrameData does not match the std140 layout");
+
+// state shared by the packets drawn with it, it is bound once for each run of
+// packets with the same shader and material instead of once per draw
+struct RenderMaterial {
+    // draw order, skyboxes go after the opaque geometry so most of their
+    // fragments fail the depth test, and transparent packets keep the order
+    // they were submitted in
+    enum class Layer { Opaque, Skybox, Transparent };
+
+    // it can reset the uniforms of the program, the per frame ones live in
+    // the FrameData block and are not affected
+    std::function<void(const std::unique_ptr<ShaderProgram>&)> bind;
+    std::function<void()> unbind;
+    Layer layer{Layer::Opaque};
+};
+
 class RenderManager {
   public:
     void init() const;
@@ -21,9 +74,31 @@ class RenderManager {
 
     void onWindowResize(uint32_t w, uint32_t h) const;
 
+    // uploads the frame data, the fog and lights set before are included,
+    // and sets the frustum the packets are culled with. It waits for the gpu
+    // to release the stream buffer region of the frame, endScene fences it.
+    // The packets are drawn by flush, which has to come before endScene
     void beginScene(glm::mat4 view, glm::mat4 projection,
                     glm::vec3 cameraPosition);
     void endScene();
+    // persistently mapped buffer for the data streamed every frame, null
+    // before the first scene
+    RingBuffer* getStreamBuffer() const { return m_streamBuffer.get(); }
+    // shared buffers every mesh takes its vertices and indices from
+    GeometryPool& getGeometryPool() { return m_geometryPool; }
+    const Frustum& getFrustum() const { return m_frustum; }
+    // the opaque depth the next flush draws into the fbo is reduced into the
+    // depth pyramid with the "hiz" compute program when the scene has it,
+    // the packets of the following frames hidden behind it are not drawn
+    void setOcclusionFramebuffer(std::string_view fbo) { m_occlusionFBO = fbo; }
+    uint32_t getOccludedCount() const { return m_occludedPackets; }
+    void setFog(glm::vec3 color, float density, float gradient);
+    void disableFog();
+    void clearLights();
+    // lights without range light everything and are limited to
+    // FrameData::MaxLights, the ones with range fade out at it and are
+    // clustered so there can be any number of them
+    void addLight(glm::vec3 position, glm::vec3 color, float range = 0.f);
 
     void addShaderProgram(
       std::string&& name,
@@ -42,10 +117,35 @@ class RenderManager {
     const std::unique_ptr<ShaderProgram>&
     getShaderProgram(std::string_view shaderProgram);
 
-    void render(const std::shared_ptr<VAO>& vao, const glm::mat4& transform,
-                std::string_view shaderProgram);
-    void renderFBO(const std::shared_ptr<VAO>& vao, std::string_view fbo);
-    void renderInsideImGui(const std::shared_ptr<VAO>& vao,
+    using MaterialKey = std::array<const void*, 3>;
+
+    // index of the material registered under key since the last flush,
+    // makeMaterial is only called the first time
+    template <class F>
+    uint32_t getMaterial(const MaterialKey& key, F&& makeMaterial) {
+      auto [it, inserted] = m_materialIndices.try_emplace(
+        key, static_cast<uint32_t>(m_materials.size()));
+      if (inserted) {
+        m_materials.emplace_back(makeMaterial());
+      }
+      return it->second;
+    }
+    // queues a draw, the mesh it comes from must stay alive until the next
+    // flush. Packets with valid bounds in model space are culled against the
+    // frustum, skyboxes never are. lod is the level of detail of the draw,
+    // only used for the metrics. inFrustum skips the frustum test for draws
+    // the caller already found in it, they are still tested for occlusion
+    void submit(const GeometryPool::Draw& draw, const glm::mat4& transform,
+                std::string_view shaderProgram, uint32_t material,
+                const AABB& bounds = {}, uint32_t lod = 0,
+                bool inFrustum = false);
+    // drops the packets outside the frustum, sorts the rest by layer,
+    // shader, material, vao and mesh, the transparent ones back to front,
+    // and draws them changing only the state that differs from the previous
+    // packet
+    void flush();
+    void renderFBO(const GeometryPool::Draw& draw, std::string_view fbo);
+    void renderInsideImGui(const GeometryPool::Draw& draw,
                            std::string_view fbo, std::string_view title,
                            glm::vec2 size, glm::vec2 position,
                            bool fitToWindow);
@@ -57,17 +157,77 @@ class RenderManager {
     static std::unique_ptr<RenderManager> Create();
 
   private:
-    glm::mat4 m_view{};
-    glm::mat4 m_projection{};
-    glm::vec3 m_cameraPosition{};
+    // initial size of each frame region of the stream buffer, it grows when
+    // a frame needs more
+    static constexpr size_t StreamFrameSize = 1 << 20;
+
+    struct RenderPacket {
+        RenderMaterial::Layer layer;
+        ShaderProgram* shaderProgram;
+        uint32_t material;
+        GeometryPool::Draw draw;
+        uint32_t order;  // submission order
+        uint32_t bounds; // in m_bounds, NoBounds when it is not culled
+        bool inFrustum;  // bounds in m_frustumBounds, only occlusion tested
+        uint32_t lod;
+        float depth; // view depth, only for transparent packets
+        glm::mat4 transform;
+
+        static constexpr uint32_t NoBounds =
+          std::numeric_limits<uint32_t>::max();
+    };
+
+    // packets drawn with one call, a multi draw indirect one with a command
+    // per mesh when there is more than one
+    struct Batch {
+        uint32_t first;
+        uint32_t count;
+        uint32_t instanceOffset; // in the instance matrices of the flush
+        uint32_t commandOffset;  // in m_commands
+        uint32_t commandCount;   // 0 for a direct draw
+    };
+
+    void cull();
+    // builds the depth pyramid from the occlusion fbo, true when it did and
+    // the bound shader program changed
+    bool captureDepth();
+    void countGeometry(const GeometryPool::Draw& draw, uint32_t instances = 1);
+
+    FrameData m_frameData;
+    std::unique_ptr<UBO> m_frameUBO;
+    LightClusters m_lightClusters;
     std::unordered_map<std::string, std::unique_ptr<ShaderProgram>>
       m_shaderPrograms;
     std::unordered_map<std::string, std::unique_ptr<FBO>> m_framebuffers;
     std::map<std::string, std::string, NumericComparator> m_metrics;
+    std::vector<RenderPacket> m_packets;
+    Frustum m_frustum;
+    glm::mat4 m_viewProjection{};
+    DepthPyramid m_depthPyramid;
+    std::string m_occlusionFBO;
+    AABBBatch m_bounds;        // world space
+    AABBBatch m_frustumBounds; // world space, of the inFrustum packets
+    std::vector<uint8_t> m_visible;
+    std::vector<RenderMaterial> m_materials;
+    std::map<MaterialKey, uint32_t> m_materialIndices;
+    std::vector<Batch> m_batches;
+    std::vector<DrawIndirectCommand> m_commands;
+    GeometryPool m_geometryPool;
+    std::unique_ptr<RingBuffer> m_streamBuffer; // data rewritten every frame
+    uint32_t m_submittedPackets{};
+    uint32_t m_culledPackets{};
+    uint32_t m_occludedPackets{};
     uint32_t m_drawCalls{};
+    uint32_t m_multiDrawCalls{};
+    uint32_t m_indirectCommands{};
+    uint32_t m_drawnInstances{};
+    uint32_t m_shaderChanges{};
+    uint32_t m_materialChanges{};
+    uint32_t m_vaoChanges{};
     uint32_t m_triangles{};
     uint32_t m_vertices{};
     uint32_t m_indices{};
+    std::vector<uint32_t> m_lodTriangles; // drawn triangles per level
     bool m_shouldReorder{};
 };
 }
\ No newline at end of file
@@ -1,8 +1,26 @@
 #include "render/shaderProgram.h"
 
+#include <cstring>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace potatoengine {
+
+namespace {
+// images are bound to their unit with glBindImageTexture, their uniforms
+// only hold the binding of the layout and are never set
+std::string_view ImageTypeName(uint32_t type) {
+  switch (type) {
+  case GL_IMAGE_2D: return "image2D";
+  case GL_IMAGE_3D: return "image3D";
+  case GL_IMAGE_CUBE: return "imageCube";
+  case GL_IMAGE_2D_ARRAY: return "image2DArray";
+  case GL_INT_IMAGE_2D: return "iimage2D";
+  case GL_UNSIGNED_INT_IMAGE_2D: return "uimage2D";
+  default: return {};
+  }
+}
+}
+
 ShaderProgram::ShaderProgram(std::string&& name)
   : m_id(glCreateProgram()), m_name(std::move(name)) {}
 
@@ -34,6 +52,15 @@ void ShaderProgram::link() {
                   std::string(shaderProgramInfoLog.data()));
   }
   m_activeUniforms = getActiveUniforms();
+  m_uniformIndices.clear();
+  for (uint32_t i = 0; i < m_activeUniforms.size(); ++i) {
+    const std::string& name = m_activeUniforms[i].name;
+    m_uniformIndices.emplace(name, i);
+    // arrays are listed as name[0] but can be set by their name
+    if (name.ends_with("[0]")) {
+      m_uniformIndices.emplace(name.substr(0, name.size() - 3), i);
+    }
+  }
   printActiveUniforms();
 }
 
@@ -41,30 +68,91 @@ void ShaderProgram::use() { glUseProgram(m_id); }
 
 void ShaderProgram::unuse() { glUseProgram(0); }
 
+UniformHandle ShaderProgram::getUniform(std::string_view name) const {
+  auto it = m_uniformIndices.find(name);
+  return it == m_uniformIndices.end() ? UniformHandle{}
+                                      : UniformHandle{it->second};
+}
+
+bool ShaderProgram::updateValue(UniformHandle uniform, const void* value,
+                                size_t size) {
+  if (not uniform.isValid()) {
+    return false;
+  }
+  ActiveUniform& activeUniform = m_activeUniforms[uniform.index];
+  if (activeUniform.written and
+      std::memcmp(activeUniform.value.data(), value, size) == 0) {
+    ++m_skippedUniformWrites;
+    return false;
+  }
+  std::memcpy(activeUniform.value.data(), value, size);
+  activeUniform.written = true;
+  ++m_uniformWrites;
+  return true;
+}
+
+void ShaderProgram::setInt(UniformHandle uniform, int value) {
+  if (updateValue(uniform, &value, sizeof(value))) {
+    glProgramUniform1i(m_id, m_activeUniforms[uniform.index].location, value);
+  }
+}
+
+void ShaderProgram::setFloat(UniformHandle uniform, float value) {
+  if (updateValue(uniform, &value, sizeof(value))) {
+    glProgramUniform1f(m_id, m_activeUniforms[uniform.index].location, value);
+  }
+}
+
+void ShaderProgram::setVec2(UniformHandle uniform, const glm::vec2& vec) {
+  if (updateValue(uniform, glm::value_ptr(vec), sizeof(vec))) {
+    glProgramUniform2f(m_id, m_activeUniforms[uniform.index].location, vec.x,
+                       vec.y);
+  }
+}
+
+void ShaderProgram::setVec3(UniformHandle uniform, const glm::vec3& vec) {
+  if (updateValue(uniform, glm::value_ptr(vec), sizeof(vec))) {
+    glProgramUniform3f(m_id, m_activeUniforms[uniform.index].location, vec.x,
+                       vec.y, vec.z);
+  }
+}
+
+void ShaderProgram::setVec4(UniformHandle uniform, const glm::vec4& vec) {
+  if (updateValue(uniform, glm::value_ptr(vec), sizeof(vec))) {
+    glProgramUniform4f(m_id, m_activeUniforms[uniform.index].location, vec.x,
+                       vec.y, vec.z, vec.w);
+  }
+}
+
+void ShaderProgram::setMat4(UniformHandle uniform, const glm::mat4& mat) {
+  if (updateValue(uniform, glm::value_ptr(mat), sizeof(mat))) {
+    glProgramUniformMatrix4fv(m_id, m_activeUniforms[uniform.index].location,
+                              1, GL_FALSE, glm::value_ptr(mat));
+  }
+}
+
 void ShaderProgram::setInt(std::string_view name, int value) {
-  glUniform1i(glGetUniformLocation(m_id, name.data()), value);
+  setInt(getUniform(name), value);
 }
 
 void ShaderProgram::setFloat(std::string_view name, float value) {
-  glUniform1f(glGetUniformLocation(m_id, name.data()), value);
+  setFloat(getUniform(name), value);
 }
 
 void ShaderProgram::setVec2(std::string_view name, const glm::vec2& vec) {
-  glUniform2f(glGetUniformLocation(m_id, name.data()), vec.x, vec.y);
+  setVec2(getUniform(name), vec);
 }
 
 void ShaderProgram::setVec3(std::string_view name, const glm::vec3& vec) {
-  glUniform3f(glGetUniformLocation(m_id, name.data()), vec.x, vec.y, vec.z);
+  setVec3(getUniform(name), vec);
 }
 
 void ShaderProgram::setVec4(std::string_view name, const glm::vec4& vec) {
-  glUniform4f(glGetUniformLocation(m_id, name.data()), vec.x, vec.y, vec.z,
-              vec.w);
+  setVec4(getUniform(name), vec);
 }
 
 void ShaderProgram::setMat4(std::string_view name, const glm::mat4& mat) {
-  glUniformMatrix4fv(glGetUniformLocation(m_id, name.data()), 1, GL_FALSE,
-                     glm::value_ptr(mat));
+  setMat4(getUniform(name), mat);
 }
 
 std::vector<ActiveUniform> ShaderProgram::getActiveUniforms() {
@@ -75,10 +163,11 @@ std::vector<ActiveUniform> ShaderProgram::getActiveUniforms() {
   std::vector<ActiveUniform> activeUniforms;
 
   std::vector<GLenum> properties;
-  properties.reserve(3);
+  properties.reserve(4);
   properties.emplace_back(GL_NAME_LENGTH);
   properties.emplace_back(GL_TYPE);
   properties.emplace_back(GL_ARRAY_SIZE);
+  properties.emplace_back(GL_BLOCK_INDEX);
   std::vector<GLint> values(properties.size());
 
   std::vector<GLchar> nameData(256);
@@ -87,6 +176,9 @@ std::vector<ActiveUniform> ShaderProgram::getActiveUniforms() {
   for (int i = 0; i < numActiveUniforms; ++i) {
     glGetProgramResourceiv(m_id, GL_UNIFORM, i, properties.size(),
                            &properties[0], values.size(), nullptr, &values[0]);
+    if (values[3] not_eq -1) { // members of uniform blocks are set by buffers
+      continue;
+    }
 
     nameData.resize(values[0]);
     glGetProgramResourceName(m_id, GL_UNIFORM, i, nameData.size(), nullptr,
@@ -96,6 +188,7 @@ std::vector<ActiveUniform> ShaderProgram::getActiveUniforms() {
     ActiveUniform uniform;
     uniform.type = values[1];
     uniform.name = name;
+    uniform.location = glGetUniformLocation(m_id, name.c_str());
 
     activeUniforms.emplace_back(std::move(uniform));
   }
@@ -103,37 +196,45 @@ std::vector<ActiveUniform> ShaderProgram::getActiveUniforms() {
   return activeUniforms;
 }
 
+// only the uniforms that changed since their last reset are written
 void ShaderProgram::resetActiveUniforms() {
-  use();
-  for (const auto& [type, name] : m_activeUniforms) {
+  for (uint32_t i = 0; i < m_activeUniforms.size(); ++i) {
+    UniformHandle uniform{i};
+    uint32_t type = m_activeUniforms[i].type;
     if (type == GL_INT) {
-      setInt(name, 0);
+      setInt(uniform, 0);
     } else if (type == GL_FLOAT) {
-      setFloat(name, 0.f);
+      setFloat(uniform, 0.f);
     } else if (type == GL_FLOAT_VEC2) {
-      setVec2(name, glm::vec2(0.f));
+      setVec2(uniform, glm::vec2(0.f));
     } else if (type == GL_FLOAT_VEC3) {
-      setVec3(name, glm::vec3(0.f));
+      setVec3(uniform, glm::vec3(0.f));
     } else if (type == GL_FLOAT_VEC4) {
-      setVec4(name, glm::vec4(0.f));
+      setVec4(uniform, glm::vec4(0.f));
     } else if (type == GL_FLOAT_MAT4) {
-      setMat4(name, glm::mat4(1.f));
+      setMat4(uniform, glm::mat4(1.f));
     } else if (type == GL_SAMPLER_2D) {
-      setInt(name, 0);
+      setInt(uniform, 0);
     } else if (type == GL_SAMPLER_CUBE) {
-      setInt(name, 0);
+      setInt(uniform, 0);
+    } else if (not ImageTypeName(type).empty()) {
+      continue;
     } else {
       ENGINE_ASSERT(false, "Unknown uniform type {} for uniform {}", type,
-                    name);
+                    m_activeUniforms[i].name);
     }
   }
-  unuse();
+}
+
+void ShaderProgram::resetUniformMetrics() {
+  m_uniformWrites = 0;
+  m_skippedUniformWrites = 0;
 }
 
 void ShaderProgram::printActiveUniforms() {
   ENGINE_BACKTRACE(
     "===================Shader program {} Uniforms===================", m_name);
-  for (const auto& [type, name] : m_activeUniforms) {
+  for (const auto& [type, name, location, value, written] : m_activeUniforms) {
     if (type == GL_INT) {
       ENGINE_BACKTRACE("Uniform {} type: {}", name, "int");
     } else if (type == GL_FLOAT) {
@@ -150,6 +251,9 @@ void ShaderProgram::printActiveUniforms() {
       ENGINE_BACKTRACE("Uniform {} type: {}", name, "sampler2D");
     } else if (type == GL_SAMPLER_CUBE) {
       ENGINE_BACKTRACE("Uniform {} type: {}", name, "samplerCube");
+    } else if (std::string_view image = ImageTypeName(type);
+               not image.empty()) {
+      ENGINE_BACKTRACE("Uniform {} type: {}", name, image);
     } else {
       ENGINE_ASSERT(false, "Unknown uniform type {} for uniform {}", type,
                     name);
@@ -166,7 +270,8 @@ ShaderProgram::getInfo() {
 
   m_info["Name"] = m_name;
   m_info["ID"] = std::to_string(m_id);
-  for (const auto& [type, name] : m_activeUniforms) {
+  for (const auto& [type, name, location, value, written] :
+       m_activeUniforms) {
     if (type == GL_INT) {
       m_info["Uniform " + name] = "int";
     } else if (type == GL_FLOAT) {
@@ -183,6 +288,9 @@ ShaderProgram::getInfo() {
       m_info["Uniform " + name] = "sampler2D";
     } else if (type == GL_SAMPLER_CUBE) {
       m_info["Uniform " + name] = "samplerCube";
+    } else if (std::string_view image = ImageTypeName(type);
+               not image.empty()) {
+      m_info["Uniform " + name] = image;
     } else {
       ENGINE_ASSERT(false, "Unknown uniform type {} for uniform {}", type,
                     name);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <limits>
 
 #include "assets/shader.h"
 #include "pch.h"
@@ -11,6 +12,21 @@ namespace potatoengine {
 struct ActiveUniform {
     uint32_t type;
     std::string name;
+    int location{-1};
+    // last value written, floats and matrices as they are and ints bit copied
+    std::array<float, 16> value{};
+    bool written{};
+};
+
+// index of an active uniform resolved once with ShaderProgram::getUniform,
+// setting through it skips the name lookup. Uniforms that are not active in
+// the program get an invalid handle and setting them does nothing
+struct UniformHandle {
+    static constexpr uint32_t Invalid = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index{Invalid};
+
+    bool isValid() const { return index not_eq Invalid; }
 };
 
 class ShaderProgram {
@@ -23,6 +39,14 @@ class ShaderProgram {
     void link();
     void use();
     void unuse();
+    UniformHandle getUniform(std::string_view name) const;
+    // writes are skipped when the uniform already holds the value
+    void setInt(UniformHandle uniform, int value);
+    void setFloat(UniformHandle uniform, float value);
+    void setVec2(UniformHandle uniform, const glm::vec2& vec);
+    void setVec3(UniformHandle uniform, const glm::vec3& vec);
+    void setVec4(UniformHandle uniform, const glm::vec4& vec);
+    void setMat4(UniformHandle uniform, const glm::mat4& mat);
     void setInt(std::string_view name, int value);
     void setFloat(std::string_view name, float value);
     void setVec2(std::string_view name, const glm::vec2& vec);
@@ -30,6 +54,9 @@ class ShaderProgram {
     void setVec4(std::string_view name, const glm::vec4& vec);
     void setMat4(std::string_view name, const glm::mat4& mat);
     void resetActiveUniforms();
+    uint32_t getUniformWrites() const { return m_uniformWrites; }
+    uint32_t getSkippedUniformWrites() const { return m_skippedUniformWrites; }
+    void resetUniformMetrics();
     void printActiveUniforms();
     const std::map<std::string, std::string, NumericComparator>& getInfo();
 
@@ -40,12 +67,26 @@ class ShaderProgram {
     static std::unique_ptr<ShaderProgram> Create(std::string&& name);
 
   private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const {
+          return std::hash<std::string_view>{}(s);
+        }
+    };
+
     uint32_t m_id{};
     std::string m_name;
     std::vector<ActiveUniform> m_activeUniforms;
+    // names to indices in m_activeUniforms, looked up without a std::string
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>>
+      m_uniformIndices;
     std::map<std::string, std::string, NumericComparator> m_info;
+    uint32_t m_uniformWrites{};
+    uint32_t m_skippedUniformWrites{};
 
     std::vector<ActiveUniform> getActiveUniforms();
+    // stores the value and returns false when the uniform already had it
+    bool updateValue(UniformHandle uniform, const void* value, size_t size);
 };
 
 }
\ No newline at end of file
@@ -21,17 +21,23 @@ void VAO::unbind() {
   m_binded = false;
 }
 
-void VAO::attachVertex(std::shared_ptr<VBO>&& vbo, VertexType type) {
-  size_t vertexSize = 0;
+size_t VAO::GetVertexSize(VertexType type) {
   if (type == VertexType::VERTEX) {
-    vertexSize = sizeof(Vertex);
+    return sizeof(Vertex);
   } else if (type == VertexType::SHAPE_VERTEX) {
-    vertexSize = sizeof(ShapeVertex);
+    return sizeof(ShapeVertex);
   } else if (type == VertexType::TERRAIN_VERTEX) {
-    vertexSize = sizeof(TerrainVertex);
+    return sizeof(TerrainVertex);
+  } else if (type == VertexType::PACKED_VERTEX) {
+    return sizeof(PackedVertex);
+  } else if (type == VertexType::PACKED_SKINNED_VERTEX) {
+    return sizeof(PackedSkinnedVertex);
   }
+  return 0;
+}
 
-  glVertexArrayVertexBuffer(m_id, 0, vbo->getID(), 0, vertexSize);
+void VAO::attachVertex(std::shared_ptr<VBO>&& vbo, VertexType type) {
+  glVertexArrayVertexBuffer(m_id, 0, vbo->getID(), 0, GetVertexSize(type));
   m_vbos.emplace_back(std::move(vbo));
 
   if (type == VertexType::VERTEX) {
@@ -40,6 +46,10 @@ void VAO::attachVertex(std::shared_ptr<VBO>&& vbo, VertexType type) {
     attachShapeVertexAttributes();
   } else if (type == VertexType::TERRAIN_VERTEX) {
     attachTerrainVertexAttributes();
+  } else if (type == VertexType::PACKED_VERTEX) {
+    attachPackedVertexAttributes(false);
+  } else if (type == VertexType::PACKED_SKINNED_VERTEX) {
+    attachPackedVertexAttributes(true);
   }
   m_dirty = true;
 }
@@ -126,9 +136,55 @@ void VAO::attachTerrainVertexAttributes() {
   ++m_vboIDX;
 }
 
+void VAO::attachPackedVertexAttributes(bool skinned) {
+  // PackedSkinnedVertex starts with the same members as PackedVertex
+  glEnableVertexArrayAttrib(m_id, 0);
+  glVertexArrayAttribFormat(m_id, 0, 3, GL_FLOAT, GL_FALSE,
+                            offsetof(PackedVertex, position));
+  glVertexArrayAttribBinding(m_id, 0, m_vboIDX);
+
+  glEnableVertexArrayAttrib(m_id, 1);
+  glVertexArrayAttribFormat(m_id, 1, 4, GL_INT_2_10_10_10_REV, GL_TRUE,
+                            offsetof(PackedVertex, normal));
+  glVertexArrayAttribBinding(m_id, 1, m_vboIDX);
+
+  glEnableVertexArrayAttrib(m_id, 2);
+  glVertexArrayAttribFormat(m_id, 2, 2, GL_HALF_FLOAT, GL_FALSE,
+                            offsetof(PackedVertex, textureCoords));
+  glVertexArrayAttribBinding(m_id, 2, m_vboIDX);
+
+  // w is the sign of the bitangent
+  glEnableVertexArrayAttrib(m_id, 3);
+  glVertexArrayAttribFormat(m_id, 3, 4, GL_INT_2_10_10_10_REV, GL_TRUE,
+                            offsetof(PackedVertex, tangent));
+  glVertexArrayAttribBinding(m_id, 3, m_vboIDX);
+
+  if (skinned) {
+    glEnableVertexArrayAttrib(m_id, 5);
+    glVertexArrayAttribIFormat(m_id, 5, 4, GL_UNSIGNED_BYTE,
+                               offsetof(PackedSkinnedVertex, boneIDs));
+    glVertexArrayAttribBinding(m_id, 5, m_vboIDX);
+
+    glEnableVertexArrayAttrib(m_id, 6);
+    glVertexArrayAttribFormat(m_id, 6, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+                              offsetof(PackedSkinnedVertex, boneWeights));
+    glVertexArrayAttribBinding(m_id, 6, m_vboIDX);
+  }
+
+  glEnableVertexArrayAttrib(m_id, 7);
+  glVertexArrayAttribFormat(m_id, 7, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+                            offsetof(PackedVertex, color));
+  glVertexArrayAttribBinding(m_id, 7, m_vboIDX);
+
+  ++m_vboIDX;
+}
+
 void VAO::updateVertex(std::shared_ptr<VBO>&& vbo, uint32_t idx,
                        VertexType type) {
-  // TODO: update only the vbo at idx ? should not be binded here
+  ENGINE_ASSERT(idx < m_vbos.size(), "VBO index {} out of range", idx);
+  // the attribute formats are kept, only the buffer behind the binding changes
+  glVertexArrayVertexBuffer(m_id, idx, vbo->getID(), 0, GetVertexSize(type));
+  m_vbos[idx] = std::move(vbo);
   m_dirty = true;
 }
 
@@ -146,6 +202,22 @@ void VAO::setIndex(
   m_dirty = true;
 }
 
+void VAO::setInstanceBuffer(const RingBuffer& buffer, size_t offset) {
+  if (not m_instanced) {
+    for (uint32_t i = 0; i < 4; ++i) {
+      uint32_t location = InstanceLocation + i;
+      glEnableVertexArrayAttrib(m_id, location);
+      glVertexArrayAttribFormat(m_id, location, 4, GL_FLOAT, GL_FALSE,
+                                sizeof(glm::vec4) * i);
+      glVertexArrayAttribBinding(m_id, location, InstanceBinding);
+    }
+    glVertexArrayBindingDivisor(m_id, InstanceBinding, 1);
+    m_instanced = true;
+  }
+  glVertexArrayVertexBuffer(m_id, InstanceBinding, buffer.getID(), offset,
+                            sizeof(glm::mat4));
+}
+
 const std::map<std::string, std::string, NumericComparator>& VAO::getInfo() {
   if (not m_dirty) {
     return m_info;
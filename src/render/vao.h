@@ -13,15 +13,30 @@ class VAO {
     void bind();
     void unbind();
 
-    enum class VertexType { VERTEX, SHAPE_VERTEX, TERRAIN_VERTEX };
+    enum class VertexType {
+      VERTEX,
+      SHAPE_VERTEX,
+      TERRAIN_VERTEX,
+      PACKED_VERTEX,
+      PACKED_SKINNED_VERTEX
+    };
+    static constexpr uint32_t VertexTypes = 5;
+    static size_t GetVertexSize(VertexType type);
+
     void attachVertex(std::shared_ptr<VBO>&& vbo, VertexType type);
     void attachVertexAttributes();
     void attachShapeVertexAttributes();
     void attachTerrainVertexAttributes();
+    // same locations as Vertex, the packed attributes are normalized so the
+    // shaders read them unchanged. The bitangent is left to the shader
+    void attachPackedVertexAttributes(bool skinned);
     void updateVertex(std::shared_ptr<VBO>&& vbo, uint32_t idx,
                       VertexType type);
     void clearVBOs();
     void setIndex(std::unique_ptr<IBO>&& ibo);
+    // per instance model matrix read from the buffer starting at the byte
+    // offset, the attributes are set up the first time
+    void setInstanceBuffer(const RingBuffer& buffer, size_t offset);
 
     const std::vector<std::shared_ptr<VBO>>& getVBOs() const { return m_vbos; }
     const std::unique_ptr<IBO>& getEBO() const { return m_ibo; }
@@ -32,7 +47,12 @@ class VAO {
 
     static std::shared_ptr<VAO> Create();
 
+    // locations 8 to 11, one vec4 column each
+    static constexpr uint32_t InstanceLocation = 8;
+
   private:
+    static constexpr uint32_t InstanceBinding = 8;
+
     uint32_t m_id{};
     uint32_t m_vboIDX{};
     std::vector<std::shared_ptr<VBO>> m_vbos;
@@ -40,6 +60,7 @@ class VAO {
     std::map<std::string, std::string, NumericComparator> m_info;
     bool m_dirty{};
     bool m_binded{};
+    bool m_instanced{};
 };
 
 }
\ No newline at end of file
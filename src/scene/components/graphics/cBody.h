@@ -61,6 +61,11 @@ struct CBody {
         filepath); // We need a copy of the model
       meshes = std::move(model.getMeshes());
       materials = std::move(model.getMaterials());
+      // entities cloned from this one share the buffers and can be drawn
+      // instanced
+      for (auto& mesh : meshes) {
+        mesh.getGeometry();
+      }
     }
 
     void reloadMesh(std::string&& fp) {
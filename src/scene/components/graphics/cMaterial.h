@@ -17,6 +17,8 @@ struct CMaterial {
       : ambient(std::move(a)), diffuse(std::move(d)), specular(std::move(s)),
         shininess(sh) {}
 
+    bool operator==(const CMaterial&) const = default;
+
     void print() const {
       ENGINE_BACKTRACE("\t\tambient: {0}\n\t\t\t\t\t\tdiffuse: "
                        "{1}\n\t\t\t\t\t\tspecular: {2}\n\t\t\t\t\t\tshininess: {3}",
@@ -4,14 +4,16 @@
 #include <glm/glm.hpp>
 
 #include "assets/texture.h"
+#include "core/application.h"
 #include "pch.h"
 #include "render/buffer.h"
+#include "render/geometryPool.h"
 #include "render/shaderProgram.h"
-#include "render/vao.h"
 #include "scene/components/graphics/cMaterial.h"
 #include "scene/components/graphics/cTexture.h"
 #include "scene/components/graphics/cTextureAtlas.h"
 #include "scene/components/world/cSkybox.h"
+#include "utils/aabb.h"
 #include "utils/mapJsonSerializer.h"
 #include "utils/numericComparator.h"
 
@@ -21,52 +23,96 @@ namespace potatoengine {
 
 struct CMesh {
     std::vector<std::shared_ptr<assets::Texture>> textures;
-    std::shared_ptr<VAO> vao;
+    // vertices and indices in the geometry pool, shared by the copies of the
+    // mesh
+    std::shared_ptr<GeometryPool::Mesh> geometry;
     std::vector<Vertex> vertices; // TODO: remove this
-    std::shared_ptr<VBO> vbo;
     std::vector<uint32_t> indices;
     std::string vertexType;
+    AABB bounds; // model space, used to cull the mesh
+    // simplified indices of the levels after the full mesh, they share its
+    // vertices in the pool
+    std::vector<std::vector<uint32_t>> lods;
+    bool hasBones{}; // the packed layout only keeps bone data when set
+
+    static constexpr uint32_t MaxLODs = 3;
+    // under this screen size the first simplified level is drawn
+    static constexpr float LODScreenSize = 0.25f;
 
     CMesh() = default;
     explicit CMesh(std::vector<Vertex>&& v, std::vector<uint32_t>&& i,
                    std::vector<std::shared_ptr<assets::Texture>>&& t,
                    std::string&& vt = "basic")
       : vertices(std::move(v)), indices(std::move(i)), textures(std::move(t)),
-        vertexType(std::move(vt)) {}
+        vertexType(std::move(vt)) {
+      for (const Vertex& vertex : vertices) {
+        bounds.expand(vertex.position);
+      }
+    }
+
+    static GeometryPool& getGeometryPool() {
+      return Application::Get().getRenderManager()->getGeometryPool();
+    }
 
+    // shapes get their geometry from the ShapeFactory and terrain meshes
+    // from setupTerrainMesh, only basic meshes keep their vertices, which
+    // are uploaded packed
     void setupMesh() {
-      vao = VAO::Create();
-      if (vertexType == "basic") {
-        vao->attachVertex(VBO::Create(vertices), VAO::VertexType::VERTEX);
-      } else if (vertexType == "shape") { // TODO this is not used
-        vao->attachVertex(VBO::Create(vertices), VAO::VertexType::SHAPE_VERTEX);
-      } else if (vertexType == "terrain") { // TODO maybe a better way to do
-                                            // this using vertices?
-        vao->attachVertex(std::move(vbo), VAO::VertexType::TERRAIN_VERTEX);
+      ENGINE_ASSERT(vertexType == "basic", "Mesh of type {} has no vertices",
+                    vertexType);
+      if (hasBones) {
+        geometry =
+          getGeometryPool().add(PackSkinnedVertices(vertices), indices, lods);
       } else {
-        ENGINE_ASSERT(false, "Unknown vertex type {}", vertexType);
+        geometry = getGeometryPool().add(PackVertices(vertices), indices, lods);
       }
-      vao->setIndex(IBO::Create(indices));
     }
 
-    void updateMesh() {
-      if (vertexType == "basic") {
-        vao->updateVertex(VBO::Create(vertices), 0, VAO::VertexType::VERTEX);
-      } else if (vertexType == "shape") {
-        vao->updateVertex(VBO::Create(vertices), 0,
-                          VAO::VertexType::SHAPE_VERTEX);
-      } else if (vertexType == "terrain") {
-        vao->updateVertex(std::move(vbo), 0, VAO::VertexType::TERRAIN_VERTEX);
-      } else {
-        ENGINE_ASSERT(false, "Unknown vertex type {}", vertexType);
+    void updateMesh() { setupMesh(); }
+
+    void setupTerrainMesh(const std::vector<TerrainVertex>& terrainVertices) {
+      vertexType = "terrain";
+      geometry = getGeometryPool().add(terrainVertices, indices);
+    }
+
+    // rewrites the ranges of the mesh in the pool when the new data fits in
+    // them, it only moves to new ones when it grows past them
+    void updateTerrainMesh(const std::vector<TerrainVertex>& terrainVertices) {
+      if (not geometry or
+          not getGeometryPool().update(*geometry, terrainVertices, indices)) {
+        setupTerrainMesh(terrainVertices);
       }
     }
 
-    const std::shared_ptr<VAO>& getVAO() {
-      if (not vao) {
+    const std::shared_ptr<GeometryPool::Mesh>& getGeometry() {
+      if (not geometry) {
         setupMesh();
       }
-      return vao;
+      return geometry;
+    }
+
+    // level 0 is the full mesh, levels past the last one fall back to the
+    // simplest one
+    GeometryPool::Draw getDraw(uint32_t lod = 0) {
+      return getGeometry()->getDraw(lod);
+    }
+
+    uint32_t getLODCount() const { return lods.size() + 1; }
+
+    uint32_t getTriangleCount(uint32_t lod) const {
+      return (lod == 0 ? indices : lods.at(lod - 1)).size() / 3;
+    }
+
+    // screenSize is the projected radius of the bounds over the viewport
+    // height, each level halves the size where it takes over
+    uint32_t selectLOD(float screenSize) const {
+      uint32_t lod = 0;
+      float threshold = LODScreenSize;
+      while (lod < lods.size() and screenSize < threshold) {
+        ++lod;
+        threshold *= 0.5f;
+      }
+      return lod;
     }
 
     // TODO rethink this method
@@ -75,14 +121,6 @@ struct CMesh {
                       CTexture* cSkyboxTexture, CMaterial* cMaterial) {
       sp->resetActiveUniforms();
       sp->use();
-      sp->setFloat("useFog",
-                   static_cast<float>(entt::monostate<"useFog"_hs>{}));
-      sp->setFloat("fogDensity",
-                   static_cast<float>(entt::monostate<"fogDensity"_hs>{}));
-      sp->setFloat("fogGradient",
-                   static_cast<float>(entt::monostate<"fogGradient"_hs>{}));
-      sp->setVec3("fogColor",
-                  static_cast<glm::vec3>(entt::monostate<"fogColor"_hs>{}));
 
       if (cTexture) {
         uint32_t i = 1;
@@ -100,11 +138,6 @@ struct CMesh {
         }
         if (cTexture->useLighting) {
           sp->setFloat("useLighting", 1.f);
-          sp->setVec3(
-            "lightPosition",
-            static_cast<glm::vec3>(entt::monostate<"lightPosition"_hs>{}));
-          sp->setVec3("lightColor", static_cast<glm::vec3>(
-                                      entt::monostate<"lightColor"_hs>{}));
         }
         if (cTexture->drawMode == CTexture::DrawMode::TEXTURE_ATLAS or
             cTexture->drawMode == CTexture::DrawMode::TEXTURE_ATLAS_BLEND or
@@ -214,8 +247,9 @@ struct CMesh {
         texturePaths +=
           std::format("\n\t\t\ttexture: {}", texture->getFilepath());
       }
-      ENGINE_BACKTRACE("\t\tvertices: {0}\n\t\tindices: {1}{2}",
-                       vertices.size(), indices.size(), texturePaths);
+      ENGINE_BACKTRACE("\t\tvertices: {0}\n\t\tindices: {1}\n\t\tlods: {2}{3}",
+                       vertices.size(), indices.size(), getLODCount(),
+                       texturePaths);
     }
 
     std::map<std::string, std::string, NumericComparator> getInfo() const {
@@ -223,13 +257,19 @@ struct CMesh {
       for (uint32_t i = 0; i < textures.size(); ++i) {
         info["texture " + std::to_string(i)] = getTextureInfo(i);
       }
-      info["vao 0"] = vao ? getVAOInfo() : "undefined";
+      info["vao 0"] = geometry ? getVAOInfo() : "undefined";
       info["vertexType"] = vertexType;
+      for (uint32_t i = 0; i < getLODCount(); ++i) {
+        info["lod " + std::to_string(i) + " triangles"] =
+          std::to_string(getTriangleCount(i));
+      }
 
       return info;
     }
 
-    std::string getVAOInfo() const { return MapToJson(vao->getInfo()); }
+    std::string getVAOInfo() const {
+      return MapToJson(geometry->getInfo());
+    }
 
     std::string getTextureInfo(uint32_t index) const {
       return MapToJson(textures.at(index)->getInfo());
@@ -57,24 +57,33 @@ struct CShape {
       CMesh mesh;
       if (_type == "triangle") {
         type = CShape::Type::Triangle;
-        mesh.vao = ShapeFactory::CreateTriangle(size.x);
+        mesh.geometry = ShapeFactory::CreateTriangle(size.x);
         mesh.vertexType = "shape";
       } else if (_type == "rectangle") {
         type = CShape::Type::Rectangle;
-        mesh.vao = ShapeFactory::CreateRectangle(size.x, size.y, repeatTexture);
+        mesh.geometry =
+          ShapeFactory::CreateRectangle(size.x, size.y, repeatTexture);
         mesh.vertexType = "shape";
       } else if (_type == "cube") {
         type = CShape::Type::Cube;
-        mesh.vao =
+        mesh.geometry =
           ShapeFactory::CreateCube(size.x, size.y, size.z, repeatTexture);
         mesh.vertexType = "shape";
       } else if (_type == "circle") {
         type = CShape::Type::Circle;
-        mesh.vao = ShapeFactory::CreateCircle(size.x, size.y);
+        mesh.geometry = ShapeFactory::CreateCircle(size.x, size.y);
         mesh.vertexType = "shape";
       } else {
         ENGINE_ASSERT(false, "Unknown shape type {}", _type);
       }
+      // the factory centers the shapes, circles use size.y as segments
+      glm::vec3 extents{size.x, size.x, 0.f};
+      if (type == CShape::Type::Rectangle) {
+        extents.y = size.y;
+      } else if (type == CShape::Type::Cube) {
+        extents = size;
+      }
+      mesh.bounds = {-extents, extents};
       meshes.emplace_back(std::move(mesh));
     }
 };
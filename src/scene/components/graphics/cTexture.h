@@ -45,6 +45,8 @@ struct CTexture {
         reflectivity(r), refractiveIndex(ri), hasTransparency(ht),
         useLighting(ul), useReflection(ur), useRefraction(uf), _drawMode(dm) {}
 
+    bool operator==(const CTexture&) const = default;
+
     void print() const {
       std::string texturePaths;
       if (filepaths.size() == 0) {
@@ -11,6 +11,8 @@ struct CTextureAtlas {
     CTextureAtlas() = default;
     explicit CTextureAtlas(uint32_t r, uint32_t i) : rows(r), index(i) {}
 
+    bool operator==(const CTextureAtlas&) const = default;
+
     void print() const {
       ENGINE_BACKTRACE("\t\trows: {0}\n\t\t\t\t\t\tindex: {1}", rows, index);
     }
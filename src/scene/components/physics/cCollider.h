@@ -47,7 +47,7 @@ struct CCollider {
         type = Type::Sphere;
       } else if (_type == "rectangle") {
         type = Type::Rectangle;
-        mesh.vao = ShapeFactory::CreateRectangle(size.x, size.y, false);
+        mesh.geometry = ShapeFactory::CreateRectangle(size.x, size.y, false);
       } else {
         ENGINE_ASSERT(false, "Unknown collider type {}", _type);
       }
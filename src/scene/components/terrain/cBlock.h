@@ -30,6 +30,7 @@ struct CBlock {
 
     CBlock() = default;
     explicit CBlock(std::string&& t) : _type(std::move(t)) {}
+    explicit CBlock(Type t) : _type(getTypeName(t)), type(t) {}
 
     void print() const { ENGINE_BACKTRACE("\t\ttype: {0}", _type); }
 
@@ -40,6 +41,28 @@ struct CBlock {
       return info;
     }
 
+    static std::string getTypeName(Type t) {
+      switch (t) {
+      case Type::Air: return "air";
+      case Type::Dirt: return "dirt";
+      case Type::Grass: return "grass";
+      case Type::Stone: return "stone";
+      case Type::Water: return "water";
+      case Type::Wood: return "wood";
+      case Type::Leaves: return "leaves";
+      case Type::Sand: return "sand";
+      case Type::Snow: return "snow";
+      case Type::Ice: return "ice";
+      case Type::Cloud: return "cloud";
+      case Type::Lava: return "lava";
+      case Type::Bedrock: return "bedrock";
+      case Type::Cactus: return "cactus";
+      case Type::Sandstone: return "sandstone";
+      }
+      ENGINE_ASSERT(false, "Unknown block type {}", static_cast<int>(t));
+      return "air";
+    }
+
     void setBlockType() {
       if (_type == "air") {
         type = Type::Air;
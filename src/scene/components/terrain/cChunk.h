@@ -7,6 +7,7 @@
 #include "scene/components/terrain/cBlock.h"
 #include "utils/mapJsonSerializer.h"
 #include "utils/numericComparator.h"
+#include "utils/palettedVolume.h"
 
 namespace potatoengine {
 
@@ -24,7 +25,8 @@ struct CChunk {
 
     std::string _biome{};
     Biome biome{Biome::plains};
-    std::vector<CBlock> blocks;
+    // chunkSize^3 block types, the CBlock names are only used in json
+    PalettedVolume<CBlock::Type> blocks;
     CMesh terrainMesh;
     CTransform transform;
 
@@ -33,15 +35,20 @@ struct CChunk {
 
     void print() const {
       std::string b;
-      for (uint32_t i = 0; i < blocks.size(); ++i) {
-        b += std::format("\n\t\t\t\t\t\t\tblock: {} {}", i, blocks[i]._type);
+      for (CBlock::Type type : blocks.getPalette()) {
+        b += std::format("\n\t\t\t\t\t\t\tblock: {}",
+                         CBlock::getTypeName(type));
       }
-      ENGINE_BACKTRACE("\t\tbiome: {0}\n\t\t\t\t\t\tblocks: {1}", _biome, b);
+      ENGINE_BACKTRACE("\t\tbiome: {0}\n\t\t\t\t\t\tblocks: {1} ({2} "
+                       "bytes){3}",
+                       _biome, blocks.getCount(), blocks.getBytes(), b);
     }
 
     std::map<std::string, std::string, NumericComparator> getInfo() const {
       std::map<std::string, std::string, NumericComparator> info;
       info["biome"] = _biome;
+      info["blocks"] = std::to_string(blocks.getCount());
+      info["blocks bytes"] = std::to_string(blocks.getBytes());
       info["mesh 0"] = getMeshInfo(0);
       info["transform 0"] = getTransformInfo(0);
 
@@ -6,8 +6,11 @@
 #include <glm/gtx/hash.hpp>
 #include <glm/gtx/string_cast.hpp>
 #include <entt/entt.hpp>
+#include <optional>
+#include <unordered_set>
 
 #include "scene/components/terrain/cChunk.h"
+#include "utils/chunkMap.h"
 #include "utils/numericComparator.h"
 
 namespace potatoengine {
@@ -32,24 +35,46 @@ struct CChunkManager {
     uint32_t blockSize{1};
     uint32_t width{3};
     uint32_t height{3};
-    std::unordered_map<glm::vec3, CChunk> chunks; // TODO: change to ivec3
+    ChunkMap<CChunk> chunks; // keyed by chunk coords, y is always 0
     std::string _meshType;
     MeshType meshType;
     std::string _meshAlgorithm;
     MeshAlgorithm meshAlgorithm;
     bool useBiomes{};
+    // when enabled chunks are loaded and unloaded around the active camera
+    // instead of building a fixed width x height grid
+    bool streaming{};
+    uint32_t loadRadius{3};   // chunks
+    uint32_t unloadRadius{4}; // chunks, above loadRadius to avoid thrashing
+    uint32_t cacheSize{32};   // recently unloaded chunks kept in memory
+    uint32_t uploadsPerFrame{2};
+    // blocks of the chunks edited since they were generated, kept while the
+    // chunk is unloaded or evicted so its edits never come back as noise
+    ChunkMap<PalettedVolume<CBlock::Type>> editedChunks;
+    // coords of loaded chunks whose mesh misses an edit, in them or on a
+    // shared border. Chunks loaded back next to an edit are queued again
+    std::unordered_set<glm::ivec3> dirtyChunks;
+    // totals of the loaded voxel chunks, kept as they are loaded, unloaded
+    // and edited so the metrics never walk the chunks
+    uint32_t voxelChunks{};
+    size_t voxelBlocks{};
+    size_t voxelBytes{};
+    float remeshBudget{2.f}; // milliseconds per frame spent re-meshing
+    // bumped when a chunk is loaded, unloaded or re-meshed, so the chunks
+    // are only walked again after they change
+    uint32_t version{};
 
     CChunkManager() = default;
     explicit CChunkManager(uint32_t w, uint32_t h, uint32_t cs, uint32_t bs,
-                           std::unordered_map<glm::vec3, CChunk>&& c,
+                           ChunkMap<CChunk>&& c,
                            std::string&& mt, std::string&& ma, bool ub)
       : width(w), height(h), chunkSize(cs), blockSize(bs), chunks(std::move(c)),
         _meshType(std::move(mt)), _meshAlgorithm(std::move(ma)), useBiomes(ub) {
     }
     void print() const {
       std::string c;
-      for (auto [position, chunk] : chunks) {
-        c += std::format("\n\t\t\t\t\t\t\tchunk: {} {}", glm::to_string(position),
+      for (const auto& [coords, chunk] : chunks) {
+        c += std::format("\n\t\t\t\t\t\t\tchunk: {} {}", glm::to_string(coords),
                          chunk._biome); // with format you need to call
                                         // glm::to_string for glm types
       }
@@ -57,9 +82,13 @@ struct CChunkManager {
         "\t\twidth: {0}\n\t\t\t\t\t\theight: {1}\n\t\t\t\t\t\tchunkSize: "
         "{2}\n\t\t\t\t\t\tblockSize: {3}\n\t\t\t\t\t\tmeshType: "
         "{4}\n\t\t\t\t\t\tmeshAlgorithm: {5}\n\t\t\t\t\t\tuseBiomes: "
-        "{6}\n\t\t\t\t\t\tchunks: {7}",
+        "{6}\n\t\t\t\t\t\tstreaming: {7}\n\t\t\t\t\t\tloadRadius: "
+        "{8}\n\t\t\t\t\t\tunloadRadius: {9}\n\t\t\t\t\t\tcacheSize: "
+        "{10}\n\t\t\t\t\t\tuploadsPerFrame: {11}\n\t\t\t\t\t\tremeshBudget: "
+        "{12}\n\t\t\t\t\t\tchunks: {13}",
         width, height, chunkSize, blockSize, _meshType, _meshAlgorithm,
-        useBiomes, c);
+        useBiomes, streaming, loadRadius, unloadRadius, cacheSize,
+        uploadsPerFrame, remeshBudget, c);
     }
 
     std::map<std::string, std::string, NumericComparator> getInfo() const {
@@ -71,11 +100,146 @@ struct CChunkManager {
       info["meshType"] = _meshType;
       info["meshAlgorithm"] = _meshAlgorithm;
       info["useBiomes"] = useBiomes ? "true" : "false";
+      info["streaming"] = streaming ? "true" : "false";
+      info["loadRadius"] = std::to_string(loadRadius);
+      info["unloadRadius"] = std::to_string(unloadRadius);
+      info["cacheSize"] = std::to_string(cacheSize);
+      info["uploadsPerFrame"] = std::to_string(uploadsPerFrame);
+      info["remeshBudget"] = std::to_string(remeshBudget);
+      info["dirtyChunks"] = std::to_string(dirtyChunks.size());
+      info["editedChunks"] = std::to_string(editedChunks.size());
       info["chunks"] = std::to_string(chunks.size());
 
       return info;
     }
 
+    // world position of the chunk at coords
+    glm::vec3 getChunkPosition(glm::ivec3 coords) const {
+      return glm::vec3(coords) * static_cast<float>(chunkSize * blockSize);
+    }
+
+    // coords of the chunk containing a world position, also its key in chunks
+    glm::ivec3 getChunkCoords(glm::vec3 position) const {
+      float size = static_cast<float>(chunkSize * blockSize);
+      return {static_cast<int>(std::floor(position.x / size)), 0,
+              static_cast<int>(std::floor(position.z / size))};
+    }
+
+    // the block containing a world position, nullopt outside the loaded
+    // voxel chunks
+    std::optional<CBlock::Type> getBlock(glm::vec3 position) const {
+      glm::ivec3 coords = getChunkCoords(position);
+      auto it = chunks.find(coords);
+      if (it == chunks.end()) {
+        return std::nullopt;
+      }
+      std::optional<glm::uvec3> local = getLocalBlock(coords, position);
+      if (not local or it->second.blocks.getCount() == 0) {
+        return std::nullopt;
+      }
+      return it->second.blocks.get(local->x, local->y, local->z);
+    }
+
+    // changes the block containing a world position and marks its chunk for
+    // re-meshing, plus the neighbours sharing the face when it is on a border.
+    // Returns false outside the loaded voxel chunks
+    bool setBlock(glm::vec3 position, CBlock::Type type) {
+      glm::ivec3 coords = getChunkCoords(position);
+      auto it = chunks.find(coords);
+      if (it == chunks.end()) {
+        return false;
+      }
+      std::optional<glm::uvec3> local = getLocalBlock(coords, position);
+      CChunk& chunk = it->second;
+      if (not local or chunk.blocks.getCount() == 0) {
+        return false;
+      }
+      if (chunk.blocks.get(local->x, local->y, local->z) == type) {
+        return true;
+      }
+
+      size_t bytes = chunk.blocks.getBytes();
+      chunk.blocks.set(local->x, local->y, local->z, type);
+      voxelBytes = voxelBytes - bytes + chunk.blocks.getBytes();
+      if (auto edited = editedChunks.find(coords);
+          edited not_eq editedChunks.end()) {
+        edited->second.set(local->x, local->y, local->z, type);
+      } else {
+        editedChunks.emplace(coords,
+                             PalettedVolume<CBlock::Type>(chunk.blocks));
+      }
+      markDirty(coords);
+      if (local->x == 0) {
+        markDirty(coords + glm::ivec3{-1, 0, 0});
+      } else if (local->x == chunkSize - 1) {
+        markDirty(coords + glm::ivec3{1, 0, 0});
+      }
+      if (local->z == 0) {
+        markDirty(coords + glm::ivec3{0, 0, -1});
+      } else if (local->z == chunkSize - 1) {
+        markDirty(coords + glm::ivec3{0, 0, 1});
+      }
+      return true;
+    }
+
+    // after a chunk is added to chunks
+    void onChunkLoaded(const CChunk& chunk) {
+      ++version;
+      if (chunk.blocks.getCount() == 0) {
+        return;
+      }
+      ++voxelChunks;
+      voxelBlocks += chunk.blocks.getCount();
+      voxelBytes += chunk.blocks.getBytes();
+    }
+
+    // before a chunk is removed from chunks
+    void onChunkUnloaded(const CChunk& chunk) {
+      ++version;
+      if (chunk.blocks.getCount() == 0) {
+        return;
+      }
+      --voxelChunks;
+      voxelBlocks -= chunk.blocks.getCount();
+      voxelBytes -= chunk.blocks.getBytes();
+    }
+
+    // after the mesh of a loaded chunk is replaced
+    void onChunkRemeshed() { ++version; }
+
+    // only loaded chunks are queued, the rest are meshed when they load
+    void markDirty(glm::ivec3 coords) {
+      if (chunks.contains(coords)) {
+        dirtyChunks.insert(coords);
+      }
+    }
+
+    // true when the chunk or a neighbour sharing a face was edited, so a mesh
+    // made without the edits is stale
+    bool hasEditsAround(glm::ivec3 coords) const {
+      for (glm::ivec3 offset :
+           {glm::ivec3{0, 0, 0}, glm::ivec3{-1, 0, 0}, glm::ivec3{1, 0, 0},
+            glm::ivec3{0, 0, -1}, glm::ivec3{0, 0, 1}}) {
+        if (editedChunks.contains(coords + offset)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // blocks of a chunk that is loaded or was edited, nullptr when only the
+    // noise knows them
+    const PalettedVolume<CBlock::Type>* findBlocks(glm::ivec3 coords) const {
+      if (auto it = chunks.find(coords);
+          it not_eq chunks.end() and it->second.blocks.getCount() > 0) {
+        return &it->second.blocks;
+      }
+      if (auto it = editedChunks.find(coords); it not_eq editedChunks.end()) {
+        return &it->second;
+      }
+      return nullptr;
+    }
+
     void setMeshType() {
       if (_meshType == "plane") {
         this->meshType = MeshType::Plane;
@@ -101,6 +265,18 @@ struct CChunkManager {
         ENGINE_ASSERT(false, "Unknown mesh algorithm {}", _meshAlgorithm);
       }
     }
+
+    // block coords inside the chunk at coords, nullopt above or below it
+    std::optional<glm::uvec3> getLocalBlock(glm::ivec3 coords,
+                                            glm::vec3 position) const {
+      glm::ivec3 block(glm::floor(position / static_cast<float>(blockSize)));
+      int size = static_cast<int>(chunkSize);
+      if (block.y < 0 or block.y >= size) {
+        return std::nullopt;
+      }
+      return glm::uvec3(block.x - coords.x * size, block.y,
+                        block.z - coords.z * size);
+    }
 };
 }
 
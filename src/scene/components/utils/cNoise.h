@@ -4,7 +4,9 @@
 #include <entt/entt.hpp>
 
 #include "pch.h"
+#include "utils/multiArray.h"
 #include "utils/numericComparator.h"
+#include "utils/simdNoise.h"
 
 namespace potatoengine {
 
@@ -66,6 +68,44 @@ struct CNoise {
       return sample * amplitude;
     }
 
+    // fills out(row, col) with getNoise(col + xOffset, row + yOffset), using
+    // the vectorized kernels when the cpu and the noise type allow it
+    void getNoise(Grid<float>& out, int xOffset, int yOffset) const {
+      uint32_t rows = static_cast<uint32_t>(out.getRows());
+      uint32_t cols = static_cast<uint32_t>(out.getCols());
+      simd::NoiseType simdType{};
+      bool vectorized = true;
+      if (_type == "simplex") {
+        simdType = simd::NoiseType::Simplex;
+      } else if (_type == "perlin") {
+        simdType = simd::NoiseType::Perlin;
+      } else if (_type == "value") {
+        simdType = simd::NoiseType::Value;
+      } else {
+        vectorized = false; // valueCubic and cellular
+      }
+
+      if (not vectorized or
+          not simd::FillNoise2D(simdType, seed, frequency, out.data(), rows,
+                                cols, xOffset, yOffset)) {
+        for (uint32_t row = 0; row < rows; ++row) {
+          for (uint32_t col = 0; col < cols; ++col) {
+            int x = static_cast<int>(col) + xOffset;
+            int y = static_cast<int>(row) + yOffset;
+            out(row, col) =
+              noise.GetNoise(static_cast<float>(x), static_cast<float>(y));
+          }
+        }
+      }
+
+      for (float& sample : out) {
+        if (positive) {
+          sample = (sample + 1.f) / 2.f;
+        }
+        sample *= amplitude;
+      }
+    }
+
     void setNoiseType() {
       if (_type == "simplex") {
         noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
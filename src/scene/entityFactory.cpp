@@ -194,10 +194,23 @@ void EntityFactory::createPrototypes(
     }
 
     prefabPrototypes.insert({prototypeID.data(), e});
+    m_entities.insert(e);
   }
   m_dirty = true;
 }
 
+void EntityFactory::addPrototype(std::string_view prefab_name,
+                                 std::string_view prototypeID,
+                                 entt::entity e) {
+  auto& prefabPrototypes = m_prefabs[prefab_name.data()];
+  ENGINE_ASSERT(not prefabPrototypes.contains(prototypeID.data()),
+                "Prototype {} for prefab {} already exists", prototypeID,
+                prefab_name);
+  prefabPrototypes.insert({prototypeID.data(), e});
+  m_entities.insert(e);
+  m_dirty = true;
+}
+
 void EntityFactory::updatePrototypes(
   std::string_view prefab_name,
   const std::vector<std::string>& prototypeIDs, entt::registry& registry,
@@ -214,8 +227,9 @@ void EntityFactory::destroyPrototypes(
     ENGINE_ASSERT(m_prefabs.at(prefab_name.data()).contains(prototypeID.data()),
                   "Unknown prototype {} for prefab {}", prototypeID,
                   prefab_name);
-    registry.emplace<CDeleted>(
-      m_prefabs.at(prefab_name.data()).at(prototypeID.data()));
+    entt::entity e = m_prefabs.at(prefab_name.data()).at(prototypeID.data());
+    registry.emplace<CDeleted>(e);
+    m_entities.erase(e);
     m_prefabs.at(prefab_name.data()).erase(prototypeID.data());
   }
   m_dirty = true;
@@ -274,6 +288,7 @@ EntityFactory::getAllPrototypes() {
 
 void EntityFactory::clearPrototypes() {
   m_prefabs.clear();
+  m_entities.clear();
   m_prototypesCountByPrefab.clear();
   m_dirty = false;
 }
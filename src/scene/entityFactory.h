@@ -1,6 +1,7 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <unordered_set>
 
 #include "assets/assetsManager.h"
 #include "assets/prefab.h"
@@ -29,6 +30,10 @@ class EntityFactory {
                   const std::vector<std::string>& prototypeIDs);
     bool containsPrototypes(std::string_view prefab_name,
                             const std::vector<std::string>& prototypeIDs) const;
+    // registers an entity built elsewhere as a prototype of the prefab
+    void addPrototype(std::string_view prefab_name,
+                      std::string_view prototypeID, entt::entity e);
+    bool isPrototype(entt::entity e) const { return m_entities.contains(e); }
 
     const std::map<std::string, Prototypes, NumericComparator>&
     getAllPrototypes();
@@ -39,6 +44,7 @@ class EntityFactory {
 
   private:
     std::map<std::string, Prototypes, NumericComparator> m_prefabs;
+    std::unordered_set<entt::entity> m_entities; // of all the prototypes
     std::map<std::string, std::string, NumericComparator>
       m_prototypesCountByPrefab;
     bool m_dirty{};
@@ -0,0 +1,114 @@
+#include "scene/entityIndex.h"
+
+#include "scene/components/core/cName.h"
+#include "scene/components/core/cUUID.h"
+
+namespace potatoengine {
+
+void EntityIndex::connect(entt::registry& registry) {
+  registry.on_construct<CName>().connect<&EntityIndex::onNameChanged>(*this);
+  registry.on_update<CName>().connect<&EntityIndex::onNameChanged>(*this);
+  registry.on_destroy<CName>().connect<&EntityIndex::onNameRemoved>(*this);
+  registry.on_construct<CUUID>().connect<&EntityIndex::onUUIDChanged>(*this);
+  registry.on_update<CUUID>().connect<&EntityIndex::onUUIDChanged>(*this);
+  registry.on_destroy<CUUID>().connect<&EntityIndex::onUUIDRemoved>(*this);
+}
+
+entt::entity EntityIndex::find(std::string_view name) const {
+  auto it = m_names.find(name);
+  return it == m_names.end() ? entt::null : it->second;
+}
+
+entt::entity EntityIndex::find(uint32_t uuid) const {
+  auto it = m_uuids.find(uuid);
+  return it == m_uuids.end() ? entt::null : it->second;
+}
+
+bool EntityIndex::matches(entt::registry& registry) const {
+  size_t uuids = 0;
+  for (const auto& [e, cUUID] : registry.view<CUUID>().each()) {
+    auto it = m_entityUUIDs.find(e);
+    if (it == m_entityUUIDs.end() or it->second not_eq cUUID.uuid or
+        not m_uuids.contains(cUUID.uuid)) {
+      return false;
+    }
+    ++uuids;
+  }
+  size_t names = 0;
+  for (const auto& [e, cName, _] : registry.view<CName, CUUID>().each()) {
+    auto it = m_entityNames.find(e);
+    if (it == m_entityNames.end() or it->second not_eq cName.name) {
+      return false;
+    }
+    ++names;
+  }
+  return uuids == m_entityUUIDs.size() and uuids == m_uuids.size() and
+         names == m_entityNames.size() and names == m_names.size();
+}
+
+void EntityIndex::onNameChanged(entt::registry& registry, entt::entity e) {
+  removeName(e);
+  if (registry.all_of<CUUID>(e)) {
+    addName(e, registry.get<CName>(e).name);
+  }
+}
+
+void EntityIndex::onNameRemoved(entt::registry& registry, entt::entity e) {
+  removeName(e);
+}
+
+void EntityIndex::onUUIDChanged(entt::registry& registry, entt::entity e) {
+  removeUUID(e);
+  uint32_t uuid = registry.get<CUUID>(e).uuid;
+  if (m_uuids.contains(uuid)) {
+    ENGINE_WARN("Repeated uuid {} on entity {}", uuid, entt::to_integral(e));
+  }
+  m_uuids.emplace(uuid, e);
+  m_entityUUIDs[e] = uuid;
+  if (const CName* cName = registry.try_get<CName>(e);
+      cName and not m_entityNames.contains(e)) {
+    addName(e, cName->name);
+  }
+}
+
+void EntityIndex::onUUIDRemoved(entt::registry& registry, entt::entity e) {
+  removeUUID(e);
+  removeName(e);
+}
+
+void EntityIndex::addName(entt::entity e, const std::string& name) {
+  m_names.emplace(name, e);
+  m_entityNames[e] = name;
+}
+
+void EntityIndex::removeName(entt::entity e) {
+  auto it = m_entityNames.find(e);
+  if (it == m_entityNames.end()) {
+    return;
+  }
+  auto [first, last] = m_names.equal_range(it->second);
+  for (auto entry = first; entry not_eq last; ++entry) {
+    if (entry->second == e) {
+      m_names.erase(entry);
+      break;
+    }
+  }
+  m_entityNames.erase(it);
+}
+
+void EntityIndex::removeUUID(entt::entity e) {
+  auto it = m_entityUUIDs.find(e);
+  if (it == m_entityUUIDs.end()) {
+    return;
+  }
+  auto [first, last] = m_uuids.equal_range(it->second);
+  for (auto entry = first; entry not_eq last; ++entry) {
+    if (entry->second == e) {
+      m_uuids.erase(entry);
+      break;
+    }
+  }
+  m_entityUUIDs.erase(it);
+}
+
+}
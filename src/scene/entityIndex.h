@@ -0,0 +1,55 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+#include "pch.h"
+
+namespace potatoengine {
+
+// entities by name and by uuid, kept in step with the registry through the
+// signals of CName and CUUID. Only instances are indexed, the entities with
+// a CUUID, prototypes never are. Names changed in place without patch or
+// replace are not seen, matches tells when that happened
+class EntityIndex {
+  public:
+    EntityIndex() = default;
+    EntityIndex(const EntityIndex&) = delete;
+    EntityIndex& operator=(const EntityIndex&) = delete;
+
+    void connect(entt::registry& registry);
+
+    // entt::null when no instance has it
+    entt::entity find(std::string_view name) const;
+    entt::entity find(uint32_t uuid) const;
+
+    // false when the indexes and a full scan of the registry differ
+    bool matches(entt::registry& registry) const;
+
+  private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const {
+          return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    void onNameChanged(entt::registry& registry, entt::entity e);
+    void onNameRemoved(entt::registry& registry, entt::entity e);
+    void onUUIDChanged(entt::registry& registry, entt::entity e);
+    void onUUIDRemoved(entt::registry& registry, entt::entity e);
+    void addName(entt::entity e, const std::string& name);
+    void removeName(entt::entity e);
+    void removeUUID(entt::entity e);
+
+    // several instances can share a name, any of them is returned
+    std::unordered_multimap<std::string, entt::entity, StringHash,
+                            std::equal_to<>>
+      m_names;
+    std::unordered_map<entt::entity, std::string> m_entityNames;
+    // uuids should be unique, a repeated one is kept so that removing either
+    // instance leaves the other findable
+    std::unordered_multimap<uint32_t, entt::entity> m_uuids;
+    std::unordered_map<entt::entity, uint32_t> m_entityUUIDs;
+};
+
+}
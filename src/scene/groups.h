@@ -0,0 +1,60 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+#include "scene/components/core/cUUID.h"
+#include "scene/components/graphics/cBody.h"
+#include "scene/components/graphics/cMesh.h"
+#include "scene/components/graphics/cShaderProgram.h"
+#include "scene/components/graphics/cShape.h"
+#include "scene/components/physics/cGravity.h"
+#include "scene/components/physics/cRigidBody.h"
+#include "scene/components/physics/cTransform.h"
+#include "scene/components/terrain/cChunkManager.h"
+
+namespace potatoengine {
+
+// owning groups of the archetypes walked every frame. The owned components
+// of the entities of a group are packed at the front of their storages in
+// the same order, so the loops read arrays instead of probing sparse sets.
+// A component is owned by one group at most and owned storages can only be
+// sorted through their group.
+// The render archetypes own the component that tells them apart and exclude
+// the ones before them, so an entity is drawn by one of them only, and leave
+// the transform to the physics one
+
+inline auto MeshGroup(entt::registry& registry) {
+  return registry.group<CMesh>(entt::get<CTransform, CShaderProgram, CUUID>);
+}
+
+inline auto BodyGroup(entt::registry& registry) {
+  return registry.group<CBody>(entt::get<CTransform, CShaderProgram, CUUID>,
+                               entt::exclude<CMesh>);
+}
+
+inline auto ShapeGroup(entt::registry& registry) {
+  return registry.group<CShape>(entt::get<CTransform, CShaderProgram, CUUID>,
+                                entt::exclude<CMesh, CBody>);
+}
+
+inline auto ChunkGroup(entt::registry& registry) {
+  return registry.group<CChunkManager>(
+    entt::get<CTransform, CShaderProgram, CUUID>,
+    entt::exclude<CMesh, CBody, CShape>);
+}
+
+inline auto GravityGroup(entt::registry& registry) {
+  return registry.group<CTransform, CRigidBody, CGravity>(entt::get<CUUID>);
+}
+
+// groups are built when first asked for, which has to happen before the
+// systems can run in parallel
+inline void RegisterGroups(entt::registry& registry) {
+  MeshGroup(registry);
+  BodyGroup(registry);
+  ShapeGroup(registry);
+  ChunkGroup(registry);
+  GravityGroup(registry);
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+#include "core/threadPool.h"
+#include "pch.h"
+
+namespace potatoengine {
+
+namespace detail {
+template <typename F, typename Tuple>
+constexpr bool Applicable =
+  []<size_t... I>(std::index_sequence<I...>) {
+    return std::is_invocable_v<F&, std::tuple_element_t<I, Tuple>...>;
+  }(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+
+template <typename Iterable, typename F>
+void Invoke(const Iterable& iterable, entt::entity e, F& f) {
+  auto components = iterable.get(e);
+  auto arguments = std::tuple_cat(std::make_tuple(e), components);
+  if constexpr (Applicable<F, decltype(arguments)>) {
+    std::apply(f, arguments);
+  } else {
+    std::apply(f, components);
+  }
+}
+}
+
+// each of a view or a group split in chunks over the thread pool, f takes the
+// same arguments as in each, with or without the entity.
+// f can read and write the components of the entity it gets and read any
+// component nobody writes during the loop. It must not touch the components
+// of other entities it could be writing, emplace or remove components or
+// create or destroy entities, the storages can not change while the loop runs
+template <typename Iterable, typename F>
+void ParallelEach(ThreadPool& threadPool, const Iterable& iterable, F&& f,
+                  size_t minChunk = 1024) {
+  if constexpr (requires { iterable.handle()->begin(); }) {
+    // views walk their smallest storage and skip what the others lack
+    const auto* storage = iterable.handle();
+    if (not storage) {
+      return;
+    }
+    auto first = storage->begin();
+    threadPool.parallelFor(storage->size(), minChunk,
+                           [&](size_t begin, size_t end) {
+                             for (size_t i = begin; i < end; ++i) {
+                               entt::entity e = first[i];
+                               if (iterable.contains(e)) {
+                                 detail::Invoke(iterable, e, f);
+                               }
+                             }
+                           });
+  } else {
+    // the entities of a group are packed at the front of its storages
+    auto first = iterable.begin();
+    threadPool.parallelFor(iterable.size(), minChunk,
+                           [&](size_t begin, size_t end) {
+                             for (size_t i = begin; i < end; ++i) {
+                               detail::Invoke(iterable, first[i], f);
+                             }
+                           });
+  }
+}
+
+}
@@ -55,23 +55,85 @@ entt::entity SceneFactory::createEntity(std::string_view prefab_id,
   return e;
 }
 
+std::vector<entt::entity>
+SceneFactory::createEntities(std::string_view prefab_id,
+                             std::string&& prototypeID,
+                             entt::registry& registry,
+                             std::vector<std::string>&& names,
+                             std::optional<std::string> tag) {
+  std::string _tag = tag.has_value() ? tag.value() : prototypeID;
+  std::vector<entt::entity> clones = cloneEntities(
+    m_entityFactory.getPrototypes(prefab_id, {prototypeID}).at(prototypeID),
+    names.size(), registry);
+
+  auto& cNames = registry.storage<CName>();
+  cNames.reserve(cNames.size() + clones.size());
+  auto& cTags = registry.storage<CTag>();
+  cTags.reserve(cTags.size() + clones.size());
+  for (size_t i = 0; i < clones.size(); ++i) {
+    registry.emplace<CName>(clones[i], std::move(names[i]));
+    registry.emplace<CTag>(clones[i], _tag);
+  }
+  return clones;
+}
+
+namespace {
+// the uuid, name and tag identify an instance, a clone gets its own ones
+bool isIdentity(const entt::sparse_set& storage) {
+  return storage.type() == entt::type_id<CUUID>() or
+         storage.type() == entt::type_id<CName>() or
+         storage.type() == entt::type_id<CTag>();
+}
+}
+
+const SceneFactory::ClonePlan&
+SceneFactory::getClonePlan(entt::entity prototype, entt::registry& registry) {
+  // prototypes keep their components until they are updated or destroyed,
+  // which drops their plans, so a cached plan is always current
+  if (auto it = m_clonePlans.find(prototype); it not_eq m_clonePlans.end()) {
+    return it->second;
+  }
+
+  ClonePlan plan;
+  for (auto&& [id, storage] : registry.storage()) {
+    if (not storage.contains(prototype) or isIdentity(storage)) {
+      continue;
+    }
+    ClonePlan::Step step{&storage};
+    entt::meta_type cType = entt::resolve(storage.type());
+    if (entt::meta_func onCloned = cType.func("onComponentCloned"_hs)) {
+      step.type = cType;
+      step.onCloned = onCloned;
+    }
+    plan.steps.emplace_back(std::move(step));
+  }
+  // live instances change their components, their plan is made per call
+  if (not m_entityFactory.isPrototype(prototype)) {
+    m_instancePlan = std::move(plan);
+    return m_instancePlan;
+  }
+  return m_clonePlans.emplace(prototype, std::move(plan)).first->second;
+}
+
+void SceneFactory::clone(const ClonePlan& plan, entt::entity prototype,
+                         entt::entity cloned) {
+  for (const ClonePlan::Step& step : plan.steps) {
+    step.storage->push(cloned, step.storage->value(prototype));
+    if (step.onCloned) {
+      entt::meta_any cData =
+        step.type.from_void(step.storage->value(cloned));
+      step.onCloned.invoke({}, cloned, cData);
+    }
+  }
+}
+
 entt::entity SceneFactory::cloneEntity(const entt::entity& e, uint32_t uuid,
                                        entt::registry& registry,
                                        std::optional<std::string> name,
                                        std::optional<std::string> tag) {
+  Timer timer;
   entt::entity cloned = registry.create();
-
-  for (const auto& curr : registry.storage()) {
-    if (auto& storage = curr.second; storage.contains(e)) {
-      storage.push(cloned, storage.value(e));
-      entt::meta_type cType = entt::resolve(storage.type());
-      entt::meta_any cData = cType.construct(storage.value(e));
-      entt::meta_func triggerEventFunc = cType.func("onComponentCloned"_hs);
-      if (triggerEventFunc) {
-        triggerEventFunc.invoke({}, e, cData);
-      }
-    }
-  }
+  clone(getClonePlan(e, registry), e, cloned);
 
   registry.emplace<CUUID>(cloned, uuid);
   if (name.has_value()) {
@@ -80,11 +142,37 @@ entt::entity SceneFactory::cloneEntity(const entt::entity& e, uint32_t uuid,
   if (tag.has_value()) {
     registry.emplace<CTag>(cloned, std::move(tag.value()));
   }
+  m_clones += 1;
+  m_cloneSeconds += timer.getSeconds();
   m_dirtyMetrics = true;
   m_dirtyNamedEntities = true;
   return cloned;
 }
 
+std::vector<entt::entity>
+SceneFactory::cloneEntities(const entt::entity& e, uint32_t count,
+                            entt::registry& registry) {
+  Timer timer;
+  std::vector<entt::entity> clones(count);
+  registry.create(clones.begin(), clones.end());
+  const ClonePlan& plan = getClonePlan(e, registry);
+  for (const ClonePlan::Step& step : plan.steps) {
+    step.storage->reserve(step.storage->size() + count);
+  }
+  auto& uuids = registry.storage<CUUID>();
+  uuids.reserve(uuids.size() + count);
+
+  for (entt::entity cloned : clones) {
+    clone(plan, e, cloned);
+    registry.emplace<CUUID>(cloned, UUID());
+  }
+  m_clones += count;
+  m_cloneSeconds += timer.getSeconds();
+  m_dirtyMetrics = true;
+  m_dirtyNamedEntities = true;
+  return clones;
+}
+
 void SceneFactory::createScene(
   std::string scene_id, std::string scene_path,
   const std::unique_ptr<assets::AssetsManager>& assets_manager,
@@ -128,6 +216,7 @@ void SceneFactory::reloadScene(
   if (reload_prototypes) {
     registry.clear(); // delete instances and prototypes but reusing them later
     m_entityFactory.clearPrototypes();
+    m_clonePlans.clear();
 
     for (const auto& [prefab_name, options] : scene->getPrefabs()) {
       ENGINE_TRACE("Reloading scene prefabs prototypes...");
@@ -157,6 +246,7 @@ void SceneFactory::clearScene(const std::unique_ptr<RenderManager>& render_manag
   registry.clear(); // soft delete / = {};  would delete them completely but
                     // does not invoke signals/mixin methods
   m_entityFactory.clearPrototypes();
+  m_clonePlans.clear();
   render_manager->clear();
   m_active_scene.clear();
   m_metrics.clear();
@@ -244,11 +334,28 @@ void SceneFactory::createNormalEntities(
   const std::unique_ptr<assets::AssetsManager>& assets_manager,
   entt::registry& registry) {
   ENGINE_TRACE("Creating scene normal entities...");
+  // instances of the same prototype are cloned together
+  std::map<std::pair<std::string, std::string>, std::vector<std::string>>
+    batches;
+  for (const auto& [name, data] : scene.getNormalEntities()) {
+    batches[{data.at("prefab").get<std::string>(),
+             data.at("prototype").get<std::string>()}]
+      .emplace_back(name);
+  }
+  std::unordered_map<std::string_view, entt::entity> created;
+  created.reserve(scene.getNormalEntities().size());
+  for (const auto& [key, names] : batches) {
+    std::vector<entt::entity> entities =
+      createEntities(key.first, std::string(key.second), registry,
+                     std::vector(names));
+    for (size_t i = 0; i < names.size(); ++i) {
+      created.emplace(names[i], entities[i]);
+    }
+  }
+
   for (const auto& [name, data] : scene.getNormalEntities()) {
     std::string prototype = data.at("prototype").get<std::string>();
-    entt::entity e =
-      createEntity(data.at("prefab").get<std::string>(), std::string(prototype),
-                   registry, std::string(name));
+    entt::entity e = created.at(name);
     if (data.contains("options")) {
       json options = data.at("options");
       if (options.contains("isKinematic")) {
@@ -432,6 +539,25 @@ void SceneFactory::createNormalEntities(
         if (options.contains("useBiomes")) {
           cChunkManager.useBiomes = options.at("useBiomes").get<bool>();
         }
+        if (options.contains("streaming")) {
+          cChunkManager.streaming = options.at("streaming").get<bool>();
+        }
+        if (options.contains("loadRadius")) {
+          cChunkManager.loadRadius = options.at("loadRadius").get<int>();
+        }
+        if (options.contains("unloadRadius")) {
+          cChunkManager.unloadRadius = options.at("unloadRadius").get<int>();
+        }
+        if (options.contains("cacheSize")) {
+          cChunkManager.cacheSize = options.at("cacheSize").get<int>();
+        }
+        if (options.contains("uploadsPerFrame")) {
+          cChunkManager.uploadsPerFrame =
+            options.at("uploadsPerFrame").get<int>();
+        }
+        if (options.contains("remeshBudget")) {
+          cChunkManager.remeshBudget = options.at("remeshBudget").get<float>();
+        }
       }
       if (options.contains("noise")) {
         CNoise& noise = registry.get<CNoise>(e);
@@ -536,6 +662,9 @@ void SceneFactory::createLightEntities(
       if (options.contains("intensity")) {
         cLight.intensity = options.at("intensity").get<float>();
       }
+      if (options.contains("range")) {
+        cLight.range = options.at("range").get<float>();
+      }
       if (options.contains("color")) {
         json color = options.at("color");
         cLight.color = {color.at("r").get<float>(), color.at("g").get<float>(),
@@ -683,6 +812,7 @@ void SceneFactory::createFBOEntities(
 
 void SceneFactory::removeEntity(entt::entity& e, entt::registry& registry) {
   registry.emplace<CDeleted>(e);
+  m_clonePlans.erase(e); // its id is recycled once the entity is destroyed
   m_dirtyMetrics = true;
   m_dirtyNamedEntities = true;
 }
@@ -690,6 +820,7 @@ void SceneFactory::removeEntity(entt::entity& e, entt::registry& registry) {
 const std::map<std::string, std::string, NumericComparator>&
 SceneFactory::getMetrics(entt::registry& registry) {
   if (not m_dirtyMetrics) {
+    updateChunkMetrics(registry);
     return m_metrics;
   }
 
@@ -708,11 +839,42 @@ SceneFactory::getMetrics(entt::registry& registry) {
   m_metrics["Entities Total Alive"] = std::to_string(total);
   m_metrics["Entities Total Created"] = std::to_string(created);
   m_metrics["Entities Total Released"] = std::to_string(created - total);
+  m_metrics["Entities Total Cloned"] = std::to_string(m_clones);
+  if (m_clones > 0) {
+    m_metrics["Entity Clone Avg us"] =
+      std::format("{:.3f}", m_cloneSeconds * 1e6 / m_clones);
+  }
   m_dirtyMetrics = false;
+  updateChunkMetrics(registry);
 
   return m_metrics;
 }
 
+// chunks are streamed in and out without creating entities, so they are
+// refreshed on every call from the totals each chunk manager keeps
+void SceneFactory::updateChunkMetrics(entt::registry& registry) {
+  uint32_t chunks = 0;
+  size_t blocks = 0;
+  size_t bytes = 0;
+  registry.view<CChunkManager>().each([&](const CChunkManager& cChunkManager) {
+    chunks += cChunkManager.voxelChunks;
+    blocks += cChunkManager.voxelBlocks;
+    bytes += cChunkManager.voxelBytes;
+  });
+  if (chunks == 0) {
+    m_metrics.erase("Voxel Chunks Loaded");
+    m_metrics.erase("Voxel Chunk Bytes Avg");
+    m_metrics.erase("Voxel Chunk Bytes Avg As CBlock");
+    return;
+  }
+
+  m_metrics["Voxel Chunks Loaded"] = std::to_string(chunks);
+  m_metrics["Voxel Chunk Bytes Avg"] = std::to_string(bytes / chunks);
+  // what the same blocks took when stored as one CBlock each
+  m_metrics["Voxel Chunk Bytes Avg As CBlock"] =
+    std::to_string(blocks * sizeof(CBlock) / chunks);
+}
+
 const std::map<std::string, entt::entity, NumericComparator>&
 SceneFactory::getNamedEntities(entt::registry& registry) {
   if (not m_dirtyNamedEntities) {
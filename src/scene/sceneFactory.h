@@ -19,11 +19,25 @@ class SceneFactory {
                               entt::registry& registry, std::string&& name,
                               std::optional<std::string> tag = std::nullopt,
                               std::optional<uint32_t> uuid = std::nullopt);
+    // one instance per name, cloned together through cloneEntities
+    std::vector<entt::entity>
+    createEntities(std::string_view prefabID, std::string&& prototypeID,
+                   entt::registry& registry, std::vector<std::string>&& names,
+                   std::optional<std::string> tag = std::nullopt);
     entt::entity cloneEntity(const entt::entity& e, uint32_t uuid,
                              entt::registry& registry,
                              std::optional<std::string> name = std::nullopt,
                              std::optional<std::string> tag = std::nullopt);
+    // count instances of e with their own uuids, the storages grow once for
+    // all of them. e may be a live instance, its uuid, name and tag are not
+    // copied
+    std::vector<entt::entity> cloneEntities(const entt::entity& e,
+                                            uint32_t count,
+                                            entt::registry& registry);
     void removeEntity(entt::entity& e, entt::registry& registry);
+    // the prototypes changed or were destroyed, their components have to be
+    // looked up again
+    void clearClonePlans() { m_clonePlans.clear(); }
 
     void
     createScene(std::string scene_name, std::string scene_path,
@@ -47,8 +61,29 @@ class SceneFactory {
     EntityFactory& getEntityFactory() { return m_entityFactory; }
 
   private:
+    // storages holding a component of a prototype, found once by walking
+    // every storage of the registry and reused by all the clones of it.
+    // Entities that are not prototypes walk the storages on every clone
+    struct ClonePlan {
+        struct Step {
+            entt::sparse_set* storage{};
+            entt::meta_type type;      // only set with an onCloned hook
+            entt::meta_func onCloned;
+        };
+        std::vector<Step> steps;
+    };
+
+    const ClonePlan& getClonePlan(entt::entity prototype,
+                                  entt::registry& registry);
+    void clone(const ClonePlan& plan, entt::entity prototype,
+               entt::entity cloned);
+
     std::string m_active_scene;
     EntityFactory m_entityFactory;
+    std::unordered_map<entt::entity, ClonePlan> m_clonePlans; // prototypes
+    ClonePlan m_instancePlan; // last plan of an entity that is not one
+    uint64_t m_clones{};
+    double m_cloneSeconds{};
 
     std::map<std::string, std::string, NumericComparator> m_metrics;
     std::map<std::string, entt::entity, NumericComparator> m_namedEntities;
@@ -73,6 +108,7 @@ class SceneFactory {
     void createChildrenScenes(
       const assets::Scene& scene,
       const std::unique_ptr<assets::AssetsManager>& assets_manager);
+    void updateChunkMetrics(entt::registry& registry);
     void createSceneEntities(
       const assets::Scene& scene,
       const std::unique_ptr<assets::AssetsManager>& assets_manager,
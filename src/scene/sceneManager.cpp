@@ -1,8 +1,15 @@
 #include "scene/sceneManager.h"
 
+#include <atomic>
+#include <exception>
+#include <numeric>
+
+#include "core/threadPool.h"
 #include "scene/components/core/cName.h"
 #include "scene/components/core/cUUID.h"
+#include "scene/groups.h"
 #include "scene/utils.h"
+#include "utils/timer.h"
 
 using namespace entt::literals;
 
@@ -12,6 +19,9 @@ SceneManager::SceneManager() : m_sceneFactory() {
   ENGINE_TRACE("Initializing scene manager...");
   ENGINE_TRACE("Registering engine components...");
   RegisterComponents();
+  ENGINE_TRACE("Registering engine groups...");
+  RegisterGroups(m_registry);
+  m_entityIndex.connect(m_registry);
   ENGINE_TRACE("Scene manager created!");
 }
 
@@ -21,6 +31,7 @@ void SceneManager::registerSystem(std::string&& name,
   system->init(m_registry);
   m_systems.emplace(std::make_pair(std::move(name), std::move(system)));
   dirtySystems = true;
+  m_dirtySchedule = true;
 }
 
 void SceneManager::unregisterSystem(std::string_view name) {
@@ -34,6 +45,7 @@ void SceneManager::unregisterSystem(std::string_view name) {
   }
   ENGINE_ASSERT(deleted, "System {} not found", name);
   dirtySystems = true;
+  m_dirtySchedule = true;
 }
 
 bool SceneManager::containsSystem(std::string_view name) {
@@ -48,32 +60,153 @@ bool SceneManager::containsSystem(std::string_view name) {
 void SceneManager::clearSystems() {
   m_systems.clear();
   dirtySystems = false;
+  m_dirtySchedule = true;
+}
+
+void SceneManager::buildSchedule() {
+  // a system goes in the stage after the last earlier system it conflicts
+  // with, so systems that touch the same components keep their priority
+  // order and the others move up to run next to each other
+  std::vector<ScheduledSystem> schedule;
+  std::vector<std::string> names;
+  for (const auto& [name, system] : m_systems) {
+    ScheduledSystem scheduled{system.get(), system->getAccess()};
+    for (const ScheduledSystem& earlier : schedule) {
+      if (scheduled.access.conflicts(earlier.access)) {
+        scheduled.stage = std::max(scheduled.stage, earlier.stage + 1);
+      }
+    }
+    schedule.emplace_back(std::move(scheduled));
+    names.emplace_back(name);
+  }
+
+  std::vector<uint32_t> order(schedule.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return schedule[a].stage < schedule[b].stage;
+  });
+  m_schedule.clear();
+  m_systemTimings.clear();
+  for (uint32_t i : order) {
+    m_systemTimings.push_back({std::move(names[i]), schedule[i].stage});
+    m_schedule.emplace_back(std::move(schedule[i]));
+  }
+  m_dirtySchedule = false;
 }
 
 void SceneManager::onUpdate(const Time& ts) {
-  for (const auto& [_, system] : m_systems) {
-    system->update(m_registry, ts);
+#ifdef DEBUG
+  ENGINE_ASSERT(m_entityIndex.matches(m_registry),
+                "Entity index out of step with the registry");
+#endif
+  if (m_dirtySchedule) {
+    buildSchedule();
+  }
+  for (const ScheduledSystem& scheduled : m_schedule) {
+    for (auto assure : scheduled.access.storages) {
+      assure(m_registry);
+    }
+  }
+
+  ThreadPool& thread_pool = *Application::Get().getThreadPool();
+  std::thread::id main_thread = std::this_thread::get_id();
+  auto run = [&](uint32_t i) {
+    Timer timer;
+    m_schedule[i].system->update(m_registry, ts);
+    m_systemTimings[i].milliseconds = timer.getMilliseconds();
+    m_systemTimings[i].mainThread = std::this_thread::get_id() == main_thread;
+  };
+
+  uint32_t begin = 0;
+  while (begin < m_schedule.size()) {
+    uint32_t end = begin;
+    while (end < m_schedule.size() and
+           m_schedule[end].stage == m_schedule[begin].stage) {
+      ++end;
+    }
+
+    // the pool takes the systems that can leave the main thread, the ones
+    // it has not started when the main thread is done with its own are
+    // taken back so the stage does not wait behind unrelated jobs
+    std::vector<std::shared_ptr<std::atomic<bool>>> claims;
+    std::vector<std::future<void>> jobs;
+    std::vector<uint32_t> pooled;
+    if (end - begin > 1) {
+      for (uint32_t i = begin; i < end; ++i) {
+        if (not m_schedule[i].access.canRunOnWorker()) {
+          continue;
+        }
+        auto claim = std::make_shared<std::atomic<bool>>();
+        jobs.emplace_back(thread_pool.submit([claim, run, i]() {
+          if (not claim->exchange(true)) {
+            run(i);
+          }
+        }));
+        claims.emplace_back(std::move(claim));
+        pooled.emplace_back(i);
+      }
+    }
+
+    // a system that throws stops the stage, but the jobs the workers started
+    // hold references to this frame so they are waited for before the error
+    // leaves, and the ones not started are claimed so they never run
+    std::exception_ptr error;
+    auto runHere = [&](uint32_t i) {
+      if (error) {
+        return;
+      }
+      try {
+        run(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    };
+    for (uint32_t i = begin; i < end; ++i) {
+      if (std::find(pooled.begin(), pooled.end(), i) == pooled.end()) {
+        runHere(i);
+      }
+    }
+    for (uint32_t j = 0; j < pooled.size(); ++j) {
+      if (not claims[j]->exchange(true)) {
+        runHere(pooled[j]);
+        continue;
+      }
+      try {
+        // rethrows what the system threw on the worker
+        jobs[j].get();
+      } catch (...) {
+        if (not error) {
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+
+    // the deferred writes of the stage, in priority order
+    for (uint32_t i = begin; i < end; ++i) {
+      Timer timer;
+      m_schedule[i].system->commit(m_registry, ts);
+      m_systemTimings[i].milliseconds += timer.getMilliseconds();
+    }
+    begin = end;
   }
 }
 
 entt::registry& SceneManager::getRegistry() { return m_registry; }
 
 entt::entity SceneManager::getEntity(std::string_view name) {
-  for (const auto& [e, cName, _] : m_registry.view<CName, CUUID>().each()) {
-    if (cName.name == name) {
-      return e;
-    }
-  }
-  ENGINE_ASSERT(false, "Entity with name {} not found", name);
+  entt::entity e = m_entityIndex.find(name);
+  ENGINE_ASSERT(e not_eq entt::null, "Entity with name {} not found", name);
+  return e;
 }
 
 entt::entity SceneManager::getEntity(UUID& uuid) {
-  for (const auto& [e, cUUID] : m_registry.view<CUUID>().each()) {
-    if (cUUID.uuid == uuid) {
-      return e;
-    }
-  }
-  ENGINE_ASSERT(false, "Entity with UUID {} not found", std::to_string(uuid));
+  entt::entity e = m_entityIndex.find(uuid);
+  ENGINE_ASSERT(e not_eq entt::null, "Entity with UUID {} not found",
+                std::to_string(uuid));
+  return e;
 }
 
 const std::vector<std::string>& SceneManager::getNamedSystems() {
@@ -118,10 +251,24 @@ entt::entity SceneManager::createEntity(std::string_view prefabID,
                                      m_registry, std::move(name), tag, uuid);
 }
 
+std::vector<entt::entity>
+SceneManager::createEntities(std::string_view prefabID,
+                             std::string&& prototypeID,
+                             std::vector<std::string>&& names,
+                             std::optional<std::string> tag) {
+  return m_sceneFactory.createEntities(prefabID, std::move(prototypeID),
+                                       m_registry, std::move(names), tag);
+}
+
 entt::entity SceneManager::cloneEntity(const entt::entity& e) {
   return m_sceneFactory.cloneEntity(e, UUID(), m_registry);
 }
 
+std::vector<entt::entity> SceneManager::cloneEntity(const entt::entity& e,
+                                                    uint32_t count) {
+  return m_sceneFactory.cloneEntities(e, count, m_registry);
+}
+
 void SceneManager::removeEntity(entt::entity& e) {
   m_sceneFactory.removeEntity(e, m_registry);
 }
@@ -144,6 +291,7 @@ void SceneManager::clearScene() {
   m_systems.clear();
   m_namedSystems.clear();
   dirtySystems = false;
+  m_dirtySchedule = true;
 }
 
 std::string SceneManager::getActiveScene() const {
@@ -172,12 +320,14 @@ void SceneManager::updatePrototypes(
   m_sceneFactory.getEntityFactory().updatePrototypes(
     prefab_name, prototypeIDs, m_registry,
     Application::Get().getAssetsManager());
+  m_sceneFactory.clearClonePlans();
 }
 
 void SceneManager::destroyPrototypes(
   std::string_view prefab_name, const std::vector<std::string>& prototypeIDs) {
   m_sceneFactory.getEntityFactory().destroyPrototypes(prefab_name, prototypeIDs,
                                                       m_registry);
+  m_sceneFactory.clearClonePlans();
 }
 
 EntityFactory::Prototypes
@@ -205,6 +355,7 @@ SceneManager::getPrototypesCountByPrefab() {
 
 void SceneManager::clearPrototypes() {
   m_sceneFactory.getEntityFactory().clearPrototypes();
+  m_sceneFactory.clearClonePlans();
 }
 
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "assets/assetsManager.h"
 #include "core/time.h"
 #include "events/event.h"
+#include "scene/entityIndex.h"
 #include "scene/sceneFactory.h"
 #include "scene/system.h"
 #include "utils/uuid.h"
@@ -12,14 +13,24 @@
 namespace potatoengine {
 class SceneManager {
   public:
+    struct SystemTiming {
+        std::string name;
+        uint32_t stage{};
+        bool mainThread{};
+        float milliseconds{};
+    };
+
     SceneManager();
     void registerSystem(std::string&& name,
                         std::unique_ptr<systems::System>&& system);
     void unregisterSystem(std::string_view name);
     bool containsSystem(std::string_view name);
     void clearSystems();
+    // systems run in stages, the systems of a stage have no conflicting
+    // accesses and run at the same time, stages keep the priority order
     void onUpdate(const Time& ts);
     entt::registry& getRegistry();
+    // constant time, the registry signals keep an index of the instances
     entt::entity getEntity(std::string_view name);
     entt::entity getEntity(UUID& uuid);
     const std::vector<std::string>& getNamedSystems();
@@ -36,7 +47,13 @@ class SceneManager {
                               std::string&& prototypeID, std::string&& name,
                               std::optional<std::string> tag = std::nullopt,
                               std::optional<uint32_t> uuid = std::nullopt);
+    std::vector<entt::entity>
+    createEntities(std::string_view prefabID, std::string&& prototypeID,
+                   std::vector<std::string>&& names,
+                   std::optional<std::string> tag = std::nullopt);
     entt::entity cloneEntity(const entt::entity& e);
+    std::vector<entt::entity> cloneEntity(const entt::entity& e,
+                                          uint32_t count);
     void removeEntity(entt::entity& e);
 
     void createScene(std::string scene_name, std::string scene_path);
@@ -46,6 +63,10 @@ class SceneManager {
     const std::map<std::string, entt::entity, NumericComparator>&
     getNamedEntities();
     const std::map<std::string, std::string, NumericComparator>& getMetrics();
+    // time of each system in the last update, by stage
+    const std::vector<SystemTiming>& getSystemTimings() const {
+      return m_systemTimings;
+    }
 
     // entity factory methods
     void createPrototypes(std::string_view prefab_name,
@@ -67,12 +88,24 @@ class SceneManager {
     void clearPrototypes();
 
   private:
+    struct ScheduledSystem {
+        systems::System* system{};
+        systems::SystemAccess access;
+        uint32_t stage{};
+    };
+
+    void buildSchedule();
+
     entt::registry m_registry;
+    EntityIndex m_entityIndex;
     SceneFactory m_sceneFactory;
     std::set<std::pair<std::string, std::unique_ptr<systems::System>>,
              systems::SystemComparator>
       m_systems;
     std::vector<std::string> m_namedSystems;
     bool dirtySystems{};
+    std::vector<ScheduledSystem> m_schedule; // sorted by stage
+    bool m_dirtySchedule{};
+    std::vector<SystemTiming> m_systemTimings;
 };
 }
\ No newline at end of file
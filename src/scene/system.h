@@ -8,6 +8,84 @@
 
 namespace potatoengine::systems {
 
+// components a system reads and writes in update, systems whose accesses do
+// not overlap run at the same time. A system that declares nothing runs
+// alone, and one that touches the GL context or the managers of the app
+// runs on the main thread.
+// Deferred components are only changed in commit, which runs on the main
+// thread after the stage in priority order. Systems that defer the same
+// component share a stage and read the values it had before the stage
+struct SystemAccess {
+    std::vector<entt::id_type> reads;
+    std::vector<entt::id_type> writes;
+    std::vector<entt::id_type> defers;
+    // creates the storages before the systems run, entt adds them to the
+    // registry on first use and that can not happen from several threads
+    std::vector<void (*)(entt::registry&)> storages;
+    bool exclusive{true};
+    bool mainThread{};
+
+    template <typename... Components> SystemAccess& read() {
+      (add<Components>(reads), ...);
+      return *this;
+    }
+
+    template <typename... Components> SystemAccess& write() {
+      (add<Components>(writes), ...);
+      return *this;
+    }
+
+    template <typename... Components> SystemAccess& defer() {
+      (add<Components>(defers), ...);
+      return *this;
+    }
+
+    // for systems with nothing to do in update
+    SystemAccess& none() {
+      exclusive = false;
+      return *this;
+    }
+
+    SystemAccess& onMainThread() {
+      exclusive = false;
+      mainThread = true;
+      return *this;
+    }
+
+    bool canRunOnWorker() const { return not exclusive and not mainThread; }
+
+    // this system comes after earlier in priority order, a deferred write
+    // lands after the stage so only the systems after it have to wait
+    bool conflicts(const SystemAccess& earlier) const {
+      if (exclusive or earlier.exclusive) {
+        return true;
+      }
+      auto overlaps = [](const std::vector<entt::id_type>& lhs,
+                         const std::vector<entt::id_type>& rhs) {
+        for (entt::id_type id : lhs) {
+          if (std::find(rhs.begin(), rhs.end(), id) not_eq rhs.end()) {
+            return true;
+          }
+        }
+        return false;
+      };
+      return overlaps(writes, earlier.writes) or
+             overlaps(writes, earlier.reads) or
+             overlaps(writes, earlier.defers) or
+             overlaps(reads, earlier.writes) or
+             overlaps(reads, earlier.defers) or
+             overlaps(defers, earlier.writes);
+    }
+
+  private:
+    template <typename Component> void add(std::vector<entt::id_type>& ids) {
+      exclusive = false;
+      ids.push_back(entt::type_hash<Component>::value());
+      storages.push_back(
+        [](entt::registry& registry) { registry.storage<Component>(); });
+    }
+};
+
 class System {
   public:
     System(int32_t priority = 0) : m_priority(priority) {}
@@ -17,6 +95,9 @@ class System {
 
     virtual void init(entt::registry& registry){};
     virtual void update(entt::registry& registry, const Time& ts){};
+    // applies what update left for the deferred components
+    virtual void commit(entt::registry& registry, const Time& ts){};
+    virtual SystemAccess getAccess() const { return {}; }
 
   protected:
     int32_t m_priority = 0;
@@ -209,7 +209,7 @@ void RegisterComponents() {
     .data<&CMesh::vertices>("vertices"_hs)
     .data<&CMesh::indices>("indices"_hs)
     .data<&CMesh::textures>("textures"_hs)
-    .data<&CMesh::vao>("vao"_hs)
+    .data<&CMesh::geometry>("geometry"_hs)
     .data<&CMesh::vertexType>("vertexType"_hs)
     .func<&CMesh::print>("print"_hs)
     .func<&CMesh::getInfo>("getInfo"_hs)
@@ -433,6 +433,12 @@ void RegisterComponents() {
     .data<&CChunkManager::_meshType>("meshType"_hs)
     .data<&CChunkManager::_meshAlgorithm>("meshAlgorithm"_hs)
     .data<&CChunkManager::useBiomes>("useBiomes"_hs)
+    .data<&CChunkManager::streaming>("streaming"_hs)
+    .data<&CChunkManager::loadRadius>("loadRadius"_hs)
+    .data<&CChunkManager::unloadRadius>("unloadRadius"_hs)
+    .data<&CChunkManager::cacheSize>("cacheSize"_hs)
+    .data<&CChunkManager::uploadsPerFrame>("uploadsPerFrame"_hs)
+    .data<&CChunkManager::remeshBudget>("remeshBudget"_hs)
     .func<&CChunkManager::print>("print"_hs)
     .func<&CChunkManager::getInfo>("getInfo"_hs)
     .func<&onComponentAdded<CChunkManager>, entt::as_ref_t>(
@@ -0,0 +1,53 @@
+#pragma once
+
+#define GLM_FORCE_CTOR_INIT
+#include <glm/glm.hpp>
+
+#include "pch.h"
+
+namespace potatoengine {
+
+// axis aligned bounding box, empty until a point is added
+struct AABB {
+    glm::vec3 min{glm::vec3(std::numeric_limits<float>::max())};
+    glm::vec3 max{glm::vec3(std::numeric_limits<float>::lowest())};
+
+    AABB() = default;
+    AABB(glm::vec3 mi, glm::vec3 ma) : min(mi), max(ma) {}
+
+    bool isValid() const {
+      return min.x <= max.x and min.y <= max.y and min.z <= max.z;
+    }
+
+    void expand(glm::vec3 point) {
+      min = glm::min(min, point);
+      max = glm::max(max, point);
+    }
+    void expand(const AABB& box) {
+      min = glm::min(min, box.min);
+      max = glm::max(max, box.max);
+    }
+
+    bool intersects(const AABB& other) const {
+      return glm::all(glm::lessThanEqual(min, other.max)) and
+             glm::all(glm::lessThanEqual(other.min, max));
+    }
+
+    glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 getExtents() const { return (max - min) * 0.5f; }
+
+    // box around the transformed box, the extents are projected on the axes
+    // instead of transforming the 8 corners
+    AABB transform(const glm::mat4& m) const {
+      glm::vec3 center = glm::vec3(m * glm::vec4(getCenter(), 1.f));
+      glm::vec3 extents = getExtents();
+      glm::vec3 worldExtents = glm::abs(glm::vec3(m[0])) * extents.x +
+                               glm::abs(glm::vec3(m[1])) * extents.y +
+                               glm::abs(glm::vec3(m[2])) * extents.z;
+      return {center - worldExtents, center + worldExtents};
+    }
+
+    bool operator==(const AABB& other) const = default;
+};
+
+}
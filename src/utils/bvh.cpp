@@ -0,0 +1,108 @@
+#include "utils/bvh.h"
+
+#include <numeric>
+
+namespace potatoengine {
+
+void BVH::build(std::vector<AABB>&& boxes) {
+  m_boxes = std::move(boxes);
+  m_nodes.clear();
+  m_parents.clear();
+  m_dirtyItems.clear();
+  m_items.resize(m_boxes.size());
+  std::iota(m_items.begin(), m_items.end(), 0);
+  m_leaves.resize(m_boxes.size());
+  if (m_boxes.empty()) {
+    return;
+  }
+  m_nodes.reserve(2 * m_boxes.size() / LeafSize + 1);
+  m_parents.reserve(m_nodes.capacity());
+  buildNode(0, m_boxes.size(), NoNode);
+}
+
+uint32_t BVH::buildNode(uint32_t first, uint32_t count, uint32_t parent) {
+  uint32_t index = m_nodes.size();
+  m_nodes.emplace_back();
+  m_parents.emplace_back(parent);
+
+  AABB bounds;
+  AABB centers;
+  for (uint32_t i = first; i < first + count; ++i) {
+    bounds.expand(m_boxes[m_items[i]]);
+    centers.expand(m_boxes[m_items[i]].getCenter());
+  }
+  glm::vec3 size = centers.max - centers.min;
+  int axis = size.x > size.y ? (size.x > size.z ? 0 : 2)
+                             : (size.y > size.z ? 1 : 2);
+  // boxes with the same center can not be split
+  if (count <= LeafSize or size[axis] <= 0.f) {
+    m_nodes[index] = {bounds, first, count};
+    for (uint32_t i = first; i < first + count; ++i) {
+      m_leaves[m_items[i]] = index;
+    }
+    return index;
+  }
+
+  uint32_t middle = first + count / 2;
+  std::nth_element(m_items.begin() + first, m_items.begin() + middle,
+                   m_items.begin() + first + count,
+                   [&](uint32_t lhs, uint32_t rhs) {
+                     return m_boxes[lhs].getCenter()[axis] <
+                            m_boxes[rhs].getCenter()[axis];
+                   });
+  buildNode(first, middle - first, index);
+  uint32_t right = buildNode(middle, first + count - middle, index);
+  m_nodes[index] = {bounds, right, 0};
+  return index;
+}
+
+void BVH::update(uint32_t item, const AABB& box) {
+  ENGINE_ASSERT(item < m_boxes.size(), "Item {} not in BVH", item);
+  if (m_boxes[item] == box) {
+    return;
+  }
+  m_boxes[item] = box;
+  m_dirtyItems.emplace_back(item);
+}
+
+void BVH::refit() {
+  for (uint32_t item : m_dirtyItems) {
+    refitLeaf(m_leaves[item]);
+  }
+  m_dirtyItems.clear();
+}
+
+void BVH::refitLeaf(uint32_t index) {
+  Node& leaf = m_nodes[index];
+  AABB bounds;
+  for (uint32_t i = leaf.first; i < leaf.first + leaf.count; ++i) {
+    bounds.expand(m_boxes[m_items[i]]);
+  }
+  if (bounds == leaf.bounds) {
+    return;
+  }
+  leaf.bounds = bounds;
+
+  // the ancestors above an unchanged node are already up to date
+  for (uint32_t parent = m_parents[index]; parent not_eq NoNode;
+       parent = m_parents[parent]) {
+    Node& node = m_nodes[parent];
+    AABB parentBounds = m_nodes[parent + 1].bounds;
+    parentBounds.expand(m_nodes[node.first].bounds);
+    if (parentBounds == node.bounds) {
+      return;
+    }
+    node.bounds = parentBounds;
+  }
+}
+
+void BVH::clear() {
+  m_nodes.clear();
+  m_parents.clear();
+  m_items.clear();
+  m_leaves.clear();
+  m_boxes.clear();
+  m_dirtyItems.clear();
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#define GLM_FORCE_CTOR_INIT
+#include <glm/glm.hpp>
+
+#include "pch.h"
+#include "utils/aabb.h"
+
+namespace potatoengine {
+
+// bounding volume hierarchy over boxes identified by their index in build.
+// It is built top down splitting the longest axis of the centers at the
+// median, and nodes are stored depth first so the left child of a node is the
+// next one. Moving a few boxes only refits the nodes above them, adding or
+// removing boxes needs a new build
+class BVH {
+  public:
+    void build(std::vector<AABB>&& boxes);
+    // refit must be called before the next query
+    void update(uint32_t item, const AABB& box);
+    void refit();
+    void clear();
+
+    uint32_t size() const { return m_boxes.size(); }
+    bool empty() const { return m_boxes.empty(); }
+    const AABB& getBox(uint32_t item) const { return m_boxes[item]; }
+    uint32_t getNodeCount() const { return m_nodes.size(); }
+
+    // calls f(item) for each box where overlaps(box) is true, whole subtrees
+    // are skipped when overlaps is false for their bounds
+    template <class Overlaps, class F>
+    void query(Overlaps&& overlaps, F&& f) const {
+      if (m_nodes.empty()) {
+        return;
+      }
+      std::array<uint32_t, MaxDepth> stack;
+      uint32_t size = 0;
+      stack[size++] = 0;
+      while (size > 0) {
+        uint32_t index = stack[--size];
+        const Node& node = m_nodes[index];
+        if (not overlaps(node.bounds)) {
+          continue;
+        }
+        if (node.count > 0) {
+          for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            if (overlaps(m_boxes[m_items[i]])) {
+              f(m_items[i]);
+            }
+          }
+        } else {
+          stack[size++] = node.first;
+          stack[size++] = index + 1;
+        }
+      }
+    }
+
+  private:
+    // median splits keep the tree balanced, 64 levels is far more than
+    // any scene needs
+    static constexpr uint32_t MaxDepth = 64;
+    static constexpr uint32_t LeafSize = 4;
+    static constexpr uint32_t NoNode = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        AABB bounds;
+        uint32_t first{}; // first of m_items in leaves, right child otherwise
+        uint32_t count{}; // items of leaves, 0 for inner nodes
+    };
+
+    uint32_t buildNode(uint32_t first, uint32_t count, uint32_t parent);
+    void refitLeaf(uint32_t index);
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_items;  // grouped by leaf
+    std::vector<uint32_t> m_leaves; // leaf of each item
+    std::vector<AABB> m_boxes;
+    std::vector<uint32_t> m_dirtyItems;
+};
+
+}
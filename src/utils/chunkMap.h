@@ -0,0 +1,253 @@
+#pragma once
+
+#define GLM_FORCE_CTOR_INIT
+#include <glm/glm.hpp>
+
+#include "pch.h"
+
+namespace potatoengine {
+
+// map from integer chunk coords to chunks. Values live in pages of fixed
+// capacity so their addresses never change while the map grows, and iterating
+// walks them in memory order. Lookups go through an open addressing table
+// with linear probing that only holds the key and the slot of the value.
+template <class T> class ChunkMap {
+  public:
+    using Entry = std::pair<glm::ivec3, T>;
+
+    template <bool Const> class Iterator {
+      public:
+        using Map = std::conditional_t<Const, const ChunkMap, ChunkMap>;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const Entry&, Entry&>;
+        using pointer = std::conditional_t<Const, const Entry*, Entry*>;
+
+        Iterator() = default;
+        Iterator(Map* map, uint32_t slot) : m_map(map), m_slot(slot) {
+          skipErased();
+        }
+
+        reference operator*() const { return m_map->getEntry(m_slot); }
+        pointer operator->() const { return &m_map->getEntry(m_slot); }
+
+        Iterator& operator++() {
+          ++m_slot;
+          skipErased();
+          return *this;
+        }
+        Iterator operator++(int) {
+          Iterator it = *this;
+          ++*this;
+          return it;
+        }
+
+        bool operator==(const Iterator& other) const {
+          return m_slot == other.m_slot;
+        }
+
+        operator Iterator<true>() const
+          requires(not Const)
+        {
+          return {m_map, m_slot};
+        }
+
+      private:
+        void skipErased() {
+          while (m_slot < m_map->getSlotCount() and
+                 not m_map->m_alive[m_slot]) {
+            ++m_slot;
+          }
+        }
+
+        Map* m_map{};
+        uint32_t m_slot{};
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, getSlotCount()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, getSlotCount()}; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    iterator find(const glm::ivec3& key) {
+      return {this, findSlot(key)};
+    }
+    const_iterator find(const glm::ivec3& key) const {
+      return {this, findSlot(key)};
+    }
+    bool contains(const glm::ivec3& key) const {
+      return findSlot(key) not_eq getSlotCount();
+    }
+
+    // throws std::out_of_range when the key is missing, like std::unordered_map
+    T& at(const glm::ivec3& key) { return getEntry(findExisting(key)).second; }
+    const T& at(const glm::ivec3& key) const {
+      return getEntry(findExisting(key)).second;
+    }
+
+    // does nothing when the key is already present, like std::unordered_map
+    std::pair<iterator, bool> emplace(const glm::ivec3& key, T&& value) {
+      // a present key must not grow the table
+      if (uint32_t slot = findSlot(key); slot not_eq getSlotCount()) {
+        return {iterator{this, slot}, false};
+      }
+      if ((m_size + 1) * 2 > m_buckets.size()) {
+        rehash(std::max<size_t>(16, m_buckets.size() * 2));
+      }
+
+      size_t bucket = getBucket(key);
+      uint32_t slot = allocate(key, std::move(value));
+      m_buckets[bucket] = {key, slot};
+      ++m_size;
+      return {iterator{this, slot}, true};
+    }
+
+    bool erase(const glm::ivec3& key) {
+      if (m_buckets.empty()) {
+        return false;
+      }
+      size_t bucket = getBucket(key);
+      if (m_buckets[bucket].slot == Empty) {
+        return false;
+      }
+
+      uint32_t slot = m_buckets[bucket].slot;
+      getEntry(slot).second = T{}; // releases the chunk now, not on reuse
+      m_alive[slot] = false;
+      m_free.push_back(slot);
+      --m_size;
+
+      // backward shift deletion, pulls later entries of the probe sequence
+      // into the hole so lookups never need tombstones
+      size_t mask = m_buckets.size() - 1;
+      size_t hole = bucket;
+      for (size_t i = (bucket + 1) & mask; m_buckets[i].slot not_eq Empty;
+           i = (i + 1) & mask) {
+        size_t home = hash(m_buckets[i].key) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+          m_buckets[hole] = m_buckets[i];
+          hole = i;
+        }
+      }
+      m_buckets[hole].slot = Empty;
+      return true;
+    }
+
+    iterator erase(iterator it) {
+      iterator next = std::next(it);
+      erase(it->first);
+      return next;
+    }
+
+    void clear() {
+      m_pages.clear();
+      m_alive.clear();
+      m_free.clear();
+      m_buckets.clear();
+      m_size = 0;
+    }
+
+  private:
+    static constexpr uint32_t PageSize = 64;
+    static constexpr uint32_t Empty = std::numeric_limits<uint32_t>::max();
+
+    struct Bucket {
+        glm::ivec3 key{};
+        uint32_t slot{Empty};
+    };
+
+    static size_t hash(const glm::ivec3& key) {
+      uint32_t h = static_cast<uint32_t>(key.x) * 73856093u ^
+                   static_cast<uint32_t>(key.y) * 19349663u ^
+                   static_cast<uint32_t>(key.z) * 83492791u;
+      // the table masks the low bits, mix the high ones into them
+      h ^= h >> 16;
+      h *= 0x7feb352du;
+      h ^= h >> 15;
+      return h;
+    }
+
+    uint32_t getSlotCount() const {
+      return static_cast<uint32_t>(m_alive.size());
+    }
+
+    Entry& getEntry(uint32_t slot) {
+      return m_pages[slot / PageSize][slot % PageSize];
+    }
+    const Entry& getEntry(uint32_t slot) const {
+      return m_pages[slot / PageSize][slot % PageSize];
+    }
+
+    // bucket holding the key or the empty one where it would go
+    size_t getBucket(const glm::ivec3& key) const {
+      size_t mask = m_buckets.size() - 1;
+      size_t i = hash(key) & mask;
+      while (m_buckets[i].slot not_eq Empty and m_buckets[i].key not_eq key) {
+        i = (i + 1) & mask;
+      }
+      return i;
+    }
+
+    uint32_t findSlot(const glm::ivec3& key) const {
+      if (m_buckets.empty()) {
+        return getSlotCount();
+      }
+      uint32_t slot = m_buckets[getBucket(key)].slot;
+      return slot == Empty ? getSlotCount() : slot;
+    }
+
+    uint32_t findExisting(const glm::ivec3& key) const {
+      uint32_t slot = findSlot(key);
+      if (slot == getSlotCount()) {
+        throw std::out_of_range(
+          std::format("Chunk {} {} {} not found", key.x, key.y, key.z));
+      }
+      return slot;
+    }
+
+    uint32_t allocate(const glm::ivec3& key, T&& value) {
+      if (not m_free.empty()) {
+        uint32_t slot = m_free.back();
+        m_free.pop_back();
+        getEntry(slot) = {key, std::move(value)};
+        m_alive[slot] = true;
+        return slot;
+      }
+
+      if (m_pages.empty() or m_pages.back().size() == PageSize) {
+        m_pages.emplace_back().reserve(PageSize);
+      } else if (m_pages.back().capacity() < PageSize) {
+        m_pages.back().reserve(PageSize); // pages of a copied map
+      }
+      m_pages.back().emplace_back(key, std::move(value));
+      m_alive.push_back(true);
+      return getSlotCount() - 1;
+    }
+
+    void rehash(size_t bucketCount) {
+      m_buckets.assign(bucketCount, Bucket{});
+      for (uint32_t slot = 0; slot < getSlotCount(); ++slot) {
+        if (m_alive[slot]) {
+          m_buckets[getBucket(getEntry(slot).first)] = {getEntry(slot).first,
+                                                        slot};
+        }
+      }
+    }
+
+    // moving a page keeps its buffer, so entries stay where they are when
+    // m_pages grows
+    std::vector<std::vector<Entry>> m_pages;
+    std::vector<uint8_t> m_alive;
+    std::vector<uint32_t> m_free;
+    std::vector<Bucket> m_buckets; // power of two, at most half full
+    size_t m_size{};
+};
+
+}
@@ -0,0 +1,294 @@
+#include "utils/meshSimplifier.h"
+
+#include <numeric>
+
+#include "utils/aabb.h"
+
+namespace potatoengine {
+
+namespace {
+// meshes under this many triangles are cheap enough to draw at full detail
+constexpr uint32_t MinTriangles = 64;
+// the planes along open edges weigh more so silhouettes and holes keep shape
+constexpr double BorderWeight = 10.0;
+
+// symmetric 4x4 matrix of the summed plane equations, evaluating it at a
+// point gives the sum of squared distances to those planes
+struct Quadric {
+    double a2{}, ab{}, ac{}, ad{};
+    double b2{}, bc{}, bd{};
+    double c2{}, cd{};
+    double d2{};
+
+    Quadric() = default;
+    Quadric(glm::dvec3 n, double d, double w)
+      : a2(w * n.x * n.x), ab(w * n.x * n.y), ac(w * n.x * n.z),
+        ad(w * n.x * d), b2(w * n.y * n.y), bc(w * n.y * n.z),
+        bd(w * n.y * d), c2(w * n.z * n.z), cd(w * n.z * d), d2(w * d * d) {}
+
+    Quadric& operator+=(const Quadric& q) {
+      a2 += q.a2;
+      ab += q.ab;
+      ac += q.ac;
+      ad += q.ad;
+      b2 += q.b2;
+      bc += q.bc;
+      bd += q.bd;
+      c2 += q.c2;
+      cd += q.cd;
+      d2 += q.d2;
+      return *this;
+    }
+
+    double evaluate(glm::dvec3 p) const {
+      return a2 * p.x * p.x + 2 * ab * p.x * p.y + 2 * ac * p.x * p.z +
+             2 * ad * p.x + b2 * p.y * p.y + 2 * bc * p.y * p.z +
+             2 * bd * p.y + c2 * p.z * p.z + 2 * cd * p.z + d2;
+    }
+};
+
+struct Collapse {
+    uint32_t from{};
+    uint32_t to{};
+    double cost{};
+};
+
+uint64_t edgeKey(uint32_t a, uint32_t b) {
+  return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+}
+}
+
+std::vector<uint32_t>
+MeshSimplifier::Simplify(const std::vector<Vertex>& vertices,
+                         const std::vector<uint32_t>& indices,
+                         uint32_t targetIndexCount, float targetError) {
+  ENGINE_ASSERT(indices.size() % 3 == 0, "Mesh is not made of triangles");
+  std::vector<uint32_t> result = indices;
+  if (result.size() <= targetIndexCount or vertices.empty()) {
+    return result;
+  }
+
+  // weld the vertices sharing a position into groups, the edges are
+  // collapsed between groups so seams do not tear the mesh apart
+  std::vector<uint32_t> sorted(vertices.size());
+  std::iota(sorted.begin(), sorted.end(), 0);
+  auto lessPosition = [&](uint32_t lhs, uint32_t rhs) {
+    const glm::vec3& a = vertices[lhs].position;
+    const glm::vec3& b = vertices[rhs].position;
+    return a.x < b.x or
+           (a.x == b.x and (a.y < b.y or (a.y == b.y and a.z < b.z)));
+  };
+  std::sort(sorted.begin(), sorted.end(), lessPosition);
+  std::vector<uint32_t> vertexGroup(vertices.size());
+  std::vector<uint32_t> groupVertex;
+  for (uint32_t i = 0; i < sorted.size(); ++i) {
+    if (i == 0 or vertices[sorted[i]].position not_eq
+                    vertices[sorted[i - 1]].position) {
+      groupVertex.emplace_back(sorted[i]);
+    }
+    vertexGroup[sorted[i]] = groupVertex.size() - 1;
+  }
+  uint32_t groupCount = groupVertex.size();
+
+  std::vector<uint32_t> corners(result.size());
+  for (uint32_t i = 0; i < result.size(); ++i) {
+    corners[i] = vertexGroup[result[i]];
+  }
+  auto position = [&](uint32_t group) {
+    return glm::dvec3(vertices[groupVertex[group]].position);
+  };
+
+  AABB bounds;
+  for (const Vertex& vertex : vertices) {
+    bounds.expand(vertex.position);
+  }
+  double diagonal = glm::length(glm::dvec3(bounds.max - bounds.min));
+  double maxError = targetError * diagonal * targetError * diagonal;
+
+  std::vector<Quadric> quadrics(groupCount);
+  std::unordered_map<uint64_t, uint32_t> edgeUses;
+  for (uint32_t i = 0; i < corners.size(); i += 3) {
+    glm::dvec3 p0 = position(corners[i]);
+    glm::dvec3 p1 = position(corners[i + 1]);
+    glm::dvec3 p2 = position(corners[i + 2]);
+    glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+    double length = glm::length(normal);
+    if (length == 0.0) {
+      continue;
+    }
+    normal /= length;
+    Quadric plane(normal, -glm::dot(normal, p0), 1.0);
+    for (uint32_t j = 0; j < 3; ++j) {
+      quadrics[corners[i + j]] += plane;
+      ++edgeUses[edgeKey(corners[i + j], corners[i + (j + 1) % 3])];
+    }
+  }
+  for (uint32_t i = 0; i < corners.size(); i += 3) {
+    glm::dvec3 p0 = position(corners[i]);
+    glm::dvec3 normal = glm::cross(position(corners[i + 1]) - p0,
+                                   position(corners[i + 2]) - p0);
+    for (uint32_t j = 0; j < 3; ++j) {
+      uint32_t a = corners[i + j];
+      uint32_t b = corners[i + (j + 1) % 3];
+      if (edgeUses[edgeKey(a, b)] not_eq 1) {
+        continue;
+      }
+      glm::dvec3 side = glm::cross(position(b) - position(a), normal);
+      double length = glm::length(side);
+      if (length == 0.0) {
+        continue;
+      }
+      side /= length;
+      Quadric border(side, -glm::dot(side, position(a)), BorderWeight);
+      quadrics[a] += border;
+      quadrics[b] += border;
+    }
+  }
+
+  // greedy passes over the cheapest collapses, a group touched by one
+  // collapse waits for the next pass so the costs stay valid
+  std::vector<uint32_t> collapsedInto(groupCount);
+  std::vector<uint8_t> touched(groupCount);
+  std::vector<uint32_t> offsets(groupCount + 1);
+  std::vector<uint32_t> adjacency;
+  std::vector<Collapse> collapses;
+  uint32_t triangleCount = corners.size() / 3;
+  uint32_t targetTriangles = targetIndexCount / 3;
+  while (triangleCount > targetTriangles) {
+    // triangles around each group
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for (uint32_t group : corners) {
+      ++offsets[group + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    adjacency.resize(corners.size());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (uint32_t i = 0; i < corners.size(); ++i) {
+      adjacency[cursor[corners[i]]++] = i / 3;
+    }
+
+    collapses.clear();
+    for (uint32_t i = 0; i < corners.size(); i += 3) {
+      for (uint32_t j = 0; j < 3; ++j) {
+        uint32_t a = corners[i + j];
+        uint32_t b = corners[i + (j + 1) % 3];
+        Quadric q = quadrics[a];
+        q += quadrics[b];
+        collapses.push_back({a, b, q.evaluate(position(b))});
+        collapses.push_back({b, a, q.evaluate(position(a))});
+      }
+    }
+    std::sort(collapses.begin(), collapses.end(),
+              [](const Collapse& lhs, const Collapse& rhs) {
+                return lhs.cost < rhs.cost;
+              });
+
+    std::iota(collapsedInto.begin(), collapsedInto.end(), 0);
+    std::fill(touched.begin(), touched.end(), 0);
+    uint32_t removed = 0;
+    for (const Collapse& collapse : collapses) {
+      if (collapse.cost > maxError or
+          triangleCount - removed <= targetTriangles) {
+        break;
+      }
+      if (touched[collapse.from] or touched[collapse.to]) {
+        continue;
+      }
+
+      // moving the group must not flip any triangle that survives
+      bool flips = false;
+      uint32_t degenerate = 0;
+      glm::dvec3 target = position(collapse.to);
+      for (uint32_t k = offsets[collapse.from];
+           k < offsets[collapse.from + 1] and not flips; ++k) {
+        const uint32_t* triangle = &corners[adjacency[k] * 3];
+        if (triangle[0] == collapse.to or triangle[1] == collapse.to or
+            triangle[2] == collapse.to) {
+          ++degenerate;
+          continue;
+        }
+        glm::dvec3 p[3];
+        glm::dvec3 q[3];
+        for (uint32_t j = 0; j < 3; ++j) {
+          p[j] = position(triangle[j]);
+          q[j] = triangle[j] == collapse.from ? target : p[j];
+        }
+        glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+        glm::dvec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+        // slivers that are already flat can not flip
+        flips = glm::dot(before, after) <= 0.0 and
+                glm::dot(before, before) > 0.0;
+      }
+      if (flips) {
+        continue;
+      }
+
+      collapsedInto[collapse.from] = collapse.to;
+      quadrics[collapse.to] += quadrics[collapse.from];
+      for (uint32_t k = offsets[collapse.from];
+           k < offsets[collapse.from + 1]; ++k) {
+        for (uint32_t j = 0; j < 3; ++j) {
+          touched[corners[adjacency[k] * 3 + j]] = 1;
+        }
+      }
+      removed += degenerate;
+    }
+    if (removed == 0) {
+      break;
+    }
+
+    // moved corners take the vertex of their new group, the others keep
+    // their own vertex and with it their normal and texture coordinates
+    uint32_t write = 0;
+    for (uint32_t i = 0; i < corners.size(); i += 3) {
+      uint32_t triangle[3];
+      uint32_t vertex[3];
+      for (uint32_t j = 0; j < 3; ++j) {
+        uint32_t group = corners[i + j];
+        triangle[j] = collapsedInto[group];
+        vertex[j] = triangle[j] == group ? result[i + j]
+                                         : groupVertex[triangle[j]];
+      }
+      if (triangle[0] == triangle[1] or triangle[1] == triangle[2] or
+          triangle[0] == triangle[2]) {
+        continue;
+      }
+      for (uint32_t j = 0; j < 3; ++j) {
+        corners[write] = triangle[j];
+        result[write++] = vertex[j];
+      }
+    }
+    corners.resize(write);
+    result.resize(write);
+    triangleCount = write / 3;
+  }
+  return result;
+}
+
+std::vector<std::vector<uint32_t>>
+MeshSimplifier::GenerateLODs(const std::vector<Vertex>& vertices,
+                             const std::vector<uint32_t>& indices,
+                             uint32_t maxLODs) {
+  std::vector<std::vector<uint32_t>> lods;
+  if (indices.size() / 3 < MinTriangles) {
+    return lods;
+  }
+  for (uint32_t level = 1; level <= maxLODs; ++level) {
+    const std::vector<uint32_t>& source = lods.empty() ? indices : lods.back();
+    uint32_t target = (indices.size() >> level) / 3 * 3;
+    if (target / 3 < MinTriangles / 2) {
+      break;
+    }
+    // each level may drift twice as far from the surface as the previous one
+    float error = 0.01f * static_cast<float>(1 << (level - 1));
+    std::vector<uint32_t> lod = Simplify(vertices, source, target, error);
+    // a level that keeps most of the triangles is not worth its buffer
+    if (lod.size() > source.size() * 4 / 5) {
+      break;
+    }
+    lods.emplace_back(std::move(lod));
+  }
+  return lods;
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "render/buffer.h"
+
+namespace potatoengine {
+
+// quadric error edge collapse (Garland and Heckbert) that only rewrites the
+// indices, the simplified triangles keep using the vertices of the mesh so
+// every level of detail can share its vertex buffer. Vertices are welded by
+// position first so uv and normal seams collapse together, the corners that
+// do not move keep their own attributes
+class MeshSimplifier {
+  public:
+    // collapses edges until the indices fit in targetIndexCount or the next
+    // collapse would move the surface more than targetError, relative to
+    // the size of the mesh
+    static std::vector<uint32_t> Simplify(const std::vector<Vertex>& vertices,
+                                          const std::vector<uint32_t>& indices,
+                                          uint32_t targetIndexCount,
+                                          float targetError);
+
+    // up to maxLODs levels halving the triangles of the previous one, stops
+    // early when a level can not remove enough of them
+    static std::vector<std::vector<uint32_t>>
+    GenerateLODs(const std::vector<Vertex>& vertices,
+                 const std::vector<uint32_t>& indices, uint32_t maxLODs);
+};
+}
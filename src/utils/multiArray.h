@@ -2,6 +2,9 @@
 
 #include <array>
 #include <cstddef>
+#include <vector>
+
+namespace potatoengine {
 
 // https://stackoverflow.com/questions/76860140/convenient-way-to-declare-2d-or-even-higher-dimension-arrays-with-stdarray
 // https://www.learncpp.com/cpp-tutorial/multidimensional-stdarray/
@@ -13,4 +16,38 @@ template <class T, std::size_t size> struct MDArray<T, size> {
     using type = std::array<T, size>;
 };
 
-template <class T, std::size_t... sizes> using Array = typename MDArray<T, sizes...>::type;
\ No newline at end of file
+template <class T, std::size_t... sizes> using Array = typename MDArray<T, sizes...>::type;
+
+// runtime sized 2d array stored contiguously in row major order, one
+// allocation per grid instead of one per row
+template <class T> class Grid {
+  public:
+    Grid() = default;
+    Grid(std::size_t rows, std::size_t cols, const T& value = T{})
+      : m_rows(rows), m_cols(cols), m_data(rows * cols, value) {}
+
+    T& operator()(std::size_t row, std::size_t col) {
+      return m_data[row * m_cols + col];
+    }
+    const T& operator()(std::size_t row, std::size_t col) const {
+      return m_data[row * m_cols + col];
+    }
+
+    std::size_t getRows() const { return m_rows; }
+    std::size_t getCols() const { return m_cols; }
+    std::size_t size() const { return m_data.size(); }
+    T* data() { return m_data.data(); }
+    const T* data() const { return m_data.data(); }
+
+    auto begin() { return m_data.begin(); }
+    auto end() { return m_data.end(); }
+    auto begin() const { return m_data.begin(); }
+    auto end() const { return m_data.end(); }
+
+  private:
+    std::size_t m_rows{};
+    std::size_t m_cols{};
+    std::vector<T> m_data;
+};
+
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "pch.h"
+
+namespace potatoengine {
+
+// cube of size^3 values stored as indices into a palette of the distinct
+// values, packed in 4, 8 or 16 bits depending on the palette size. Volumes at
+// rest can be compressed to runs of equal indices, get still works on them
+// and set decompresses first.
+// Values are laid out x fastest, then z, then y.
+template <class T> class PalettedVolume {
+  public:
+    PalettedVolume() = default;
+    explicit PalettedVolume(uint32_t size, const T& value = T{})
+      : m_size(size), m_palette{value}, m_bits(4),
+        m_indices(getIndicesBytes(size * size * size, 4)) {}
+
+    uint32_t getSize() const { return m_size; }
+    uint32_t getCount() const { return m_size * m_size * m_size; }
+    const std::vector<T>& getPalette() const { return m_palette; }
+    uint32_t getBitsPerIndex() const { return m_bits; }
+    bool isCompressed() const { return not m_runs.empty(); }
+
+    const T& get(uint32_t x, uint32_t y, uint32_t z) const {
+      return m_palette[getPaletteIndex(getIndex(x, y, z))];
+    }
+
+    void set(uint32_t x, uint32_t y, uint32_t z, const T& value) {
+      decompress();
+      setPaletteIndex(getIndex(x, y, z), findOrAddToPalette(value));
+    }
+
+    // replaces the dense indices with runs and drops unused palette entries,
+    // noisy volumes whose runs would take more memory are left as they are
+    void compress() {
+      if (isCompressed() or getCount() == 0) {
+        return;
+      }
+
+      std::vector<uint32_t> used(m_palette.size());
+      uint32_t count = getCount();
+      for (uint32_t i = 0; i < count; ++i) {
+        ++used[getPaletteIndex(i)];
+      }
+      std::vector<uint16_t> remap(m_palette.size());
+      std::vector<T> palette;
+      for (uint32_t i = 0; i < m_palette.size(); ++i) {
+        if (used[i] > 0) {
+          remap[i] = static_cast<uint16_t>(palette.size());
+          palette.push_back(m_palette[i]);
+        }
+      }
+
+      std::vector<Run> runs;
+      for (uint32_t i = 0; i < count; ++i) {
+        uint16_t index = remap[getPaletteIndex(i)];
+        if (not runs.empty() and runs.back().index == index) {
+          runs.back().end = i + 1;
+        } else {
+          runs.push_back({i + 1, index});
+        }
+      }
+      if (runs.size() * sizeof(Run) >=
+          getIndicesBytes(count, getBitsFor(palette.size()))) {
+        return;
+      }
+
+      runs.shrink_to_fit();
+      m_runs = std::move(runs);
+      m_palette = std::move(palette);
+      m_bits = getBitsFor(m_palette.size());
+      m_indices.clear();
+      m_indices.shrink_to_fit();
+    }
+
+    void decompress() {
+      if (not isCompressed()) {
+        return;
+      }
+
+      m_indices.assign(getIndicesBytes(getCount(), m_bits), 0);
+      uint32_t begin = 0;
+      for (const Run& run : m_runs) {
+        for (uint32_t i = begin; i < run.end; ++i) {
+          setPaletteIndex(i, run.index);
+        }
+        begin = run.end;
+      }
+      m_runs.clear();
+      m_runs.shrink_to_fit();
+    }
+
+    // heap and inline bytes used by the volume
+    size_t getBytes() const {
+      return sizeof(*this) + m_palette.capacity() * sizeof(T) +
+             m_indices.capacity() + m_runs.capacity() * sizeof(Run);
+    }
+
+  private:
+    struct Run {
+        uint32_t end; // exclusive, runs are sorted by it
+        uint16_t index;
+    };
+
+    static uint32_t getBitsFor(size_t paletteSize) {
+      if (paletteSize <= 16) {
+        return 4;
+      } else if (paletteSize <= 256) {
+        return 8;
+      }
+      return 16;
+    }
+
+    static size_t getIndicesBytes(uint32_t count, uint32_t bits) {
+      return (static_cast<size_t>(count) * bits + 7) / 8;
+    }
+
+    uint32_t getIndex(uint32_t x, uint32_t y, uint32_t z) const {
+      ENGINE_ASSERT(x < m_size and y < m_size and z < m_size,
+                    "Position {} {} {} out of volume of size {}", x, y, z,
+                    m_size);
+      return (y * m_size + z) * m_size + x;
+    }
+
+    uint16_t getPaletteIndex(uint32_t i) const {
+      if (isCompressed()) {
+        auto run = std::upper_bound(
+          m_runs.begin(), m_runs.end(), i,
+          [](uint32_t value, const Run& run) { return value < run.end; });
+        return run->index;
+      }
+      switch (m_bits) {
+      case 4: return (m_indices[i >> 1] >> ((i & 1) << 2)) & 0xF;
+      case 8: return m_indices[i];
+      default: return m_indices[2 * i] | (m_indices[2 * i + 1] << 8);
+      }
+    }
+
+    void setPaletteIndex(uint32_t i, uint16_t index) {
+      switch (m_bits) {
+      case 4: {
+        uint32_t shift = (i & 1) << 2;
+        m_indices[i >> 1] =
+          (m_indices[i >> 1] & ~(0xF << shift)) | (index << shift);
+        break;
+      }
+      case 8: m_indices[i] = static_cast<uint8_t>(index); break;
+      default:
+        m_indices[2 * i] = static_cast<uint8_t>(index);
+        m_indices[2 * i + 1] = static_cast<uint8_t>(index >> 8);
+        break;
+      }
+    }
+
+    uint16_t findOrAddToPalette(const T& value) {
+      auto it = std::find(m_palette.begin(), m_palette.end(), value);
+      if (it not_eq m_palette.end()) {
+        return static_cast<uint16_t>(it - m_palette.begin());
+      }
+
+      ENGINE_ASSERT(m_palette.size() < 65536, "Palette is full");
+      m_palette.push_back(value);
+      uint32_t bits = getBitsFor(m_palette.size());
+      if (bits not_eq m_bits) {
+        repack(bits);
+      }
+      return static_cast<uint16_t>(m_palette.size() - 1);
+    }
+
+    void repack(uint32_t bits) {
+      uint32_t count = getCount();
+      std::vector<uint16_t> indices(count);
+      for (uint32_t i = 0; i < count; ++i) {
+        indices[i] = getPaletteIndex(i);
+      }
+      m_bits = bits;
+      m_indices.assign(getIndicesBytes(count, bits), 0);
+      for (uint32_t i = 0; i < count; ++i) {
+        setPaletteIndex(i, indices[i]);
+      }
+    }
+
+    uint32_t m_size{};
+    std::vector<T> m_palette;
+    uint32_t m_bits{4};
+    std::vector<uint8_t> m_indices;
+    std::vector<Run> m_runs;
+};
+
+}
@@ -2,26 +2,47 @@
 
 #include <numbers>
 
+#include "core/application.h"
+
 namespace potatoengine {
 
-std::shared_ptr<VAO> ShapeFactory::CreateShape(const std::vector<ShapeVertex>& vertices,
-                                               const std::vector<uint32_t>& indices) {
-  std::shared_ptr<VAO> vao = VAO::Create();
-  vao->attachVertex(VBO::CreateShape(vertices), VAO::VertexType::SHAPE_VERTEX);
-  vao->setIndex(IBO::Create(indices));
-  return vao;
+namespace {
+// shapes still in use by their parameters
+std::unordered_map<std::string, std::weak_ptr<GeometryPool::Mesh>> shapes;
+}
+
+std::shared_ptr<GeometryPool::Mesh> ShapeFactory::Find(const std::string& key) {
+  auto it = shapes.find(key);
+  return it == shapes.end() ? nullptr : it->second.lock();
+}
+
+std::shared_ptr<GeometryPool::Mesh> ShapeFactory::CreateShape(std::string&& key,
+                                                              const std::vector<ShapeVertex>& vertices,
+                                                              const std::vector<uint32_t>& indices) {
+  auto& geometryPool = Application::Get().getRenderManager()->getGeometryPool();
+  std::shared_ptr<GeometryPool::Mesh> mesh = geometryPool.add(vertices, indices);
+  shapes[std::move(key)] = mesh;
+  return mesh;
 }
 
-std::shared_ptr<VAO> ShapeFactory::CreateTriangle(float size) {
+std::shared_ptr<GeometryPool::Mesh> ShapeFactory::CreateTriangle(float size) {
+  std::string key = std::format("triangle {}", size);
+  if (auto mesh = Find(key)) {
+    return mesh;
+  }
   std::vector<ShapeVertex> vertices = {
       {{0.f, size, 0.f}, {0.5f, 1.f}}, {{-size, -size, 0.f}, {0.f, 0.f}}, {{size, -size, 0.f}, {1.f, 0.f}}};
 
   std::vector<uint32_t> indices = {0, 1, 2};
 
-  return CreateShape(vertices, indices);
+  return CreateShape(std::move(key), vertices, indices);
 }
 
-std::shared_ptr<VAO> ShapeFactory::CreateRectangle(float width, float height, bool repeatTexture) {
+std::shared_ptr<GeometryPool::Mesh> ShapeFactory::CreateRectangle(float width, float height, bool repeatTexture) {
+  std::string key = std::format("rectangle {} {} {}", width, height, repeatTexture);
+  if (auto mesh = Find(key)) {
+    return mesh;
+  }
   uint32_t overflow = 1;
   if (repeatTexture) {
     ENGINE_ASSERT(width == height, "Cannot repeat texture on non-square shape");
@@ -35,10 +56,15 @@ std::shared_ptr<VAO> ShapeFactory::CreateRectangle(float width, float height, bo
 
   std::vector<uint32_t> indices = {0, 1, 2, 2, 3, 0};
 
-  return CreateShape(vertices, indices);
+  return CreateShape(std::move(key), vertices, indices);
 }
 
-std::shared_ptr<VAO> ShapeFactory::CreateCube(float width, float height, float depth, bool repeatTexture) {
+std::shared_ptr<GeometryPool::Mesh> ShapeFactory::CreateCube(float width, float height, float depth,
+                                                             bool repeatTexture) {
+  std::string key = std::format("cube {} {} {} {}", width, height, depth, repeatTexture);
+  if (auto mesh = Find(key)) {
+    return mesh;
+  }
   uint32_t overflow = 1;
   if (repeatTexture) {
     ENGINE_ASSERT(width == height, "Cannot repeat texture on non-square shape");
@@ -81,10 +107,14 @@ std::shared_ptr<VAO> ShapeFactory::CreateCube(float width, float height, float d
                                    // bottom and top
                                    16, 17, 18, 18, 19, 16, 20, 21, 22, 22, 23, 20};
 
-  return CreateShape(vertices, indices);
+  return CreateShape(std::move(key), vertices, indices);
 }
 
-std::shared_ptr<VAO> ShapeFactory::CreateCircle(float radius, uint32_t segments) {
+std::shared_ptr<GeometryPool::Mesh> ShapeFactory::CreateCircle(float radius, uint32_t segments) {
+  std::string key = std::format("circle {} {}", radius, segments);
+  if (auto mesh = Find(key)) {
+    return mesh;
+  }
   std::vector<ShapeVertex> vertices;
   std::vector<uint32_t> indices;
 
@@ -107,7 +137,7 @@ std::shared_ptr<VAO> ShapeFactory::CreateCircle(float radius, uint32_t segments)
     indices.push_back((i + 1) % segments + 1);
   }
 
-  return CreateShape(vertices, indices);
+  return CreateShape(std::move(key), vertices, indices);
 }
 
 }
\ No newline at end of file
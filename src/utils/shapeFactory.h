@@ -1,18 +1,20 @@
 #pragma once
 
-#include "render/vao.h"
+#include "render/geometryPool.h"
 
 namespace potatoengine {
 
+// identical shapes share the same geometry in the pool
 class ShapeFactory {
   public:
-    static std::shared_ptr<VAO> CreateTriangle(float size);
-    static std::shared_ptr<VAO> CreateRectangle(float width, float height, bool repeatTexture);
-    static std::shared_ptr<VAO> CreateCube(float width, float height, float depth, bool repeatTexture);
-    static std::shared_ptr<VAO> CreateCircle(float radius, uint32_t segments);
+    static std::shared_ptr<GeometryPool::Mesh> CreateTriangle(float size);
+    static std::shared_ptr<GeometryPool::Mesh> CreateRectangle(float width, float height, bool repeatTexture);
+    static std::shared_ptr<GeometryPool::Mesh> CreateCube(float width, float height, float depth, bool repeatTexture);
+    static std::shared_ptr<GeometryPool::Mesh> CreateCircle(float radius, uint32_t segments);
 
   private:
-    static std::shared_ptr<VAO> CreateShape(const std::vector<ShapeVertex>& vertices,
-                                            const std::vector<uint32_t>& indices);
+    static std::shared_ptr<GeometryPool::Mesh> Find(const std::string& key);
+    static std::shared_ptr<GeometryPool::Mesh> CreateShape(std::string&& key, const std::vector<ShapeVertex>& vertices,
+                                                           const std::vector<uint32_t>& indices);
 };
 }
\ No newline at end of file
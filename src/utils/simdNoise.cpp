@@ -0,0 +1,96 @@
+#include "utils/simdNoise.h"
+
+#if defined(__x86_64__) or defined(_M_X64) or defined(__i386__) or             \
+  defined(_M_IX86)
+#define POTATOENGINE_SIMD_X86
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+namespace potatoengine::simd {
+
+#ifdef POTATOENGINE_SIMD_X86
+namespace detail {
+// defined in simdNoiseSSE41.cpp and simdNoiseAVX2.cpp, which are the only
+// units compiled with those instruction sets enabled
+void FillNoise2DSSE41(NoiseType type, int seed, float frequency, float* out,
+                      uint32_t rows, uint32_t cols, int xOffset, int yOffset);
+void FillNoise2DAVX2(NoiseType type, int seed, float frequency, float* out,
+                     uint32_t rows, uint32_t cols, int xOffset, int yOffset);
+}
+
+namespace {
+
+Level DetectLevel() {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  int ids = info[0];
+  if (ids < 1) {
+    return Level::Scalar;
+  }
+  __cpuid(info, 1);
+  bool sse41 = info[2] & (1 << 19);
+  bool osxsave = info[2] & (1 << 27);
+  bool avx = info[2] & (1 << 28);
+  bool avx2 = false;
+  if (ids >= 7 and osxsave and avx) {
+    // the os must save the ymm registers on context switches
+    bool ymm = (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    avx2 = ymm and (info[1] & (1 << 5));
+  }
+#else
+  __builtin_cpu_init();
+  bool sse41 = __builtin_cpu_supports("sse4.1");
+  bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+  if (avx2) {
+    return Level::AVX2;
+  }
+  if (sse41) {
+    return Level::SSE41;
+  }
+  return Level::Scalar;
+}
+
+}
+
+Level GetLevel() {
+  static const Level level = DetectLevel();
+  return level;
+}
+#else
+Level GetLevel() { return Level::Scalar; }
+#endif
+
+std::string_view GetLevelName(Level level) {
+  switch (level) {
+  case Level::Scalar: return "scalar";
+  case Level::SSE41: return "sse4.1";
+  case Level::AVX2: return "avx2";
+  }
+  return "unknown";
+}
+
+bool FillNoise2D(NoiseType type, int seed, float frequency, float* out,
+                 uint32_t rows, uint32_t cols, int xOffset, int yOffset) {
+#ifdef POTATOENGINE_SIMD_X86
+  switch (GetLevel()) {
+  case Level::AVX2:
+    detail::FillNoise2DAVX2(type, seed, frequency, out, rows, cols, xOffset,
+                            yOffset);
+    return true;
+  case Level::SSE41:
+    detail::FillNoise2DSSE41(type, seed, frequency, out, rows, cols, xOffset,
+                             yOffset);
+    return true;
+  case Level::Scalar: break;
+  }
+#endif
+  return false;
+}
+
+}
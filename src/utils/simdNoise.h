@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace potatoengine::simd {
+
+enum class Level { Scalar, SSE41, AVX2 };
+
+// noise types with a vectorized kernel, the rest use FastNoiseLite directly
+enum class NoiseType { Simplex, Perlin, Value };
+
+// best instruction set supported by the cpu, detected once
+Level GetLevel();
+std::string_view GetLevelName(Level level);
+
+// fills out[row * cols + col] with the raw FastNoiseLite 2D noise at
+// (col + xOffset, row + yOffset), bit identical to FastNoiseLite::GetNoise
+// with no fractal. Returns false when the cpu has no vectorized kernel so the
+// caller can fall back to scalar sampling
+bool FillNoise2D(NoiseType type, int seed, float frequency, float* out,
+                 uint32_t rows, uint32_t cols, int xOffset, int yOffset);
+
+}
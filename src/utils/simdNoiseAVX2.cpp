@@ -0,0 +1,62 @@
+// compiled with AVX2 enabled and without the precompiled header, see
+// CMakeLists.txt
+#include "utils/simdNoiseKernel.h"
+
+#if defined(__x86_64__) or defined(_M_X64) or defined(__i386__) or             \
+  defined(_M_IX86)
+
+#include <immintrin.h>
+
+namespace potatoengine::simd::detail {
+namespace {
+
+struct AVX2 {
+    using F = __m256;
+    using I = __m256i;
+    static constexpr uint32_t Width = 8;
+
+    static F Set(float f) { return _mm256_set1_ps(f); }
+    static I SetI(int i) { return _mm256_set1_epi32(i); }
+    static I Iota() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    static void Store(float* dst, F f) { _mm256_storeu_ps(dst, f); }
+
+    static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F CmpLt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static F CmpLe(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static F CmpGt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static F Select(F mask, F a, F b) { return _mm256_blendv_ps(b, a, mask); }
+
+    static I IAdd(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I IMul(I a, I b) { return _mm256_mullo_epi32(a, b); }
+    static I IXor(I a, I b) { return _mm256_xor_si256(a, b); }
+    static I IAnd(I a, I b) { return _mm256_and_si256(a, b); }
+    static I IOr(I a, I b) { return _mm256_or_si256(a, b); }
+    template <int N> static I ISll(I a) { return _mm256_slli_epi32(a, N); }
+    template <int N> static I ISra(I a) { return _mm256_srai_epi32(a, N); }
+    static I SelectI(F mask, I a, I b) {
+      return _mm256_castps_si256(_mm256_blendv_ps(
+        _mm256_castsi256_ps(b), _mm256_castsi256_ps(a), mask));
+    }
+
+    static I MaskToI(F mask) { return _mm256_castps_si256(mask); }
+    static I Trunc(F f) { return _mm256_cvttps_epi32(f); }
+    static F ToF(I i) { return _mm256_cvtepi32_ps(i); }
+
+    static F Gather(const float* table, I idx) {
+      return _mm256_i32gather_ps(table, idx, 4);
+    }
+};
+
+}
+
+void FillNoise2DAVX2(NoiseType type, int seed, float frequency, float* out,
+                     uint32_t rows, uint32_t cols, int xOffset, int yOffset) {
+  NoiseKernel<AVX2>::Fill(type, seed, frequency, out, rows, cols, xOffset,
+                          yOffset);
+}
+
+}
+
+#endif
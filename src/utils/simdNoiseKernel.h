@@ -0,0 +1,248 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "utils/simdNoise.h"
+
+// Vectorized ports of the FastNoiseLite 2D single noise functions. Every
+// operation is done in the same order as the scalar code so results are bit
+// identical. Each instruction set translation unit includes this file with
+// its own lane traits V and the flags that enable them, see CMakeLists.txt.
+// Only template code lives here so no function is shared between units
+// compiled with different instruction sets.
+
+namespace potatoengine::simd::detail {
+
+inline constexpr std::array<float, 48> GradientsBase = {
+  0.130526192220052f, 0.99144486137381f, 0.38268343236509f,
+  0.923879532511287f, 0.608761429008721f, 0.793353340291235f,
+  0.793353340291235f, 0.608761429008721f, 0.923879532511287f,
+  0.38268343236509f, 0.99144486137381f, 0.130526192220051f,
+  0.99144486137381f, -0.130526192220051f, 0.923879532511287f,
+  -0.38268343236509f, 0.793353340291235f, -0.60876142900872f,
+  0.608761429008721f, -0.793353340291235f, 0.38268343236509f,
+  -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+  -0.130526192220052f, -0.99144486137381f, -0.38268343236509f,
+  -0.923879532511287f, -0.608761429008721f, -0.793353340291235f,
+  -0.793353340291235f, -0.608761429008721f, -0.923879532511287f,
+  -0.38268343236509f, -0.99144486137381f, -0.130526192220052f,
+  -0.99144486137381f, 0.130526192220051f, -0.923879532511287f,
+  0.38268343236509f, -0.793353340291235f, 0.608761429008721f,
+  -0.608761429008721f, 0.793353340291235f, -0.38268343236509f,
+  0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+};
+
+inline constexpr std::array<float, 16> GradientsTail = {
+  0.38268343236509f, 0.923879532511287f, 0.923879532511287f,
+  0.38268343236509f, 0.923879532511287f, -0.38268343236509f,
+  0.38268343236509f, -0.923879532511287f, -0.38268343236509f,
+  -0.923879532511287f, -0.923879532511287f, -0.38268343236509f,
+  -0.923879532511287f, 0.38268343236509f, -0.38268343236509f,
+  0.923879532511287f,
+};
+
+// FastNoiseLite::Lookup<float>::Gradients2D, the base block repeats five times
+constexpr std::array<float, 256> MakeGradients2D() {
+  std::array<float, 256> gradients{};
+  for (uint32_t i = 0; i < 240; ++i) {
+    gradients[i] = GradientsBase[i % GradientsBase.size()];
+  }
+  for (uint32_t i = 0; i < GradientsTail.size(); ++i) {
+    gradients[240 + i] = GradientsTail[i];
+  }
+  return gradients;
+}
+
+alignas(64) inline constexpr std::array<float, 256> Gradients2D =
+  MakeGradients2D();
+
+inline constexpr int PrimeX = 501125321;
+inline constexpr int PrimeY = 1136930381;
+inline constexpr int HashMultiplier = 0x27d4eb2d;
+
+// FastNoiseLite spells the constant as a double in the coordinate transform
+// and as a float in SingleSimplex, both are kept to match its rounding
+inline constexpr float F2 =
+  0.5f * ((float)1.7320508075688772935274463415059 - 1);
+inline constexpr float G2 = (3 - 1.7320508075688772935274463415059f) / 6;
+
+template <class V> struct NoiseKernel {
+    using F = typename V::F;
+    using I = typename V::I;
+
+    static I FastFloor(F f) {
+      // f >= 0 ? (int)f : (int)f - 1, the mask is -1 on negative lanes
+      return V::IAdd(V::Trunc(f), V::MaskToI(V::CmpLt(f, V::Set(0.f))));
+    }
+
+    static F Lerp(F a, F b, F t) { return V::Add(a, V::Mul(t, V::Sub(b, a))); }
+
+    static F InterpHermite(F t) {
+      return V::Mul(V::Mul(t, t), V::Sub(V::Set(3.f), V::Mul(V::Set(2.f), t)));
+    }
+
+    static F InterpQuintic(F t) {
+      F inner = V::Add(
+        V::Mul(t, V::Sub(V::Mul(t, V::Set(6.f)), V::Set(15.f))), V::Set(10.f));
+      return V::Mul(V::Mul(V::Mul(t, t), t), inner);
+    }
+
+    static I Hash(I seed, I xPrimed, I yPrimed) {
+      I hash = V::IXor(V::IXor(seed, xPrimed), yPrimed);
+      return V::IMul(hash, V::SetI(HashMultiplier));
+    }
+
+    static F ValCoord(I seed, I xPrimed, I yPrimed) {
+      I hash = Hash(seed, xPrimed, yPrimed);
+      hash = V::IMul(hash, hash);
+      hash = V::IXor(hash, V::template ISll<19>(hash));
+      return V::Mul(V::ToF(hash), V::Set(1 / 2147483648.0f));
+    }
+
+    static F GradCoord(I seed, I xPrimed, I yPrimed, F xd, F yd) {
+      I hash = Hash(seed, xPrimed, yPrimed);
+      hash = V::IXor(hash, V::template ISra<15>(hash));
+      hash = V::IAnd(hash, V::SetI(127 << 1));
+
+      F xg = V::Gather(Gradients2D.data(), hash);
+      F yg = V::Gather(Gradients2D.data(), V::IOr(hash, V::SetI(1)));
+
+      return V::Add(V::Mul(xd, xg), V::Mul(yd, yg));
+    }
+
+    static F Simplex(I seed, F x, F y) {
+      I i = FastFloor(x);
+      I j = FastFloor(y);
+      F xi = V::Sub(x, V::ToF(i));
+      F yi = V::Sub(y, V::ToF(j));
+
+      F t = V::Mul(V::Add(xi, yi), V::Set(G2));
+      F x0 = V::Sub(xi, t);
+      F y0 = V::Sub(yi, t);
+
+      i = V::IMul(i, V::SetI(PrimeX));
+      j = V::IMul(j, V::SetI(PrimeY));
+
+      F zero = V::Set(0.f);
+
+      F a = V::Sub(V::Sub(V::Set(0.5f), V::Mul(x0, x0)), V::Mul(y0, y0));
+      F n0 = V::Mul(V::Mul(V::Mul(a, a), V::Mul(a, a)),
+                    GradCoord(seed, i, j, x0, y0));
+      n0 = V::Select(V::CmpLe(a, zero), zero, n0);
+
+      F c = V::Add(
+        V::Mul(V::Set((float)(2 * (1 - 2 * G2) * (1 / G2 - 2))), t),
+        V::Add(V::Set((float)(-2 * (1 - 2 * G2) * (1 - 2 * G2))), a));
+      F x2 = V::Add(x0, V::Set(2 * (float)G2 - 1));
+      F y2 = V::Add(y0, V::Set(2 * (float)G2 - 1));
+      F n2 = V::Mul(V::Mul(V::Mul(c, c), V::Mul(c, c)),
+                    GradCoord(seed, V::IAdd(i, V::SetI(PrimeX)),
+                              V::IAdd(j, V::SetI(PrimeY)), x2, y2));
+      n2 = V::Select(V::CmpLe(c, zero), zero, n2);
+
+      F upper = V::CmpGt(y0, x0);
+      F x1 = V::Add(x0, V::Select(upper, V::Set((float)G2),
+                                  V::Set((float)G2 - 1)));
+      F y1 = V::Add(y0, V::Select(upper, V::Set((float)G2 - 1),
+                                  V::Set((float)G2)));
+      I i1 = V::SelectI(upper, i, V::IAdd(i, V::SetI(PrimeX)));
+      I j1 = V::SelectI(upper, V::IAdd(j, V::SetI(PrimeY)), j);
+      F b = V::Sub(V::Sub(V::Set(0.5f), V::Mul(x1, x1)), V::Mul(y1, y1));
+      F n1 = V::Mul(V::Mul(V::Mul(b, b), V::Mul(b, b)),
+                    GradCoord(seed, i1, j1, x1, y1));
+      n1 = V::Select(V::CmpLe(b, zero), zero, n1);
+
+      return V::Mul(V::Add(V::Add(n0, n1), n2), V::Set(99.83685446303647f));
+    }
+
+    static F Perlin(I seed, F x, F y) {
+      I x0 = FastFloor(x);
+      I y0 = FastFloor(y);
+
+      F xd0 = V::Sub(x, V::ToF(x0));
+      F yd0 = V::Sub(y, V::ToF(y0));
+      F xd1 = V::Sub(xd0, V::Set(1.f));
+      F yd1 = V::Sub(yd0, V::Set(1.f));
+
+      F xs = InterpQuintic(xd0);
+      F ys = InterpQuintic(yd0);
+
+      x0 = V::IMul(x0, V::SetI(PrimeX));
+      y0 = V::IMul(y0, V::SetI(PrimeY));
+      I x1 = V::IAdd(x0, V::SetI(PrimeX));
+      I y1 = V::IAdd(y0, V::SetI(PrimeY));
+
+      F xf0 = Lerp(GradCoord(seed, x0, y0, xd0, yd0),
+                   GradCoord(seed, x1, y0, xd1, yd0), xs);
+      F xf1 = Lerp(GradCoord(seed, x0, y1, xd0, yd1),
+                   GradCoord(seed, x1, y1, xd1, yd1), xs);
+
+      return V::Mul(Lerp(xf0, xf1, ys), V::Set(1.4247691104677813f));
+    }
+
+    static F Value(I seed, F x, F y) {
+      I x0 = FastFloor(x);
+      I y0 = FastFloor(y);
+
+      F xs = InterpHermite(V::Sub(x, V::ToF(x0)));
+      F ys = InterpHermite(V::Sub(y, V::ToF(y0)));
+
+      x0 = V::IMul(x0, V::SetI(PrimeX));
+      y0 = V::IMul(y0, V::SetI(PrimeY));
+      I x1 = V::IAdd(x0, V::SetI(PrimeX));
+      I y1 = V::IAdd(y0, V::SetI(PrimeY));
+
+      F xf0 = Lerp(ValCoord(seed, x0, y0), ValCoord(seed, x1, y0), xs);
+      F xf1 = Lerp(ValCoord(seed, x0, y1), ValCoord(seed, x1, y1), xs);
+
+      return Lerp(xf0, xf1, ys);
+    }
+
+    static F Sample(NoiseType type, I seed, F x, F y) {
+      switch (type) {
+      case NoiseType::Simplex: return Simplex(seed, x, y);
+      case NoiseType::Perlin: return Perlin(seed, x, y);
+      case NoiseType::Value: return Value(seed, x, y);
+      }
+      return V::Set(0.f);
+    }
+
+    static void Fill(NoiseType type, int seed, float frequency, float* out,
+                     uint32_t rows, uint32_t cols, int xOffset, int yOffset) {
+      I seedV = V::SetI(seed);
+      F frequencyV = V::Set(frequency);
+      alignas(32) float tail[V::Width];
+
+      for (uint32_t row = 0; row < rows; ++row) {
+        F yRow = V::Set(static_cast<float>(static_cast<int>(row) + yOffset));
+        for (uint32_t col = 0; col < cols; col += V::Width) {
+          F x = V::ToF(
+            V::IAdd(V::SetI(static_cast<int>(col) + xOffset), V::Iota()));
+          F y = yRow;
+
+          // FastNoiseLite::TransformNoiseCoordinate
+          x = V::Mul(x, frequencyV);
+          y = V::Mul(y, frequencyV);
+          if (type == NoiseType::Simplex) {
+            F t = V::Mul(V::Add(x, y), V::Set(F2));
+            x = V::Add(x, t);
+            y = V::Add(y, t);
+          }
+
+          F sample = Sample(type, seedV, x, y);
+          float* dst = out + static_cast<size_t>(row) * cols + col;
+          if (col + V::Width <= cols) {
+            V::Store(dst, sample);
+          } else {
+            V::Store(tail, sample);
+            for (uint32_t lane = 0; lane < cols - col; ++lane) {
+              dst[lane] = tail[lane];
+            }
+          }
+        }
+      }
+    }
+};
+
+}
@@ -0,0 +1,65 @@
+// compiled with SSE4.1 enabled and without the precompiled header, see
+// CMakeLists.txt
+#include "utils/simdNoiseKernel.h"
+
+#if defined(__x86_64__) or defined(_M_X64) or defined(__i386__) or             \
+  defined(_M_IX86)
+
+#include <smmintrin.h>
+
+namespace potatoengine::simd::detail {
+namespace {
+
+struct SSE41 {
+    using F = __m128;
+    using I = __m128i;
+    static constexpr uint32_t Width = 4;
+
+    static F Set(float f) { return _mm_set1_ps(f); }
+    static I SetI(int i) { return _mm_set1_epi32(i); }
+    static I Iota() { return _mm_setr_epi32(0, 1, 2, 3); }
+    static void Store(float* dst, F f) { _mm_storeu_ps(dst, f); }
+
+    static F Add(F a, F b) { return _mm_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F CmpLt(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static F CmpLe(F a, F b) { return _mm_cmple_ps(a, b); }
+    static F CmpGt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+    static F Select(F mask, F a, F b) { return _mm_blendv_ps(b, a, mask); }
+
+    static I IAdd(I a, I b) { return _mm_add_epi32(a, b); }
+    static I IMul(I a, I b) { return _mm_mullo_epi32(a, b); }
+    static I IXor(I a, I b) { return _mm_xor_si128(a, b); }
+    static I IAnd(I a, I b) { return _mm_and_si128(a, b); }
+    static I IOr(I a, I b) { return _mm_or_si128(a, b); }
+    template <int N> static I ISll(I a) { return _mm_slli_epi32(a, N); }
+    template <int N> static I ISra(I a) { return _mm_srai_epi32(a, N); }
+    static I SelectI(F mask, I a, I b) {
+      return _mm_castps_si128(
+        _mm_blendv_ps(_mm_castsi128_ps(b), _mm_castsi128_ps(a), mask));
+    }
+
+    static I MaskToI(F mask) { return _mm_castps_si128(mask); }
+    static I Trunc(F f) { return _mm_cvttps_epi32(f); }
+    static F ToF(I i) { return _mm_cvtepi32_ps(i); }
+
+    static F Gather(const float* table, I idx) {
+      alignas(16) int lanes[Width];
+      _mm_store_si128(reinterpret_cast<__m128i*>(lanes), idx);
+      return _mm_setr_ps(table[lanes[0]], table[lanes[1]], table[lanes[2]],
+                         table[lanes[3]]);
+    }
+};
+
+}
+
+void FillNoise2DSSE41(NoiseType type, int seed, float frequency, float* out,
+                      uint32_t rows, uint32_t cols, int xOffset, int yOffset) {
+  NoiseKernel<SSE41>::Fill(type, seed, frequency, out, rows, cols, xOffset,
+                           yOffset);
+}
+
+}
+
+#endif